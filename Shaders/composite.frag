@@ -0,0 +1,24 @@
+#version 450
+
+layout(location = 0) in vec2 inUv;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D scene;
+
+layout(push_constant) uniform Upscale {
+	vec2 sourceSize;
+	vec2 scale; //Window pixels per virtual pixel
+} upscale;
+
+//Sharp bilinear: texels are sampled at their center except for a one window pixel wide band
+//on their edges, where the linear filter blends with the neighbour. With an integer scale
+//the band is empty and every texel is copied exactly
+void main() {
+	vec2 texel = inUv * upscale.sourceSize;
+	vec2 center = fract(texel) - 0.5;
+	//Below a scale of one every texel is narrower than a pixel and the whole texel is band
+	vec2 range = max(0.5 - 0.5 / upscale.scale, vec2(0.0));
+	vec2 offset = (center - clamp(center, -range, range)) * upscale.scale + 0.5;
+	outColor = texture(scene, (floor(texel) + offset) / upscale.sourceSize);
+}
\ No newline at end of file
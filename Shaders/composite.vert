@@ -0,0 +1,10 @@
+#version 450
+
+layout(location = 0) out vec2 outUv;
+
+//One triangle that covers the whole viewport, the viewport is the upscaled rect
+void main() {
+	vec2 corner = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+	outUv = corner;
+}
\ No newline at end of file
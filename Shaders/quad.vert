@@ -0,0 +1,20 @@
+#version 450
+
+layout(location = 0) out vec4 outColor;
+
+layout(push_constant) uniform Quad {
+	mat4 viewProj;
+	vec4 rect; //Position in xy, size in zw
+	vec4 color;
+} quad;
+
+const vec2 CORNERS[6] = vec2[](
+	vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0),
+	vec2(1.0, 1.0), vec2(1.0, 0.0), vec2(0.0, 0.0)
+);
+
+void main() {
+	vec2 corner = CORNERS[gl_VertexIndex];
+	gl_Position = quad.viewProj * vec4(quad.rect.xy + corner * quad.rect.zw, 0.0, 1.0);
+	outColor = quad.color;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 450
+
+layout(location = 0) in vec2 inUv;
+layout(location = 1) in vec4 inTint;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D sprite;
+
+void main() {
+	outColor = texture(sprite, inUv) * inTint;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#version 450
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in vec2 inSize;
+layout(location = 2) in vec4 inRect;
+layout(location = 3) in vec4 inTint;
+
+layout(location = 0) out vec2 outUv;
+layout(location = 1) out vec4 outTint;
+
+layout(push_constant) uniform Camera {
+	mat4 viewProj;
+} camera;
+
+const vec2 CORNERS[6] = vec2[](
+	vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0),
+	vec2(1.0, 1.0), vec2(1.0, 0.0), vec2(0.0, 0.0)
+);
+
+void main() {
+	vec2 corner = CORNERS[gl_VertexIndex];
+	gl_Position = camera.viewProj * vec4(inPos + corner * inSize, 0.0, 1.0);
+	outUv = mix(inRect.xy, inRect.zw, corner);
+	outTint = inTint;
+}
\ No newline at end of file
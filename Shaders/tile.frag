@@ -0,0 +1,11 @@
+#version 450
+
+layout(location = 0) in vec2 inUv;
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D tileset;
+
+void main() {
+	outColor = texture(tileset, inUv);
+}
\ No newline at end of file
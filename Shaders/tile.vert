@@ -0,0 +1,30 @@
+#version 450
+
+layout(location = 0) in uint inPacked;
+
+layout(location = 0) out vec2 outUv;
+
+layout(push_constant) uniform Chunk {
+	mat4 viewProj;
+	vec2 origin; //Top left of the chunk in pixels
+	vec2 tileSize; //In pixels
+	vec2 uvOrigin; //Top left of the tileset in the texture
+	vec2 uvTile; //Size of one tile in uv space
+	uint columns; //Tiles per row in the tileset
+} chunk;
+
+const vec2 CORNERS[6] = vec2[](
+	vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0),
+	vec2(1.0, 1.0), vec2(1.0, 0.0), vec2(0.0, 0.0)
+);
+
+void main() {
+	vec2 corner = CORNERS[gl_VertexIndex];
+	vec2 tile = vec2(float(inPacked & 0xFFu), float((inPacked >> 8) & 0xFFu));
+	uint index = (inPacked >> 16) - 1u;
+
+	gl_Position = chunk.viewProj * vec4(chunk.origin + (tile + corner) * chunk.tileSize, 0.0, 1.0);
+
+	vec2 cell = vec2(float(index % chunk.columns), float(index / chunk.columns));
+	outUv = chunk.uvOrigin + (cell + corner) * chunk.uvTile;
+}
\ No newline at end of file
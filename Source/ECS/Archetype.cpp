@@ -0,0 +1,101 @@
+#include "Archetype.h"
+
+namespace ecs {
+
+	Archetype::Archetype(const Signature& signature) : signature(signature) {
+		columnOf.fill(-1);
+
+		usize rowSize = sizeof(Entity);
+		usize slack = 0;
+		for (ComponentId id = 0; id < MAX_COMPONENTS; id++) {
+			if (signature.test(id)) {
+				const ComponentInfo& info = GetComponentInfo(id);
+				columnOf[id] = static_cast<i32>(columns.size());
+				columns.push_back(ColumnLayout{ id, info.size, 0 });
+				rowSize += info.size;
+				slack += info.align - 1;
+			}
+		}
+
+		ASSERT(rowSize + slack <= CHUNK_SIZE, "Archetype row doesn't fit in a chunk!");
+		capacity = static_cast<u32>((CHUNK_SIZE - slack) / rowSize);
+
+		//Entity handles go first, then each column aligned for its component
+		usize offset = sizeof(Entity) * capacity;
+		for (ColumnLayout& column : columns) {
+			const usize align = GetComponentInfo(column.component).align;
+			offset = (offset + align - 1) & ~(align - 1);
+			column.offset = offset;
+			offset += column.size * capacity;
+		}
+
+		ASSERT(offset <= CHUNK_SIZE, "Archetype columns overflow the chunk!");
+	}
+
+	Archetype::~Archetype() {
+		for (Chunk& chunk : chunks) {
+			::operator delete(chunk.data, std::align_val_t{ CHUNK_ALIGN });
+		}
+	}
+
+	u32 Archetype::Push(Entity entity) {
+		if (size == chunks.size() * capacity) {
+			chunks.push_back(Chunk{ static_cast<u8*>(::operator new(CHUNK_SIZE, std::align_val_t{ CHUNK_ALIGN })), 0 });
+		}
+
+		Chunk& chunk = chunks[size / capacity];
+		Entities(chunk)[chunk.count++] = entity;
+		return size++;
+	}
+
+	Entity Archetype::Remove(u32 row) {
+		ASSERT(row < size, "Archetype row out of range!");
+
+		const u32 last = size - 1;
+		Chunk& lastChunk = chunks[last / capacity];
+		const u32 lastIndex = last % capacity;
+
+		Entity moved = NO_ENTITY;
+		if (row != last) {
+			Chunk& chunk = chunks[row / capacity];
+			const u32 index = row % capacity;
+
+			moved = Entities(lastChunk)[lastIndex];
+			Entities(chunk)[index] = moved;
+			for (i32 i = 0; i < static_cast<i32>(columns.size()); i++) {
+				std::memcpy(
+					ColumnData(chunk, i) + index * columns[i].size,
+					ColumnData(lastChunk, i) + lastIndex * columns[i].size,
+					columns[i].size);
+			}
+		}
+
+		lastChunk.count--;
+		size--;
+
+		//Keep one empty chunk around so an entity bouncing on a chunk boundary doesn't reallocate
+		if (chunks.size() > 1 && chunks[chunks.size() - 2].count == 0) {
+			::operator delete(chunks.back().data, std::align_val_t{ CHUNK_ALIGN });
+			chunks.pop_back();
+		}
+
+		return moved;
+	}
+
+	void Archetype::CopyShared(const Archetype& from, u32 fromRow, Archetype& to, u32 toRow) {
+		const Chunk& fromChunk = from.chunks[fromRow / from.capacity];
+		const u32 fromIndex = fromRow % from.capacity;
+		Chunk& toChunk = to.chunks[toRow / to.capacity];
+		const u32 toIndex = toRow % to.capacity;
+
+		for (i32 i = 0; i < static_cast<i32>(from.columns.size()); i++) {
+			const i32 column = to.columnOf[from.columns[i].component];
+			if (column >= 0) {
+				std::memcpy(
+					to.ColumnData(toChunk, column) + toIndex * to.columns[column].size,
+					from.ColumnData(fromChunk, i) + fromIndex * from.columns[i].size,
+					from.columns[i].size);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Entity.h"
+#include "Component.h"
+
+namespace ecs {
+
+	//All entities with exactly the same set of components. Rows are stored in fixed size chunks
+	//where every component gets its own tightly packed column (plus one for the entity handles),
+	//so iterating a component only ever touches memory holding that component.
+	//Rows are kept dense: every chunk but the last is full and removal swaps in the last row
+	class Archetype {
+	public:
+		static constexpr usize CHUNK_SIZE = 16 * 1024;
+		static constexpr usize CHUNK_ALIGN = 64;
+
+		struct Chunk {
+			u8* data;
+			u32 count;
+		};
+
+		Archetype(const Signature& signature);
+		~Archetype();
+
+		Archetype(const Archetype& other) = delete;
+		Archetype& operator=(const Archetype& other) = delete;
+
+		//Appends a row for the entity, the components are left uninitialized
+		u32 Push(Entity entity);
+
+		//Swaps the last row into the hole, returns the entity that moved into row (NO_ENTITY if row was the last)
+		Entity Remove(u32 row);
+
+		//Copies every component both archetypes have from one row to another
+		static void CopyShared(const Archetype& from, u32 fromRow, Archetype& to, u32 toRow);
+
+		inline b8 Has(ComponentId component) const { return signature.test(component); }
+
+		//-1 if the archetype doesn't have the component
+		inline i32 Column(ComponentId component) const { return columnOf[component]; }
+
+		inline void* Get(u32 row, ComponentId component) {
+			const i32 column = columnOf[component];
+			return column < 0 ? nullptr : ColumnData(chunks[row / capacity], column) + (row % capacity) * columns[column].size;
+		}
+
+		inline u8* ColumnData(const Chunk& chunk, i32 column) const { return chunk.data + columns[column].offset; }
+		inline Entity* Entities(const Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+		inline Entity GetEntity(u32 row) const { return Entities(chunks[row / capacity])[row % capacity]; }
+
+		inline const Signature& GetSignature() const { return signature; }
+		inline const std::vector<Chunk>& Chunks() const { return chunks; }
+		inline u32 Size() const { return size; }
+		inline u32 ChunkCapacity() const { return capacity; }
+
+		//Cached archetypes one component away, filled in by the world
+		std::array<Archetype*, MAX_COMPONENTS> addEdges{};
+		std::array<Archetype*, MAX_COMPONENTS> removeEdges{};
+
+	private:
+		struct ColumnLayout {
+			ComponentId component;
+			usize size;
+			usize offset;
+		};
+
+		Signature signature;
+		std::vector<ColumnLayout> columns;
+		std::array<i32, MAX_COMPONENTS> columnOf;
+
+		std::vector<Chunk> chunks;
+		u32 capacity; //Rows per chunk
+		u32 size = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "Commands.h"
+#include "State.h"
+
+namespace ecs {
+
+	Commands::Commands(World& world) : Commands(world, global.tickAllocator) {
+
+	}
+
+	Commands::Commands(World& world, util::BumpAllocator& allocator) : world(world), allocator(allocator) {
+
+	}
+
+	Entity Commands::Create() {
+		Entity entity = world.Reserve();
+		Record(Op::Create, entity, 0, nullptr, 0);
+		return entity;
+	}
+
+	void Commands::Destroy(Entity entity) {
+		Record(Op::Destroy, entity, 0, nullptr, 0);
+	}
+
+	void Commands::Record(Op op, Entity entity, ComponentId component, const void* data, u32 size) {
+		const usize needed = sizeof(Header) + size;
+		ASSERT(needed <= BLOCK_SIZE - sizeof(u8*), "Component too large for a command block!");
+
+		if (!last || used + needed > BLOCK_SIZE) {
+			u8* block = reinterpret_cast<u8*>(allocator.Alloc(BLOCK_SIZE));
+			u8* next = nullptr;
+			std::memcpy(block, &next, sizeof(u8*));
+
+			if (last) {
+				//A size of ~0 marks the rest of the previous block as unused
+				if (used + sizeof(Header) <= BLOCK_SIZE) {
+					Header end{};
+					end.size = ~0u;
+					std::memcpy(last + used, &end, sizeof(Header));
+				}
+				std::memcpy(last, &block, sizeof(u8*));
+			}
+			else {
+				first = block;
+			}
+
+			last = block;
+			used = sizeof(u8*);
+		}
+
+		const Header header{ op, component, entity, size };
+		std::memcpy(last + used, &header, sizeof(Header));
+		if (size > 0) {
+			std::memcpy(last + used + sizeof(Header), data, size);
+		}
+
+		used += needed;
+		numCommands++;
+	}
+
+	void Commands::Apply() {
+		u8* block = first;
+		usize offset = sizeof(u8*);
+
+		for (u32 i = 0; i < numCommands; i++) {
+			Header header;
+			if (offset + sizeof(Header) > BLOCK_SIZE) {
+				std::memcpy(&block, block, sizeof(u8*));
+				offset = sizeof(u8*);
+			}
+
+			std::memcpy(&header, block + offset, sizeof(Header));
+			if (header.size == ~0u) {
+				std::memcpy(&block, block, sizeof(u8*));
+				offset = sizeof(u8*);
+				std::memcpy(&header, block + offset, sizeof(Header));
+			}
+
+			const u8* data = block + offset + sizeof(Header);
+			offset += sizeof(Header) + header.size;
+
+			//New indices only get a record once they're placed, so creation can't check Alive first
+			if (header.op == Op::Create) {
+				world.PlaceReserved(header.entity);
+				continue;
+			}
+
+			if (!world.Alive(header.entity)) {
+				continue;
+			}
+
+			switch (header.op) {
+			case Op::Create:
+				break;
+			case Op::Destroy:
+				world.Destroy(header.entity);
+				break;
+			case Op::Add:
+				world.AddComponent(header.entity, header.component);
+				std::memcpy(world.GetComponent(header.entity, header.component), data, header.size);
+				break;
+			case Op::Remove:
+				world.RemoveComponent(header.entity, header.component);
+				break;
+			}
+		}
+
+		first = last = nullptr;
+		used = 0;
+		numCommands = 0;
+	}
+}
\ No newline at end of file
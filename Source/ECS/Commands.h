@@ -0,0 +1,76 @@
+#pragma once
+
+#include "World.h"
+#include "Util\Arena.h"
+
+namespace ecs {
+
+	//Records structural changes so they can be made while queries are iterating, then plays them
+	//back in order with Apply(). Commands are packed into blocks from a bump allocator (the tick
+	//allocator by default), so a buffer has to be applied before that allocator is cleared.
+	//Entities made with Create() get their handle right away and can be used by later commands
+	class Commands {
+	public:
+		static constexpr usize BLOCK_SIZE = 4096;
+
+		Commands(World& world);
+		Commands(World& world, util::BumpAllocator& allocator);
+
+		Commands(const Commands& other) = delete;
+		Commands& operator=(const Commands& other) = delete;
+
+		Entity Create();
+
+		template<Component... Ts>
+		Entity Create(const Ts&... components) {
+			Entity entity = Create();
+			(Add(entity, components), ...);
+			return entity;
+		}
+
+		void Destroy(Entity entity);
+
+		template<Component T>
+		void Add(Entity entity, const T& component = {}) {
+			Record(Op::Add, entity, ComponentType<T>(), &component, sizeof(T));
+		}
+
+		template<Component T>
+		void Remove(Entity entity) {
+			Record(Op::Remove, entity, ComponentType<T>(), nullptr, 0);
+		}
+
+		//Makes every recorded change and empties the buffer, commands on entities that died in the meantime are skipped
+		void Apply();
+
+		inline b8 Empty() const { return numCommands == 0; }
+		inline u32 Size() const { return numCommands; }
+
+	private:
+		enum class Op : u8 {
+			Create,
+			Destroy,
+			Add,
+			Remove
+		};
+
+		struct Header {
+			Op op;
+			ComponentId component;
+			Entity entity;
+			u32 size;
+		};
+
+		void Record(Op op, Entity entity, ComponentId component, const void* data, u32 size);
+
+		World& world;
+		util::BumpAllocator& allocator;
+
+		//Blocks start with a pointer to the next one. Commands are packed without padding and read
+		//back with memcpy, so nothing depends on the allocator's alignment
+		u8* first = nullptr;
+		u8* last = nullptr;
+		usize used = 0;
+		u32 numCommands = 0;
+	};
+}
\ No newline at end of file
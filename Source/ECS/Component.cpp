@@ -0,0 +1,21 @@
+#include "Component.h"
+
+namespace ecs {
+
+	//Fixed size so references stay valid while other threads register new types
+	static std::mutex registryMutex;
+	static std::array<ComponentInfo, MAX_COMPONENTS> registry;
+	static u32 numComponents = 0;
+
+	ComponentId RegisterComponent(const ComponentInfo& info) {
+		std::lock_guard lock{ registryMutex };
+		ASSERT(numComponents < MAX_COMPONENTS, "Too many component types!");
+
+		registry[numComponents] = info;
+		return numComponents++;
+	}
+
+	const ComponentInfo& GetComponentInfo(ComponentId id) {
+		return registry[id];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Util\Types.h"
+#include "Util\Std.h"
+
+namespace ecs {
+
+	static constexpr u32 MAX_COMPONENTS = 64;
+
+	using ComponentId = u32;
+	using Signature = std::bitset<MAX_COMPONENTS>;
+
+	struct ComponentInfo {
+		usize size;
+		usize align;
+	};
+
+	//Components are moved between chunks with memcpy and never destructed, so they have to be plain data
+	template<typename T>
+	concept Component = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T> && !std::is_reference_v<T>;
+
+	ComponentId RegisterComponent(const ComponentInfo& info);
+	const ComponentInfo& GetComponentInfo(ComponentId id);
+
+	//Ids are handed out the first time a type is used, const is ignored
+	template<Component T>
+	ComponentId ComponentType() {
+		using Type = std::remove_cv_t<T>;
+		if constexpr (!std::is_same_v<T, Type>) {
+			return ComponentType<Type>();
+		}
+		else {
+			static const ComponentId id = RegisterComponent(ComponentInfo{ sizeof(Type), alignof(Type) });
+			return id;
+		}
+	}
+
+	template<Component... Ts>
+	Signature MakeSignature() {
+		Signature signature;
+		(signature.set(ComponentType<Ts>()), ...);
+		return signature;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "ECSBenchmark.h"
+#include "Util\Time.h"
+#include "Util\Log.h"
+#include "State.h"
+
+namespace ecs {
+
+	static constexpr f32 BOUNDS = 1024.f;
+
+	//Entities never move more than one bound per tick, so no fmod
+	static inline f32 Wrap(f32 x) {
+		return x < 0.f ? x + BOUNDS : (x >= BOUNDS ? x - BOUNDS : x);
+	}
+
+	static inline vec2 Wrap(vec2 position) {
+		return vec2{ Wrap(position.x), Wrap(position.y) };
+	}
+
+	ECSBenchmark::ECSBenchmark(u32 count) {
+		entities.reserve(count);
+		objects.resize(count);
+
+		//Built through Commands (in chunks, it's backed by the tick allocator) to cover the same path as the churn
+		for (u32 spawned = 0; spawned < count;) {
+			Commands commands{ world };
+			for (u32 i = 0; i < 256 && spawned < count; i++, spawned++) {
+				Spawn(commands);
+			}
+			commands.Apply();
+			global.tickAllocator.Clear();
+		}
+
+		std::uniform_real_distribution<f32> position(0.f, BOUNDS), velocity(-1.f, 1.f);
+		for (Object& object : objects) {
+			object = Object{};
+			object.position = vec2{ position(rng), position(rng) };
+			object.velocity = vec2{ velocity(rng), velocity(rng) };
+			object.hasAnimation = true;
+		}
+
+		const f32 dt = static_cast<f32>(util::Time::DELTA_TIME / 1000.0);
+
+		//Movement, animation and regeneration touch different components so they run side by side,
+		//churn reads health while regeneration writes it so it waits for regeneration
+		scheduler.Add("Movement", [this, dt](World&, Commands&) {
+			movement.Each([dt](Position& position, const Velocity& velocity) {
+				position.value = Wrap(position.value + velocity.value * dt);
+			});
+		}).Access<Position, const Velocity>();
+
+		scheduler.Add("Animation", [this, dt](World&, Commands&) {
+			animation.Each([dt](Animation& animation) {
+				animation.timer += dt;
+				animation.frame += animation.timer > 0.1f;
+				animation.timer = animation.timer > 0.1f ? 0.f : animation.timer;
+			});
+		}).Access<Animation>();
+
+		scheduler.Add("Regeneration", [this](World&, Commands&) {
+			health.Each([](Health& health) {
+				health.current = math::Min(health.current + 1, health.max);
+			});
+		}).Access<Health>();
+
+		scheduler.Add("Churn", [this](World&, Commands& commands) {
+			Churn(commands);
+		}).Reads<Health>();
+
+		lastReport = global.time->CurrentTime();
+
+		LOGNG(util::Logger::ECS, "ECS benchmark running with $ entities in $ archetypes.",
+			world.NumEntities(), world.Archetypes().size());
+	}
+
+	void ECSBenchmark::Spawn(Commands& commands) {
+		std::uniform_real_distribution<f32> position(0.f, BOUNDS), velocity(-1.f, 1.f), unit(0.f, 1.f);
+
+		Entity entity = commands.Create(
+			Position{ vec2{ position(rng), position(rng) } },
+			Velocity{ vec2{ velocity(rng), velocity(rng) } },
+			Animation{ 0, 0.f });
+
+		if (unit(rng) < 0.5f) {
+			commands.Add(entity, Health{ 10, 10 });
+		}
+
+		entities.push_back(entity);
+	}
+
+	void ECSBenchmark::Churn(Commands& commands) {
+		//Replace a few entities and toggle health on a few more
+		std::uniform_int_distribution<usize> pick(0, entities.size() - 1);
+		for (u32 i = 0; i < CHURN_PER_TICK; i++) {
+			const usize index = pick(rng);
+			commands.Destroy(entities[index]);
+			entities[index] = entities.back();
+			entities.pop_back();
+			Spawn(commands);
+
+			const Entity other = entities[pick(rng)];
+			if (world.Has<Health>(other)) {
+				commands.Remove<Health>(other);
+			}
+			else {
+				commands.Add(other, Health{ 10, 10 });
+			}
+		}
+	}
+
+	void ECSBenchmark::Tick() {
+		const f32 dt = static_cast<f32>(util::Time::DELTA_TIME / 1000.0);
+
+		f64 start = global.time->CurrentTime();
+		scheduler.Run();
+		scheduledTime += global.time->CurrentTime() - start;
+
+		start = global.time->CurrentTime();
+		for (Object& object : objects) {
+			object.position = Wrap(object.position + object.velocity * dt);
+		}
+		for (Object& object : objects) {
+			if (object.hasAnimation) {
+				object.timer += dt;
+				object.frame += object.timer > 0.1f;
+				object.timer = object.timer > 0.1f ? 0.f : object.timer;
+			}
+		}
+		aosTime += global.time->CurrentTime() - start;
+
+		ticks++;
+
+		const f64 now = global.time->CurrentTime();
+		if (now - lastReport >= 1000.0) {
+			//The scheduler keeps per system times, movement and animation are what the array does
+			const f64 soaTime = scheduler.Timing(0).Avg() + scheduler.Timing(1).Avg();
+			const f64 toNs = 1000000.0 / world.NumEntities();
+			LOGNG(util::Logger::ECS,
+				"ECS: $ entities, $ archetypes, SoA $ns/entity, AoS $ns/entity ($x), $ms per scheduled tick",
+				world.NumEntities(), world.Archetypes().size(),
+				soaTime * toNs, aosTime / ticks * toNs,
+				soaTime > 0.0 ? aosTime / ticks / soaTime : 0.0,
+				scheduledTime / ticks);
+			scheduler.LogStats();
+
+			lastReport = now;
+			ticks = 0;
+			scheduledTime = aosTime = 0.0;
+		}
+	}
+}
\ No newline at end of file
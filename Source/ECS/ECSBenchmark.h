@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Scheduler.h"
+#include "Util\Math.h"
+
+namespace ecs {
+
+	//Stress test for the ECS, enabled with ecsBenchmark under [Debug] in the config (the number of
+	//entities). Every tick it runs movement, animation, regeneration and churn systems through a
+	//scheduler, runs the same movement and animation over a plain array of game objects holding
+	//the same data, and logs the per entity cost of both layouts and each system once a second
+	class ECSBenchmark {
+	public:
+		static constexpr u32 CHURN_PER_TICK = 64;
+
+		struct Position { vec2 value; };
+		struct Velocity { vec2 value; };
+		struct Health { i32 current, max; };
+		struct Animation { u32 frame; f32 timer; };
+
+		//The naive layout, one struct per object with everything an object could need
+		struct Object {
+			vec2 position;
+			vec2 velocity;
+			i32 health, maxHealth;
+			u32 frame;
+			f32 timer;
+			vec4 tint;
+			mat2 transform;
+			u32 flags;
+			char name[20];
+			b8 hasHealth, hasAnimation;
+		};
+
+		ECSBenchmark(u32 count);
+
+		void Tick();
+
+	private:
+		void Spawn(Commands& commands);
+		void Churn(Commands& commands);
+
+		World world;
+		Scheduler scheduler{ world };
+		Query<Position, const Velocity> movement{ world };
+		Query<Animation> animation{ world };
+		Query<Health> health{ world };
+		std::vector<Entity> entities;
+
+		std::vector<Object> objects;
+
+		std::mt19937 rng{ 1234 };
+
+		f64 lastReport;
+		u64 ticks = 0;
+		f64 scheduledTime = 0.0, aosTime = 0.0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Util\Types.h"
+#include "Util\Std.h"
+
+namespace ecs {
+
+	//Handle to an entity, the generation is bumped every time an index is reused so stale
+	//handles to destroyed entities can be detected
+	struct Entity {
+		static constexpr u32 INVALID = ~0u;
+
+		u32 index = INVALID;
+		u32 generation = 0;
+
+		inline b8 Valid() const { return index != INVALID; }
+
+		inline b8 operator==(const Entity& other) const = default;
+	};
+
+	inline constexpr Entity NO_ENTITY{};
+}
+
+template<>
+struct std::hash<ecs::Entity> {
+	usize operator()(const ecs::Entity& entity) const {
+		return std::hash<u64>{}((static_cast<u64>(entity.generation) << 32) | entity.index);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "Scheduler.h"
+#include "Util\Log.h"
+#include "State.h"
+
+namespace ecs {
+
+	Scheduler::System::System(const std::string& name, SystemFn fn)
+		: name(name), fn(std::move(fn)), time(global.time, true, this->name.c_str()) {
+
+	}
+
+	Scheduler::Scheduler(World& world) : world(world) {
+
+	}
+
+	Scheduler::SystemBuilder Scheduler::Add(const std::string& name, SystemFn fn) {
+		auto system = std::make_unique<System>(name, std::move(fn));
+		system->commands.emplace(world, system->commandMemory);
+		systems.push_back(std::move(system));
+		dirty = true;
+
+		return SystemBuilder{ *this, systems.size() - 1 };
+	}
+
+	void Scheduler::SetEnabled(const std::string& name, b8 enabled) {
+		for (auto& system : systems) {
+			if (system->name == name && system->enabled != enabled) {
+				system->enabled = enabled;
+				dirty = true;
+			}
+		}
+	}
+
+	b8 Scheduler::Conflicts(const System& a, const System& b) {
+		return a.exclusive || b.exclusive
+			|| (a.writes & (b.reads | b.writes)).any()
+			|| (b.writes & a.reads).any();
+	}
+
+	void Scheduler::Build() {
+		roots.clear();
+		for (auto& system : systems) {
+			system->successors.clear();
+			system->numDependencies = 0;
+		}
+
+		//Every conflict becomes an edge from the system added first, so the order is fixed
+		//no matter how the jobs get scheduled
+		std::vector<u32> depth(systems.size(), 1);
+		criticalPath = 0;
+		for (u32 i = 0; i < systems.size(); i++) {
+			if (!systems[i]->enabled) {
+				continue;
+			}
+
+			for (u32 j = 0; j < i; j++) {
+				if (systems[j]->enabled && Conflicts(*systems[j], *systems[i])) {
+					systems[j]->successors.push_back(i);
+					systems[i]->numDependencies++;
+					depth[i] = math::Max(depth[i], depth[j] + 1);
+				}
+			}
+
+			if (systems[i]->numDependencies == 0) {
+				roots.push_back(i);
+			}
+			criticalPath = math::Max(criticalPath, depth[i]);
+		}
+
+		dirty = false;
+	}
+
+	void Scheduler::Run() {
+		if (dirty) {
+			Build();
+		}
+
+		for (auto& system : systems) {
+			system->remaining.store(system->numDependencies, std::memory_order_relaxed);
+		}
+
+		util::JobSystem::Counter counter;
+		for (u32 root : roots) {
+			Launch(root, counter);
+		}
+		global.jobs->Wait(counter);
+
+		for (auto& system : systems) {
+			if (system->enabled) {
+				system->commands->Apply();
+				system->commandMemory.Clear();
+			}
+		}
+	}
+
+	void Scheduler::Launch(u32 index, util::JobSystem::Counter& counter) {
+		global.jobs->Run([this, index, &counter]() {
+			System& system = *systems[index];
+
+			system.time.Begin();
+			system.fn(world, *system.commands);
+			system.time.End();
+
+			//The last dependency to finish starts the successor
+			for (u32 successor : system.successors) {
+				if (systems[successor]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+					Launch(successor, counter);
+				}
+			}
+		}, &counter);
+	}
+
+	void Scheduler::LogStats() const {
+		LOGNG(util::Logger::ECS, "Scheduler: $ systems, $ run in parallel at the start, critical path of $",
+			systems.size(), roots.size(), criticalPath);
+
+		for (const auto& system : systems) {
+			LOGNG(util::Logger::ECS, "  $: $ms$", system->name, system->time.Avg(), system->enabled ? "" : " (disabled)");
+		}
+	}
+}
\ No newline at end of file
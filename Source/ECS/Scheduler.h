@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Commands.h"
+#include "Util\Time.h"
+#include "Util\JobSystem.h"
+
+namespace ecs {
+
+	//Runs a set of systems once per tick. Every system declares the components it reads and writes,
+	//two systems conflict if one writes something the other touches (or either is exclusive), and
+	//conflicting systems always run in the order they were added. From that a dependency DAG is
+	//built and systems without a path between them run concurrently on the job system.
+	//Systems only get read/write access to components, structural changes go in the system's own
+	//Commands which are applied in system order once every system is done, so a tick gives the same
+	//result however the systems were spread across workers
+	class Scheduler {
+	public:
+		using SystemFn = std::function<void(World& world, Commands& commands)>;
+
+		static constexpr usize COMMAND_MEMORY = 65536;
+
+		class SystemBuilder {
+		public:
+			template<Component... Ts>
+			SystemBuilder& Reads() {
+				scheduler.systems[index]->reads |= MakeSignature<Ts...>();
+				scheduler.dirty = true;
+				return *this;
+			}
+
+			template<Component... Ts>
+			SystemBuilder& Writes() {
+				scheduler.systems[index]->writes |= MakeSignature<Ts...>();
+				scheduler.dirty = true;
+				return *this;
+			}
+
+			//Same access as Query<Ts...>, const components are read and the rest written
+			template<Component... Ts>
+			SystemBuilder& Access() {
+				(Add<Ts>(), ...);
+				return *this;
+			}
+
+			//Conflicts with every other system, for systems that touch the world directly
+			SystemBuilder& Exclusive() {
+				scheduler.systems[index]->exclusive = true;
+				scheduler.dirty = true;
+				return *this;
+			}
+
+		private:
+			SystemBuilder(Scheduler& scheduler, usize index)
+				: scheduler(scheduler), index(index) { }
+
+			template<Component T>
+			void Add() {
+				if constexpr (std::is_const_v<T>) {
+					Reads<std::remove_const_t<T>>();
+				}
+				else {
+					Writes<T>();
+				}
+			}
+
+			Scheduler& scheduler;
+			usize index;
+
+			friend Scheduler;
+		};
+
+		Scheduler(World& world);
+
+		Scheduler(const Scheduler& other) = delete;
+		Scheduler& operator=(const Scheduler& other) = delete;
+
+		SystemBuilder Add(const std::string& name, SystemFn fn);
+
+		void SetEnabled(const std::string& name, b8 enabled);
+
+		//Runs every enabled system once and applies their commands, call from the main thread once per tick
+		void Run();
+
+		inline usize NumSystems() const { return systems.size(); }
+		inline const std::string& Name(usize system) const { return systems[system]->name; }
+		inline const util::Time::Section& Timing(usize system) const { return systems[system]->time; }
+
+		//Longest chain of dependent systems in the current DAG
+		inline u32 CriticalPath() const { return criticalPath; }
+
+		void LogStats() const;
+
+	private:
+		struct System {
+			System(const std::string& name, SystemFn fn);
+
+			std::string name;
+			SystemFn fn;
+			Signature reads, writes;
+			b8 exclusive = false;
+			b8 enabled = true;
+
+			std::vector<u32> successors;
+			u32 numDependencies = 0;
+			std::atomic<u32> remaining{ 0 };
+
+			util::BumpAllocator commandMemory{ COMMAND_MEMORY };
+			std::optional<Commands> commands;
+			util::Time::Section time;
+		};
+
+		static b8 Conflicts(const System& a, const System& b);
+
+		void Build();
+		void Launch(u32 system, util::JobSystem::Counter& counter);
+
+		World& world;
+		std::vector<std::unique_ptr<System>> systems;
+		std::vector<u32> roots;
+		u32 criticalPath = 0;
+		b8 dirty = true;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "World.h"
+
+namespace ecs {
+
+	World::World() {
+		empty = Find(Signature{});
+	}
+
+	Entity World::Create() {
+		Entity entity = Reserve();
+		Place(entity, empty);
+		return entity;
+	}
+
+	void World::Destroy(Entity entity) {
+		CheckUnlocked();
+		ASSERT(Alive(entity), "Destroying a dead entity!");
+
+		Record& record = records[entity.index];
+		if (record.archetype) {
+			Entity moved = record.archetype->Remove(record.row);
+			if (moved.Valid()) {
+				records[moved.index].row = record.row;
+			}
+		}
+
+		record.archetype = nullptr;
+		record.generation++;
+		numEntities--;
+
+		std::lock_guard lock{ reserveMutex };
+		freeIndices.push_back(entity.index);
+	}
+
+	Entity World::Reserve() {
+		std::lock_guard lock{ reserveMutex };
+		numEntities++;
+
+		if (!freeIndices.empty()) {
+			const u32 index = freeIndices.back();
+			freeIndices.pop_back();
+			return Entity{ index, records[index].generation };
+		}
+
+		return Entity{ nextIndex++, 0 };
+	}
+
+	b8 World::Alive(Entity entity) const {
+		return entity.index < records.size() && records[entity.index].generation == entity.generation;
+	}
+
+	void World::AddComponent(Entity entity, ComponentId component) {
+		CheckUnlocked();
+		ASSERT(Alive(entity), "Adding a component to a dead entity!");
+
+		Record& record = records[entity.index];
+		if (!record.archetype) {
+			Place(entity, empty);
+		}
+
+		Archetype* from = record.archetype;
+		if (from->Has(component)) {
+			return;
+		}
+
+		if (!from->addEdges[component]) {
+			Archetype* to = Find(Signature{ from->GetSignature() }.set(component));
+			from->addEdges[component] = to;
+			to->removeEdges[component] = from;
+		}
+
+		Move(entity, from->addEdges[component]);
+	}
+
+	void World::RemoveComponent(Entity entity, ComponentId component) {
+		CheckUnlocked();
+		ASSERT(Alive(entity), "Removing a component from a dead entity!");
+
+		Archetype* from = records[entity.index].archetype;
+		if (!from || !from->Has(component)) {
+			return;
+		}
+
+		if (!from->removeEdges[component]) {
+			Archetype* to = Find(Signature{ from->GetSignature() }.reset(component));
+			from->removeEdges[component] = to;
+			to->addEdges[component] = from;
+		}
+
+		Move(entity, from->removeEdges[component]);
+	}
+
+	void* World::GetComponent(Entity entity, ComponentId component) {
+		if (!Alive(entity)) {
+			return nullptr;
+		}
+
+		const Record& record = records[entity.index];
+		return record.archetype ? record.archetype->Get(record.row, component) : nullptr;
+	}
+
+	Archetype* World::Find(const Signature& signature) {
+		auto it = lookup.find(signature);
+		if (it != lookup.end()) {
+			return it->second;
+		}
+
+		archetypes.push_back(std::make_unique<Archetype>(signature));
+		lookup[signature] = archetypes.back().get();
+		return archetypes.back().get();
+	}
+
+	void World::Place(Entity entity, Archetype* archetype) {
+		CheckUnlocked();
+
+		if (entity.index >= records.size()) {
+			records.resize(entity.index + 1);
+		}
+
+		Record& record = records[entity.index];
+		record.archetype = archetype;
+		record.row = archetype->Push(entity);
+	}
+
+	void World::PlaceReserved(Entity entity) {
+		if (entity.index >= records.size() || !records[entity.index].archetype) {
+			Place(entity, empty);
+		}
+	}
+
+	void World::Move(Entity entity, Archetype* archetype) {
+		Record& record = records[entity.index];
+		Archetype* from = record.archetype;
+		const u32 fromRow = record.row;
+
+		const u32 row = archetype->Push(entity);
+		Archetype::CopyShared(*from, fromRow, *archetype, row);
+
+		Entity moved = from->Remove(fromRow);
+		if (moved.Valid()) {
+			records[moved.index].row = fromRow;
+		}
+
+		record.archetype = archetype;
+		record.row = row;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Archetype.h"
+
+namespace ecs {
+
+	template<Component... Ts>
+	class Query;
+
+	//Owns every entity and archetype. Structural changes (creating, destroying, adding or removing
+	//components) move rows between archetypes, so they aren't allowed while a query is iterating,
+	//queue them in Commands instead
+	class World {
+	public:
+		World();
+
+		World(const World& other) = delete;
+		World& operator=(const World& other) = delete;
+
+		Entity Create();
+
+		template<Component... Ts>
+		Entity Create(const Ts&... components) {
+			Entity entity = Reserve();
+			Place(entity, Find(MakeSignature<Ts...>()));
+			(Write(entity, components), ...);
+			return entity;
+		}
+
+		void Destroy(Entity entity);
+
+		//Hands out a handle without placing the entity in an archetype, used to create entities from Commands.
+		//Unlike everything else here it can be called from systems running in parallel
+		Entity Reserve();
+
+		b8 Alive(Entity entity) const;
+
+		//Overwrites the component if the entity already has it
+		template<Component T>
+		void Add(Entity entity, const T& component = {}) {
+			AddComponent(entity, ComponentType<T>());
+			Write(entity, component);
+		}
+
+		template<Component T>
+		void Remove(Entity entity) {
+			RemoveComponent(entity, ComponentType<T>());
+		}
+
+		//nullptr if the entity doesn't have the component, only valid until the next structural change
+		template<Component T>
+		T* Get(Entity entity) {
+			return static_cast<T*>(GetComponent(entity, ComponentType<T>()));
+		}
+
+		template<Component T>
+		b8 Has(Entity entity) const {
+			return Alive(entity) && records[entity.index].archetype && records[entity.index].archetype->Has(ComponentType<T>());
+		}
+
+		//Raw versions used by Commands
+		void AddComponent(Entity entity, ComponentId component);
+		void RemoveComponent(Entity entity, ComponentId component);
+		void* GetComponent(Entity entity, ComponentId component);
+
+		inline u32 NumEntities() const { return numEntities.load(std::memory_order_relaxed); }
+		inline const std::vector<std::unique_ptr<Archetype>>& Archetypes() const { return archetypes; }
+
+	private:
+		struct Record {
+			Archetype* archetype = nullptr; //nullptr while reserved
+			u32 row = 0;
+			u32 generation = 0;
+		};
+
+		Archetype* Find(const Signature& signature);
+		void Place(Entity entity, Archetype* archetype);
+		void Move(Entity entity, Archetype* archetype);
+
+		//Puts an entity from Reserve() in the empty archetype unless something already placed it
+		void PlaceReserved(Entity entity);
+
+		template<Component T>
+		void Write(Entity entity, const T& component) {
+			std::memcpy(GetComponent(entity, ComponentType<T>()), &component, sizeof(T));
+		}
+
+		inline void CheckUnlocked() const {
+			ASSERT(iterating.load(std::memory_order_relaxed) == 0, "Structural change while iterating, use Commands instead!");
+		}
+
+		std::vector<Record> records;
+		std::vector<u32> freeIndices;
+		std::mutex reserveMutex;
+		u32 nextIndex = 0; //Records are only grown when a reserved entity is placed
+		std::atomic<u32> numEntities{ 0 };
+
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		std::unordered_map<Signature, Archetype*> lookup;
+		Archetype* empty;
+
+		std::atomic<u32> iterating{ 0 }; //Queries can iterate from several systems at once
+
+		template<Component... Ts>
+		friend class Query;
+		friend class Commands;
+	};
+
+	//Matches every archetype that has all of Ts. Matching archetypes are cached and only new
+	//archetypes are checked on the next iteration, so a query is meant to be kept around.
+	//Each() compiles down to one tight loop per chunk over the column pointers
+	template<Component... Ts>
+	class Query {
+	public:
+		Query(World& world) : world(world), signature(MakeSignature<Ts...>()) {
+			ids = { ComponentType<Ts>()... };
+		}
+
+		//f(Ts&...) or f(Entity, Ts&...) for every matching entity
+		template<typename F>
+		void Each(F&& f) {
+			EachChunk([&f](u32 count, const Entity* entities, Ts*... columns) {
+				for (u32 i = 0; i < count; i++) {
+					if constexpr (std::is_invocable_v<F&, Entity, Ts&...>) {
+						f(entities[i], columns[i]...);
+					}
+					else {
+						f(columns[i]...);
+					}
+				}
+			});
+		}
+
+		//f(u32 count, const Entity* entities, Ts*... columns) once per non empty chunk
+		template<typename F>
+		void EachChunk(F&& f) {
+			Update();
+
+			world.iterating++;
+			for (Archetype* archetype : matches) {
+				std::array<i32, sizeof...(Ts)> columns;
+				for (usize i = 0; i < sizeof...(Ts); i++) {
+					columns[i] = archetype->Column(ids[i]);
+				}
+
+				for (const Archetype::Chunk& chunk : archetype->Chunks()) {
+					if (chunk.count > 0) {
+						Call(f, *archetype, chunk, columns, std::index_sequence_for<Ts...>{});
+					}
+				}
+			}
+			world.iterating--;
+		}
+
+		u32 Count() {
+			Update();
+
+			u32 count = 0;
+			for (Archetype* archetype : matches) {
+				count += archetype->Size();
+			}
+			return count;
+		}
+
+	private:
+		void Update() {
+			const auto& archetypes = world.Archetypes();
+			for (; checked < archetypes.size(); checked++) {
+				if ((archetypes[checked]->GetSignature() & signature) == signature) {
+					matches.push_back(archetypes[checked].get());
+				}
+			}
+		}
+
+		template<typename F, std::size_t... I>
+		static void Call(F& f, const Archetype& archetype, const Archetype::Chunk& chunk, const std::array<i32, sizeof...(Ts)>& columns, std::index_sequence<I...>) {
+			f(chunk.count, archetype.Entities(chunk), reinterpret_cast<Ts*>(archetype.ColumnData(chunk, columns[I]))...);
+		}
+
+		World& world;
+		Signature signature;
+		std::array<ComponentId, sizeof...(Ts)> ids;
+
+		std::vector<Archetype*> matches;
+		usize checked = 0;
+	};
+}
\ No newline at end of file
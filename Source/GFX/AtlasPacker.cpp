@@ -0,0 +1,106 @@
+#include "AtlasPacker.h"
+
+namespace gfx {
+
+	AtlasPacker::AtlasPacker(uvec2 size) : size(size) {
+		Reset();
+	}
+
+	AtlasPacker::AtlasPacker(uvec2 size, std::vector<Segment> skyline, u64 usedArea)
+		: size(size), skyline(std::move(skyline)), usedArea(usedArea) { }
+
+	void AtlasPacker::Reset() {
+		skyline.clear();
+		skyline.push_back(Segment{ 0, 0, size.x });
+		usedArea = 0;
+	}
+
+	std::optional<u32> AtlasPacker::Fit(usize index, uvec2 rect) const {
+		const u32 x = skyline[index].x;
+		if (x + rect.x > size.x) {
+			return std::nullopt;
+		}
+
+		u32 y = 0;
+		i64 widthLeft = rect.x;
+		while (widthLeft > 0) {
+			y = math::Max(y, skyline[index].y);
+			if (y + rect.y > size.y) {
+				return std::nullopt;
+			}
+
+			widthLeft -= skyline[index].width;
+			index++;
+		}
+
+		return y;
+	}
+
+	std::optional<uvec2> AtlasPacker::Pack(uvec2 rect) {
+		if (rect.x == 0 || rect.y == 0) {
+			return uvec2{ 0, 0 };
+		}
+
+		usize best = skyline.size();
+		u32 bestBottom = std::numeric_limits<u32>::max();
+		u32 bestWidth = std::numeric_limits<u32>::max();
+		u32 bestY = 0;
+
+		//Lowest bottom edge wins, ties go to the narrowest segment to leave wide gaps open
+		for (usize i = 0; i < skyline.size(); i++) {
+			auto y = Fit(i, rect);
+			if (!y) {
+				continue;
+			}
+
+			const u32 bottom = *y + rect.y;
+			if (bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth)) {
+				best = i;
+				bestBottom = bottom;
+				bestWidth = skyline[i].width;
+				bestY = *y;
+			}
+		}
+
+		if (best == skyline.size()) {
+			return std::nullopt;
+		}
+
+		const uvec2 pos{ skyline[best].x, bestY };
+		skyline.insert(skyline.begin() + best, Segment{ pos.x, bestBottom, rect.x });
+
+		//Cut away the segments now covered by the new one
+		for (usize i = best + 1; i < skyline.size();) {
+			const Segment& prev = skyline[i - 1];
+			Segment& segment = skyline[i];
+
+			if (segment.x >= prev.x + prev.width) {
+				break;
+			}
+
+			const u32 shrink = prev.x + prev.width - segment.x;
+			if (segment.width <= shrink) {
+				skyline.erase(skyline.begin() + i);
+				continue;
+			}
+
+			segment.x += shrink;
+			segment.width -= shrink;
+			break;
+		}
+
+		//Merge neighbours at the same height
+		for (usize i = 0; i + 1 < skyline.size();) {
+			if (skyline[i].y == skyline[i + 1].y) {
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else {
+				i++;
+			}
+		}
+
+		usedArea += static_cast<u64>(rect.x) * rect.y;
+		return pos;
+	}
+}
\ No newline at end of file
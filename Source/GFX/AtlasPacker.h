@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Util\Types.h"
+#include "Util\Std.h"
+#include "Util\Math.h"
+
+namespace gfx {
+
+	//Skyline bottom-left rectangle packer. Only the top edge of the packed area is tracked,
+	//so space below an overhang is lost, but inserts are cheap enough to run incrementally
+	class AtlasPacker {
+	public:
+		struct Segment {
+			u32 x, y, width;
+		};
+
+		AtlasPacker(uvec2 size);
+		AtlasPacker(uvec2 size, std::vector<Segment> skyline, u64 usedArea);
+
+		//Returns the top left corner of the placed rectangle, or nothing if it doesn't fit
+		std::optional<uvec2> Pack(uvec2 rect);
+
+		void Reset();
+
+		inline uvec2 Size() const { return size; }
+		inline const std::vector<Segment>& Skyline() const { return skyline; }
+		inline u64 UsedArea() const { return usedArea; }
+		inline f32 Occupancy() const { return static_cast<f32>(usedArea) / (static_cast<f32>(size.x) * size.y); }
+
+	private:
+		//Lowest y the rectangle can sit at when its left edge is at segment index
+		std::optional<u32> Fit(usize index, uvec2 rect) const;
+
+		uvec2 size;
+		std::vector<Segment> skyline;
+		u64 usedArea = 0;
+	};
+}
\ No newline at end of file
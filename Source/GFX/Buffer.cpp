@@ -26,7 +26,7 @@ namespace gfx {
 				memProps,
 				families,
 				buffer,
-				memory
+				allocation
 			), "Failed to create buffer!"
 		);
 	}
@@ -45,7 +45,7 @@ namespace gfx {
 				memProps,
 				families,
 				buffer,
-				memory
+				allocation
 			), "Failed to create buffer!"
 		);
 
@@ -54,8 +54,7 @@ namespace gfx {
 
 	Buffer& Buffer::operator=(const Buffer& other) {
 		if (buffer) {
-			vkFreeMemory(*global.platform->device, memory, nullptr);
-			vkDestroyBuffer(*global.platform->device, buffer, nullptr);
+			global.platform->device->DestroyBuffer(buffer, allocation);
 		}
 
 		instanceSize = other.instanceSize;
@@ -71,7 +70,7 @@ namespace gfx {
 				memProps,
 				families,
 				buffer,
-				memory
+				allocation
 			), "Failed to create buffer!"
 		);
 
@@ -82,24 +81,23 @@ namespace gfx {
 
 	Buffer::Buffer(Buffer&& other) noexcept
 		: buffer(other.buffer),
-		memory(other.memory),
+		allocation(other.allocation),
 		bufferSize(other.bufferSize),
 		instanceSize(other.instanceSize),
 		usage(other.usage),
 		memProps(other.memProps),
 		families(other.families) {
 		other.buffer = VK_NULL_HANDLE;
-		other.memory = VK_NULL_HANDLE;
+		other.allocation = platform::Allocation{};
 	}
 
 	Buffer& Buffer::operator=(Buffer&& other) noexcept {
 		if (buffer) {
-			vkFreeMemory(*global.platform->device, memory, nullptr);
-			vkDestroyBuffer(*global.platform->device, buffer, nullptr);
+			global.platform->device->DestroyBuffer(buffer, allocation);
 		}
 
 		buffer = other.buffer;
-		memory = other.memory;
+		allocation = other.allocation;
 		bufferSize = other.bufferSize;
 		instanceSize = other.instanceSize;
 		usage = other.usage;
@@ -107,15 +105,14 @@ namespace gfx {
 		families = other.families;
 
 		other.buffer = VK_NULL_HANDLE;
-		other.memory = VK_NULL_HANDLE;
+		other.allocation = platform::Allocation{};
 
 		return *this;
 	}
 
 	Buffer::~Buffer() {
 		if (buffer) {
-			vkFreeMemory(*global.platform->device, memory, nullptr);
-			vkDestroyBuffer(*global.platform->device, buffer, nullptr);
+			global.platform->device->DestroyBuffer(buffer, allocation);
 		}
 	}
 
@@ -127,15 +124,17 @@ namespace gfx {
 		return info;
 	}
 
+	//Host visible memory is persistently mapped by the allocator, so this just hands out the pointer
 	void* Buffer::Map(VkDeviceSize size, VkDeviceSize offset) {
-		VULKAN_CHECK(vkMapMemory(*global.platform->device, memory, offset, size, 0, &mapped),
-			"Failed to map buffer memory!");
+		ASSERT(allocation.mapped, "Cannot map buffer that isn't host visible!");
+		mapped = reinterpret_cast<u8*>(allocation.mapped) + offset;
 		isMapped = true;
 		return mapped;
 	}
 
 	void Buffer::UnMap() {
-		vkUnmapMemory(*global.platform->device, memory);
+		mapped = nullptr;
+		isMapped = false;
 	}
 
 	void Buffer::Write(const void* data, VkDeviceSize size, VkDeviceSize offset) {
@@ -156,12 +155,7 @@ namespace gfx {
 	}
 
 	VkResult Buffer::Flush(VkDeviceSize size, VkDeviceSize offset) {
-		VkMappedMemoryRange range{};
-		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		range.memory = memory;
-		range.offset = offset;
-		range.size = size;
-
+		VkMappedMemoryRange range = global.platform->device->Allocator().MappedRange(allocation, size, offset);
 		return vkFlushMappedMemoryRanges(*global.platform->device, 1, &range);
 	}
 
@@ -170,12 +164,7 @@ namespace gfx {
 	}
 
 	VkResult Buffer::Invalidate(VkDeviceSize size, VkDeviceSize offset) {
-		VkMappedMemoryRange range{};
-		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		range.memory = memory;
-		range.offset = offset;
-		range.size = size;
-
+		VkMappedMemoryRange range = global.platform->device->Allocator().MappedRange(allocation, size, offset);
 		return vkInvalidateMappedMemoryRanges(*global.platform->device, 1, &range);
 	}
 
@@ -29,6 +29,7 @@ namespace gfx {
 		inline VkDeviceSize InstanceCount() const { return bufferSize / instanceSize; }
 		inline b8 IsMapped() const { return isMapped; }
 		inline void* GetMappedMemory() const { return mapped; }
+		inline uint32_t QueueFamilies() const { return families; }
 
 		VkDescriptorBufferInfo DescriptorInfo() const;
 
@@ -46,7 +47,7 @@ namespace gfx {
 
 	private:
 		VkBuffer buffer;
-		VkDeviceMemory memory;
+		platform::Allocation allocation;
 		VkDeviceSize instanceSize, bufferSize;
 
 		void* mapped;
@@ -0,0 +1,102 @@
+#include "CommandPools.h"
+#include "Platform\Platform.h"
+#include "Util\JobSystem.h"
+#include "State.h"
+
+namespace gfx {
+
+	CommandPools::CommandPools(u32 numWorkers) : numWorkers(numWorkers) {
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = global.platform->device->GetQueueFamilyIndices().graphicsFamily.value();
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+		pools.resize(static_cast<usize>(numWorkers) * vk::MAX_FRAMES_IN_FLIGHT);
+		for (auto& pool : pools) {
+			VULKAN_CHECK(vkCreateCommandPool(*global.platform->device, &poolInfo, nullptr, &pool.pool),
+				"Failed to create worker command pool!");
+		}
+	}
+
+	CommandPools::~CommandPools() {
+		//Destroying a pool frees its buffers
+		for (auto& pool : pools) {
+			vkDestroyCommandPool(*global.platform->device, pool.pool, nullptr);
+		}
+	}
+
+	void CommandPools::BeginFrame(uint32_t newFrameIndex) {
+		frameIndex = newFrameIndex;
+
+		for (u32 i = 0; i < numWorkers; i++) {
+			Pool& pool = pools[static_cast<usize>(frameIndex) * numWorkers + i];
+			if (pool.usedPrimaries == 0 && pool.usedSecondaries == 0) {
+				continue;
+			}
+
+			VULKAN_CHECK(vkResetCommandPool(*global.platform->device, pool.pool, 0),
+				"Failed to reset worker command pool!");
+			pool.usedPrimaries = 0;
+			pool.usedSecondaries = 0;
+		}
+	}
+
+	VkCommandBuffer CommandPools::Primary() {
+		return Next(Current(), VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+	}
+
+	VkCommandBuffer CommandPools::BeginSecondary(const RenderPass& pass, uint32_t imageIndex, uint32_t subpass) {
+		VkCommandBuffer commandBuffer = Next(Current(), VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+		VkCommandBufferInheritanceInfo inheritance{};
+		inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritance.renderPass = pass.GetRenderPass();
+		inheritance.subpass = subpass;
+		inheritance.framebuffer = pass.GetFramebuffer(imageIndex);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = &inheritance;
+
+		VULKAN_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo),
+			"Failed to begin secondary command buffer!");
+
+		//Dynamic state isn't inherited from the primary
+		pass.SetViewport(commandBuffer);
+
+		return commandBuffer;
+	}
+
+	void CommandPools::EndSecondary(VkCommandBuffer commandBuffer) {
+		VULKAN_CHECK(vkEndCommandBuffer(commandBuffer),
+			"Failed to end secondary command buffer!");
+	}
+
+	CommandPools::Pool& CommandPools::Current() {
+		const u32 worker = util::JobSystem::WorkerIndex();
+		ASSERT(worker < numWorkers, "Command buffers can only be recorded on job workers!");
+
+		return pools[static_cast<usize>(frameIndex) * numWorkers + worker];
+	}
+
+	VkCommandBuffer CommandPools::Next(Pool& pool, VkCommandBufferLevel level) {
+		auto& buffers = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? pool.primaries : pool.secondaries;
+		u32& used = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? pool.usedPrimaries : pool.usedSecondaries;
+
+		if (used == buffers.size()) {
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = pool.pool;
+			allocInfo.level = level;
+			allocInfo.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			VULKAN_CHECK(vkAllocateCommandBuffers(*global.platform->device, &allocInfo, &commandBuffer),
+				"Failed to allocate worker command buffer!");
+			buffers.push_back(commandBuffer);
+		}
+
+		return buffers[used++];
+	}
+}
\ No newline at end of file
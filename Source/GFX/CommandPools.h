@@ -0,0 +1,44 @@
+#pragma once
+
+#include "RenderPass.h"
+
+namespace gfx {
+
+	//One transient command pool per job worker and frame in flight, so every worker can record
+	//without locking. A frame's pools are reset as a whole once its fence has been waited on,
+	//which recycles all of its command buffers at once instead of resetting them one by one
+	class CommandPools {
+	public:
+		CommandPools(u32 numWorkers);
+		~CommandPools();
+
+		CommandPools(const CommandPools& other) = delete;
+		CommandPools& operator=(const CommandPools& other) = delete;
+
+		//The frame's previous submission has to be finished
+		void BeginFrame(uint32_t frameIndex);
+
+		//From the calling worker's pool, not begun
+		VkCommandBuffer Primary();
+
+		//From the calling worker's pool, begun to continue pass with the viewport and scissor set to cover it
+		VkCommandBuffer BeginSecondary(const RenderPass& pass, uint32_t imageIndex, uint32_t subpass = 0);
+		void EndSecondary(VkCommandBuffer commandBuffer);
+
+		inline u32 NumWorkers() const { return numWorkers; }
+
+	private:
+		struct Pool {
+			VkCommandPool pool = VK_NULL_HANDLE;
+			std::vector<VkCommandBuffer> primaries, secondaries;
+			u32 usedPrimaries = 0, usedSecondaries = 0;
+		};
+
+		Pool& Current();
+		static VkCommandBuffer Next(Pool& pool, VkCommandBufferLevel level);
+
+		u32 numWorkers;
+		uint32_t frameIndex = 0;
+		std::vector<Pool> pools; //Frame major
+	};
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "GpuProfiler.h"
+#include "Platform\Platform.h"
+#include "Util\Profiler.h"
+#include "State.h"
+
+namespace gfx {
+
+	GpuProfiler::GpuProfiler() {
+		const platform::Device& device = *global.platform->device;
+		period = static_cast<f64>(device.Properties().limits.timestampPeriod);
+
+		uint32_t count = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(device.PhysicalDevice(), &count, nullptr);
+		std::vector<VkQueueFamilyProperties> families(count);
+		vkGetPhysicalDeviceQueueFamilyProperties(device.PhysicalDevice(), &count, families.data());
+
+		const uint32_t validBits = families[device.GetQueueFamilyIndices().graphicsFamily.value()].timestampValidBits;
+		if (validBits == 0 || period <= 0.0) {
+			WARNNG(util::Logger::GFX, "The graphics queue doesn't support timestamps, GPU zones are off.");
+			return;
+		}
+		timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		VkQueryPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		poolInfo.queryCount = MAX_ZONES * 2;
+
+		for (auto& frame : frames) {
+			VULKAN_CHECK(vkCreateQueryPool(device, &poolInfo, nullptr, &frame.pool),
+				"Failed to create timestamp query pool!");
+		}
+
+		results.reserve(MAX_ZONES);
+		timestamps.resize(MAX_ZONES * 2);
+
+		if (global.profiler) {
+			track = global.profiler->AddTrack("GPU");
+		}
+
+		Calibrate();
+	}
+
+	GpuProfiler::~GpuProfiler() {
+		for (auto& frame : frames) {
+			if (frame.pool != VK_NULL_HANDLE) {
+				vkDestroyQueryPool(*global.platform->device, frame.pool, nullptr);
+			}
+		}
+	}
+
+	void GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+		current = &frames[frameIndex];
+		frameZone = NONE;
+		if (!Supported()) {
+			return;
+		}
+
+		if (current->pending) {
+			Resolve(*current);
+		}
+
+		vkCmdResetQueryPool(commandBuffer, current->pool, 0, MAX_ZONES * 2);
+		current->used.store(0, std::memory_order_relaxed);
+		current->pending = true;
+
+		frameZone = Begin(commandBuffer, "GPU Frame");
+	}
+
+	void GpuProfiler::EndFrame(VkCommandBuffer commandBuffer) {
+		End(commandBuffer, frameZone);
+		frameZone = NONE;
+	}
+
+	u32 GpuProfiler::Begin(VkCommandBuffer commandBuffer, const char* name) {
+		if (!Supported() || !current) {
+			return NONE;
+		}
+
+		const u32 zone = current->used.fetch_add(1, std::memory_order_relaxed);
+		if (zone >= MAX_ZONES) {
+			return NONE;
+		}
+
+		current->names[zone] = name;
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, current->pool, zone * 2);
+		return zone;
+	}
+
+	void GpuProfiler::End(VkCommandBuffer commandBuffer, u32 zone) {
+		if (zone == NONE || !Supported() || !current) {
+			return;
+		}
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, current->pool, zone * 2 + 1);
+	}
+
+	void GpuProfiler::Calibrate() {
+		if (!Supported() || !global.profiler) {
+			return;
+		}
+
+		const platform::Device& device = *global.platform->device;
+
+		//Borrows the first frame's pool, whatever it held is lost
+		Frame& frame = frames[0];
+		frame.pending = false;
+
+		VkCommandBuffer commandBuffer = device.BeginSingleTime();
+		vkCmdResetQueryPool(commandBuffer, frame.pool, 0, 1);
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.pool, 0);
+
+		//The timestamp lands somewhere between the submit and the wait returning, the middle is the best guess
+		const u64 before = global.profiler->Now();
+		device.EndSingleTime(commandBuffer);
+		const u64 after = global.profiler->Now();
+
+		u64 timestamp = 0;
+		VULKAN_CHECK(vkGetQueryPoolResults(device, frame.pool, 0, 1, sizeof(u64), &timestamp, sizeof(u64),
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT),
+			"Failed to read the calibration timestamp!");
+
+		const f64 gpuNs = static_cast<f64>(timestamp & timestampMask) * period;
+		offset = static_cast<i64>(before + (after - before) / 2) - static_cast<i64>(gpuNs);
+	}
+
+	void GpuProfiler::Resolve(Frame& frame) {
+		frame.pending = false;
+		const u32 used = math::Min(frame.used.load(std::memory_order_relaxed), MAX_ZONES);
+		if (used == 0) {
+			return;
+		}
+
+		const VkResult result = vkGetQueryPoolResults(*global.platform->device, frame.pool, 0, used * 2,
+			used * 2 * sizeof(u64), timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+		if (result != VK_SUCCESS) {
+			return;
+		}
+
+		//Differences are taken before scaling, so a wrap past timestampValidBits only costs the one zone
+		const u64 frameStart = timestamps[0] & timestampMask;
+		results.clear();
+		for (u32 zone = 0; zone < used; zone++) {
+			const u64 begin = (timestamps[zone * 2] - frameStart) & timestampMask;
+			const u64 end = (timestamps[zone * 2 + 1] - frameStart) & timestampMask;
+			results.push_back(Result{
+				frame.names[zone],
+				static_cast<f64>(begin) * period / 1000000.0,
+				static_cast<f64>(end - begin) * period / 1000000.0
+			});
+		}
+
+		global.time->gpu.Add(results[0].time);
+
+		//A name can show up more than once a frame, its averages are per frame so the occurrences are summed first
+		std::vector<std::pair<const char*, f64>> totals;
+		for (const Result& zone : results) {
+			auto it = std::find_if(totals.begin(), totals.end(), [&zone](const auto& total) {
+				return total.first == zone.name || std::strcmp(total.first, zone.name) == 0;
+			});
+			if (it == totals.end()) {
+				totals.emplace_back(zone.name, zone.time);
+			}
+			else {
+				it->second += zone.time;
+			}
+		}
+		for (const auto& [name, time] : totals) {
+			ZoneSection(name).Add(time);
+		}
+
+		if (track != NONE && global.profiler) {
+			//Zones are recorded in parallel, sorting by start puts parents before their children
+			std::sort(results.begin() + 1, results.end(), [](const Result& a, const Result& b) { return a.start < b.start; });
+
+			const f64 base = static_cast<f64>(frameStart) * period + static_cast<f64>(offset);
+			std::array<f64, MAX_ZONES> open;
+			u32 depth = 0;
+			for (const Result& zone : results) {
+				const f64 start = base + zone.start * 1000000.0;
+				const f64 end = start + zone.time * 1000000.0;
+				while (depth > 0 && open[depth - 1] <= start) {
+					depth--;
+				}
+
+				global.profiler->Record(track, util::Profiler::Event{
+					zone.name, static_cast<u64>(math::Max(start, 0.0)), static_cast<u64>(math::Max(end, 0.0)), depth });
+				open[depth++] = end;
+			}
+		}
+	}
+
+	util::Time::Section& GpuProfiler::ZoneSection(const char* name) {
+		for (auto& zone : zoneTimes) {
+			if (zone.name == name || std::strcmp(zone.name, name) == 0) {
+				return zone.time;
+			}
+		}
+
+		return zoneTimes.emplace_back(ZoneTime{ name, util::Time::Section(global.time) }).time;
+	}
+
+	void GpuProfiler::LogStats() const {
+		if (!Supported() || global.time->gpu.Count() == 0) {
+			return;
+		}
+
+		//The CPU side of a frame without the wait for the swapchain image, which is where a GPU bound frame stalls
+		const f64 gpu = global.time->gpu.Avg();
+		const f64 cpu = global.time->update.Avg() + global.time->prepare.Avg() + global.time->render.Avg();
+		LOGNG(util::Logger::GFX, "GPU $ms, CPU $ms a frame, $ bound.", gpu, cpu, gpu > cpu ? "GPU" : "CPU");
+
+		for (const auto& zone : zoneTimes) {
+			LOGNG(util::Logger::GFX, "  $: $ms", zone.name, zone.time.Avg());
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Platform\Device.h"
+#include "Util\Time.h"
+
+namespace gfx {
+
+	//Timestamp queries around GPU work with one query pool per frame in flight. A frame's timestamps are read
+	//back the next time its slot begins, after its fence was waited on, so results are MAX_FRAMES_IN_FLIGHT
+	//frames old. Resolved zones go to the CPU profiler on a GPU track and into rolling averages like Time::Section
+	class GpuProfiler {
+	public:
+		static constexpr u32 MAX_ZONES = 64; //Per frame, including the whole frame
+		static constexpr u32 NONE = ~0u;
+
+		struct Result {
+			const char* name;
+			f64 start, time; //In ms, start from the beginning of the frame
+		};
+
+		//Scoped zone, zones can be opened from secondary command buffers on any worker
+		class Zone {
+		public:
+			Zone(GpuProfiler& profiler, VkCommandBuffer commandBuffer, const char* name)
+				: profiler(profiler), commandBuffer(commandBuffer), index(profiler.Begin(commandBuffer, name)) { }
+
+			~Zone() {
+				profiler.End(commandBuffer, index);
+			}
+
+			Zone(const Zone& other) = delete;
+			Zone& operator=(const Zone& other) = delete;
+
+		private:
+			GpuProfiler& profiler;
+			VkCommandBuffer commandBuffer;
+			u32 index;
+		};
+
+		GpuProfiler();
+		~GpuProfiler();
+
+		GpuProfiler(const GpuProfiler& other) = delete;
+		GpuProfiler& operator=(const GpuProfiler& other) = delete;
+
+		//Outside a render pass at the start of the frame's primary buffer, the frame's fence has to be waited on
+		void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+		//Before the primary buffer ends
+		void EndFrame(VkCommandBuffer commandBuffer);
+
+		//NONE when the frame is out of zones or timestamps aren't supported, End() ignores it
+		u32 Begin(VkCommandBuffer commandBuffer, const char* name);
+		void End(VkCommandBuffer commandBuffer, u32 zone);
+
+		//Lines the GPU clock up with the CPU profiler's, the device has to be idle. The clocks drift apart
+		//slowly, this runs on creation and whenever the swapchain is recreated
+		void Calibrate();
+
+		inline b8 Supported() const { return timestampMask != 0; }
+
+		//Zones of the last frame that was read back, the whole frame first
+		inline std::span<const Result> LastResults() const { return results; }
+
+		//Rolling GPU frame time next to the CPU one, and whether frames are waiting on the GPU
+		void LogStats() const;
+
+	private:
+		struct Frame {
+			VkQueryPool pool = VK_NULL_HANDLE;
+			std::array<const char*, MAX_ZONES> names;
+			std::atomic<u32> used{ 0 }; //Zones begun, each takes two queries
+			b8 pending = false; //Submitted and not read back yet
+		};
+
+		struct ZoneTime {
+			const char* name;
+			util::Time::Section time;
+		};
+
+		void Resolve(Frame& frame);
+		util::Time::Section& ZoneSection(const char* name);
+
+		std::array<Frame, vk::MAX_FRAMES_IN_FLIGHT> frames;
+		Frame* current = nullptr;
+		u32 frameZone = NONE; //What BeginFrame() got for the whole frame
+
+		f64 period; //ns per tick
+		u64 timestampMask = 0; //Only timestampValidBits of each value count
+		i64 offset = 0; //Profiler ns minus GPU ns
+		u32 track = NONE; //In the CPU profiler
+
+		std::vector<Result> results;
+		std::vector<u64> timestamps;
+		std::vector<ZoneTime> zoneTimes;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "RecordBenchmark.h"
+#include "Util\JobSystem.h"
+#include "Util\Time.h"
+#include "State.h"
+
+namespace gfx {
+
+	RecordBenchmark::RecordBenchmark(u32 count, PipelineCache* cache, VkRenderPass renderPass) : count(count) {
+		Pipeline::LayoutSettings layoutSettings;
+		layoutSettings.ranges.push_back(VkPushConstantRange{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(QuadConstants) });
+
+		Shader vertShader{ "Shaders\\quad.vert.spv", VK_SHADER_STAGE_VERTEX_BIT };
+		Shader fragShader{ "Shaders\\quad.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT };
+
+		//No vertex input, the corners come from gl_VertexIndex
+		auto settings = GraphicsPipeline::DefaultSettings(vertShader, fragShader, renderPass);
+
+		pipeline = std::make_unique<GraphicsPipeline>(layoutSettings, settings, cache);
+
+		lastReport = global.time->CurrentTime();
+
+		LOGNG(util::Logger::GFX, "Record benchmark running with $ draws on up to $ workers.", count, global.jobs->NumWorkers());
+	}
+
+	void RecordBenchmark::Record(
+		CommandPools& pools,
+		const RenderPass& pass,
+		uint32_t imageIndex,
+		vec2 bounds,
+		std::vector<VkCommandBuffer>& secondaries
+	) {
+		const f64 start = global.time->CurrentTime();
+
+		const mat4 viewProj = math::Ortho(0.f, bounds.x, 0.f, bounds.y, 0.f, 1.f);
+		const u32 columns = math::Max(static_cast<u32>(bounds.x / QUAD_SIZE), 1u);
+		const u32 rows = math::Max(static_cast<u32>(bounds.y / QUAD_SIZE), 1u);
+		const f32 time = static_cast<f32>(start / 1000.0);
+
+		//One contiguous range of quads per worker, each recorded into its own secondary buffer
+		std::vector<VkCommandBuffer> recorded(workers, VK_NULL_HANDLE);
+		const u32 perWorker = (count + workers - 1) / workers;
+
+		global.jobs->ParallelFor(workers, 1, [&](u32 begin, u32 end) {
+			for (u32 worker = begin; worker < end; worker++) {
+				const u32 first = worker * perWorker;
+				const u32 last = math::Min(first + perWorker, count);
+
+				VkCommandBuffer commandBuffer = pools.BeginSecondary(pass, imageIndex);
+				pipeline->Bind(commandBuffer);
+
+				QuadConstants constants{};
+				constants.viewProj = viewProj;
+				vkCmdPushConstants(
+					commandBuffer, pipeline->GetLayout(),
+					VK_SHADER_STAGE_VERTEX_BIT,
+					0, sizeof(mat4), &constants.viewProj
+				);
+
+				for (u32 i = first; i < last; i++) {
+					const u32 cell = i % (columns * rows);
+					constants.rect = vec4{
+						static_cast<f32>(cell % columns) * QUAD_SIZE,
+						static_cast<f32>(cell / columns) * QUAD_SIZE,
+						QUAD_SIZE, QUAD_SIZE
+					};
+
+					//Colored by worker so the split is visible
+					const f32 pulse = 0.5f + 0.5f * math::Sin(time + static_cast<f32>(i) * 0.01f);
+					constants.color = vec4{
+						static_cast<f32>((worker * 3 + 1) % 4) / 3.f,
+						static_cast<f32>((worker * 5 + 2) % 4) / 3.f,
+						pulse,
+						0.25f
+					};
+
+					vkCmdPushConstants(
+						commandBuffer, pipeline->GetLayout(),
+						VK_SHADER_STAGE_VERTEX_BIT,
+						offsetof(QuadConstants, rect), sizeof(vec4) * 2, &constants.rect
+					);
+					vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+				}
+
+				pools.EndSecondary(commandBuffer);
+				recorded[worker] = commandBuffer;
+			}
+		});
+
+		secondaries.insert(secondaries.end(), recorded.begin(), recorded.end());
+
+		recordTime += global.time->CurrentTime() - start;
+		frames++;
+
+		const f64 now = global.time->CurrentTime();
+		if (now - lastReport >= 1000.0) {
+			results.resize(math::Max(static_cast<u32>(results.size()), workers), 0.0);
+			results[workers - 1] = recordTime / frames;
+
+			LOGNG(util::Logger::GFX, "Recorded $ draws in $ms with $ workers ($x the single worker speed).",
+				count, results[workers - 1], workers,
+				results[0] / results[workers - 1]);
+
+			//Once every worker count has been measured start over, so the numbers can be watched settle
+			workers = workers % pools.NumWorkers() + 1;
+			if (workers == 1) {
+				Report();
+			}
+
+			lastReport = now;
+			frames = 0;
+			recordTime = 0.0;
+		}
+	}
+
+	void RecordBenchmark::Report() {
+		std::ostringstream stream;
+		for (usize i = 0; i < results.size(); i++) {
+			stream << (i == 0 ? "" : ", ") << i + 1 << ": " << std::fixed << std::setprecision(3) << results[i] << "ms";
+		}
+
+		LOGNG(util::Logger::GFX, "Record benchmark, ms per frame by worker count: $", stream.str());
+	}
+}
\ No newline at end of file
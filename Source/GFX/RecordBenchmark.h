@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GraphicsPipeline.h"
+#include "CommandPools.h"
+
+namespace gfx {
+
+	//Stress scene for parallel recording, enabled with recordBenchmark under [Debug] in the config.
+	//Records one draw per quad (push constants and vkCmdDraw, the worst case for recording) split
+	//over a growing number of workers, one second per worker count, and logs how recording time scales
+	class RecordBenchmark {
+	public:
+		static constexpr f32 QUAD_SIZE = 4.f;
+
+		RecordBenchmark(u32 count, PipelineCache* cache, VkRenderPass renderPass);
+
+		//Records every quad into secondary buffers for pass and appends them to secondaries
+		void Record(
+			CommandPools& pools,
+			const RenderPass& pass,
+			uint32_t imageIndex,
+			vec2 bounds,
+			std::vector<VkCommandBuffer>& secondaries
+		);
+
+	private:
+		//Matches the push constant block in quad.vert
+		struct QuadConstants {
+			mat4 viewProj;
+			vec4 rect;
+			vec4 color;
+		};
+
+		void Report();
+
+		std::unique_ptr<GraphicsPipeline> pipeline;
+		u32 count;
+
+		u32 workers = 1; //Used this second
+		std::vector<f64> results; //Average ms per worker count, index 0 is one worker
+
+		f64 lastReport;
+		u64 frames = 0;
+		f64 recordTime = 0.0;
+	};
+}
\ No newline at end of file
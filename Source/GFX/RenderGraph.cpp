@@ -0,0 +1,619 @@
+#include "RenderGraph.h"
+#include "GpuProfiler.h"
+#include "Platform\Platform.h"
+#include "State.h"
+
+namespace gfx {
+
+	namespace {
+		inline VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize align) {
+			return (value + align - 1) / align * align;
+		}
+
+		//Stages and access of a target being used as an attachment
+		struct AttachmentSync {
+			VkImageLayout layout;
+			VkImageLayout readLayout;
+			VkPipelineStageFlags stages;
+			VkAccessFlags write;
+			VkAccessFlags read;
+		};
+
+		AttachmentSync SyncFor(VkFormat format) {
+			if (vk::IsColorFormat(format)) {
+				return AttachmentSync{
+					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+					VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+					VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+					VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+					VK_ACCESS_COLOR_ATTACHMENT_READ_BIT
+				};
+			}
+
+			return AttachmentSync{
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+				VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+				VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+				VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+			};
+		}
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(Resource target, LoadOp load, VkClearValue clear) {
+		ASSERT(target < graph.resources.size(), "Invalid render graph resource!");
+
+		auto& node = graph.passes[pass];
+		ASSERT(std::find(node.reads.begin(), node.reads.end(), target) == node.reads.end(),
+			"A pass can't read and write the same target!");
+
+		node.writes.push_back(Output{ target, load, clear });
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(Resource target) {
+		ASSERT(target < graph.resources.size(), "Invalid render graph resource!");
+		ASSERT(target != BACKBUFFER, "The backbuffer can't be sampled!");
+
+		auto& node = graph.passes[pass];
+		ASSERT(std::none_of(node.writes.begin(), node.writes.end(), [&](const Output& output) { return output.target == target; }),
+			"A pass can't read and write the same target!");
+
+		node.reads.push_back(target);
+		graph.resources[target].sampled = true;
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Execute(ExecuteFn execute) {
+		graph.passes[pass].execute = std::move(execute);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::KeepAlive() {
+		graph.passes[pass].keepAlive = true;
+		return *this;
+	}
+
+	RenderGraph::PassBuilder& RenderGraph::PassBuilder::Secondary() {
+		graph.passes[pass].secondary = true;
+		return *this;
+	}
+
+	RenderGraph::RenderGraph() {
+		ResourceNode backbuffer{};
+		backbuffer.name = "Backbuffer";
+		backbuffer.desc.format = VK_FORMAT_UNDEFINED; //The swapchain's, filled in by RenderPass
+		resources.push_back(std::move(backbuffer));
+	}
+
+	RenderGraph::~RenderGraph() {
+		//Framebuffers and images go before the memory they're bound to
+		for (auto& pass : passes) {
+			pass.renderPass.reset();
+		}
+
+		for (auto& resource : resources) {
+			resource.target.reset();
+		}
+
+		FreeHeaps();
+	}
+
+	RenderGraph::Resource RenderGraph::CreateTarget(const std::string& name, const TargetDesc& desc) {
+		ASSERT(!compiled, "Can't add targets to a compiled render graph!");
+
+		ResourceNode node{};
+		node.name = name;
+		node.desc = desc;
+		resources.push_back(std::move(node));
+
+		return static_cast<Resource>(resources.size() - 1);
+	}
+
+	RenderGraph::PassBuilder RenderGraph::AddPass(const std::string& name) {
+		ASSERT(!compiled, "Can't add passes to a compiled render graph!");
+
+		PassNode node{};
+		node.name = name;
+		passes.push_back(std::move(node));
+
+		return PassBuilder(*this, static_cast<u32>(passes.size() - 1));
+	}
+
+	void RenderGraph::Compile(uvec2 newWindowSize) {
+		ASSERT(!compiled, "Render graph is already compiled!");
+
+		windowSize = newWindowSize;
+
+		Sort();
+		Cull();
+		ComputeLifetimes();
+		CreateTargets();
+		Alias();
+		CreateRenderPasses();
+
+		compiled = true;
+
+		LogStats();
+	}
+
+	void RenderGraph::Resize(uvec2 newWindowSize) {
+		ASSERT(compiled, "Render graph has to be compiled before it's resized!");
+
+		windowSize = newWindowSize;
+
+		//Sizes changed, so the whole aliasing layout is redone and every image needs fresh memory
+		CreateTargets();
+		FreeHeaps();
+		Alias();
+
+		for (u32 index : order) {
+			PassNode& pass = passes[index];
+			const Output& first = pass.writes.front();
+			pass.renderPass->Recreate(first.target == BACKBUFFER
+				? vk::VecToExtent(windowSize)
+				: resources[first.target].target->Extent());
+		}
+	}
+
+	void RenderGraph::Execute(VkCommandBuffer commandBuffer, uint32_t imageIndex, GpuProfiler* profiler) {
+		ASSERT(compiled, "Render graph has to be compiled before it's executed!");
+
+		for (u32 index : order) {
+			const PassNode& pass = passes[index];
+			const u32 zone = profiler ? profiler->Begin(commandBuffer, pass.name.c_str()) : GpuProfiler::NONE;
+
+			pass.renderPass->Begin(commandBuffer, imageIndex,
+				pass.secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+
+			if (pass.execute) {
+				pass.execute(commandBuffer, imageIndex);
+			}
+
+			vkCmdEndRenderPass(commandBuffer);
+
+			if (profiler) {
+				profiler->End(commandBuffer, zone);
+			}
+		}
+	}
+
+	VkRenderPass RenderGraph::GetRenderPass(const std::string& name) const {
+		const RenderPass* pass = GetPass(name);
+		return pass ? pass->GetRenderPass() : VK_NULL_HANDLE;
+	}
+
+	const RenderPass* RenderGraph::GetPass(const std::string& name) const {
+		for (const auto& pass : passes) {
+			if (pass.name == name) {
+				return pass.renderPass.get();
+			}
+		}
+
+		WARNNG(util::Logger::GFX, "No render graph pass named $.", name);
+		return nullptr;
+	}
+
+	const RenderTarget& RenderGraph::Target(Resource resource) const {
+		ASSERT(resource != BACKBUFFER && resources[resource].target, "Render graph target doesn't exist, was it culled?");
+		return *resources[resource].target;
+	}
+
+	void RenderGraph::LogStats() const {
+		LOGNG(util::Logger::GFX, "Render graph: $ passes ($ culled), $ targets in $ heaps, $ KiB aliased into $ KiB, $ hazards in $ dependencies.",
+			stats.passes, stats.culled, stats.targets, stats.heaps,
+			stats.transientBytes / 1024, stats.aliasedBytes / 1024,
+			stats.hazards, stats.dependencies);
+	}
+
+	void RenderGraph::Sort() {
+		//Writers of a target run in the order they were added, readers after all of them
+		std::vector<std::vector<u32>> edges(passes.size());
+		std::vector<u32> incoming(passes.size(), 0);
+
+		auto addEdge = [&](u32 from, u32 to) {
+			if (std::find(edges[from].begin(), edges[from].end(), to) == edges[from].end()) {
+				edges[from].push_back(to);
+				incoming[to]++;
+			}
+		};
+
+		for (u32 a = 0; a < passes.size(); a++) {
+			for (const Output& output : passes[a].writes) {
+				for (u32 b = 0; b < passes.size(); b++) {
+					if (a == b) {
+						continue;
+					}
+
+					const PassNode& other = passes[b];
+					if (std::find(other.reads.begin(), other.reads.end(), output.target) != other.reads.end()) {
+						addEdge(a, b);
+					}
+
+					if (b > a && std::any_of(other.writes.begin(), other.writes.end(),
+						[&](const Output& write) { return write.target == output.target; })) {
+						addEdge(a, b);
+					}
+				}
+			}
+		}
+
+		//Kahn's algorithm, ties go to the pass that was added first so the order is stable
+		order.clear();
+		std::vector<b8> done(passes.size(), false);
+		while (order.size() < passes.size()) {
+			u32 next = UINT32_MAX;
+			for (u32 i = 0; i < passes.size(); i++) {
+				if (!done[i] && incoming[i] == 0) {
+					next = i;
+					break;
+				}
+			}
+
+			if (next == UINT32_MAX) {
+				ERROR(-1, util::Logger::GFX, "Render graph has a cycle!");
+			}
+
+			done[next] = true;
+			order.push_back(next);
+			for (u32 to : edges[next]) {
+				incoming[to]--;
+			}
+		}
+	}
+
+	void RenderGraph::Cull() {
+		//Walks backwards from the backbuffer, a pass lives if something later needs what it writes.
+		//Clearing a target means nothing before the pass is needed anymore
+		std::vector<b8> needed(resources.size(), false);
+		needed[BACKBUFFER] = true;
+
+		stats = Stats{};
+
+		for (auto it = order.rbegin(); it != order.rend(); it++) {
+			PassNode& pass = passes[*it];
+
+			b8 alive = pass.keepAlive;
+			for (const Output& output : pass.writes) {
+				alive = alive || needed[output.target];
+			}
+
+			pass.culled = !alive;
+			if (!alive) {
+				stats.culled++;
+				continue;
+			}
+
+			for (const Output& output : pass.writes) {
+				needed[output.target] = output.load == LoadOp::Load;
+			}
+
+			for (Resource read : pass.reads) {
+				needed[read] = true;
+			}
+		}
+
+		std::erase_if(order, [&](u32 index) { return passes[index].culled; });
+		stats.passes = static_cast<u32>(order.size());
+	}
+
+	void RenderGraph::ComputeLifetimes() {
+		for (u32 position = 0; position < order.size(); position++) {
+			const PassNode& pass = passes[order[position]];
+
+			ASSERT(!pass.writes.empty(), "Render graph passes have to write at least one target!");
+
+			for (const Output& output : pass.writes) {
+				ResourceNode& resource = resources[output.target];
+				if (!resource.Used() && output.load == LoadOp::Load) {
+					ERROR(-1, util::Logger::GFX, "Render graph pass $ loads $ before anything wrote it!", pass.name, resource.name);
+				}
+
+				resource.firstUse = math::Min(resource.firstUse, position);
+				resource.lastUse = math::Max(resource.lastUse, position);
+			}
+
+			for (Resource read : pass.reads) {
+				ResourceNode& resource = resources[read];
+				if (!resource.Used()) {
+					ERROR(-1, util::Logger::GFX, "Render graph pass $ reads $ before anything wrote it!", pass.name, resource.name);
+				}
+
+				resource.lastUse = math::Max(resource.lastUse, position);
+			}
+		}
+	}
+
+	void RenderGraph::CreateTargets() {
+		stats.targets = 0;
+
+		for (Resource i = BACKBUFFER + 1; i < resources.size(); i++) {
+			ResourceNode& resource = resources[i];
+			if (!resource.Used()) {
+				continue;
+			}
+
+			stats.targets++;
+
+			//Aliased images can't be rebound, so they're recreated even when the size stays the same
+			if (resource.target) {
+				resource.target->Resize(TargetExtent(resource));
+				continue;
+			}
+
+			resource.target = std::make_unique<RenderTarget>(
+				resource.desc.format,
+				TargetExtent(resource),
+				resource.desc.samples,
+				resource.sampled,
+				true
+			);
+		}
+	}
+
+	VkDeviceSize RenderGraph::FindOffset(const Heap& heap, const ResourceNode& resource, const VkMemoryRequirements& memReqs) const {
+		//Only targets alive at the same time as this one are in the way
+		std::vector<std::pair<VkDeviceSize, VkDeviceSize>> taken;
+		for (Resource other : heap.residents) {
+			const ResourceNode& node = resources[other];
+			if (node.firstUse <= resource.lastUse && resource.firstUse <= node.lastUse) {
+				taken.emplace_back(node.offset, node.offset + node.size);
+			}
+		}
+
+		std::sort(taken.begin(), taken.end());
+
+		VkDeviceSize offset = 0;
+		for (const auto& [begin, end] : taken) {
+			if (AlignUp(offset, memReqs.alignment) + memReqs.size <= begin) {
+				break;
+			}
+			offset = math::Max(offset, end);
+		}
+
+		return AlignUp(offset, memReqs.alignment);
+	}
+
+	void RenderGraph::Alias() {
+		std::vector<std::pair<Resource, VkMemoryRequirements>> targets;
+		for (Resource i = BACKBUFFER + 1; i < resources.size(); i++) {
+			if (resources[i].Used()) {
+				targets.emplace_back(i, resources[i].target->MemoryRequirements());
+			}
+		}
+
+		//Biggest first packs tighter, the smaller targets fill the gaps
+		std::stable_sort(targets.begin(), targets.end(), [](const auto& a, const auto& b) {
+			return a.second.size > b.second.size;
+		});
+
+		stats.transientBytes = 0;
+		stats.aliasedBytes = 0;
+
+		for (const auto& [index, memReqs] : targets) {
+			ResourceNode& resource = resources[index];
+			resource.size = memReqs.size;
+			stats.transientBytes += memReqs.size;
+
+			u32 best = UINT32_MAX;
+			VkDeviceSize bestOffset = 0;
+			VkDeviceSize bestGrowth = std::numeric_limits<VkDeviceSize>::max();
+			for (u32 h = 0; h < heaps.size(); h++) {
+				if ((heaps[h].typeBits & memReqs.memoryTypeBits) == 0) {
+					continue;
+				}
+
+				const VkDeviceSize offset = FindOffset(heaps[h], resource, memReqs);
+				const VkDeviceSize growth = math::Max(offset + memReqs.size, heaps[h].size) - heaps[h].size;
+				if (growth < bestGrowth) {
+					best = h;
+					bestOffset = offset;
+					bestGrowth = growth;
+				}
+			}
+
+			if (best == UINT32_MAX) {
+				best = static_cast<u32>(heaps.size());
+				heaps.emplace_back();
+			}
+
+			Heap& heap = heaps[best];
+			heap.size = math::Max(heap.size, bestOffset + memReqs.size);
+			heap.alignment = math::Max(heap.alignment, memReqs.alignment);
+			heap.typeBits &= memReqs.memoryTypeBits;
+			heap.residents.push_back(index);
+
+			resource.heap = best;
+			resource.offset = bestOffset;
+		}
+
+		const u32 imageCount = global.platform->swapchain->ImageCount();
+		for (Heap& heap : heaps) {
+			VkMemoryRequirements memReqs{};
+			memReqs.size = heap.size;
+			memReqs.alignment = heap.alignment;
+			memReqs.memoryTypeBits = heap.typeBits;
+
+			heap.memory.resize(imageCount);
+			for (auto& allocation : heap.memory) {
+				VULKAN_CHECK(global.platform->device->Allocator().Allocate(
+					memReqs,
+					VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+					false,
+					allocation
+				), "Failed to allocate render graph memory!");
+			}
+
+			for (Resource index : heap.residents) {
+				for (u32 i = 0; i < imageCount; i++) {
+					resources[index].target->BindMemory(i, heap.memory[i].memory, heap.memory[i].offset + resources[index].offset);
+				}
+			}
+
+			stats.aliasedBytes += heap.size;
+		}
+
+		stats.heaps = static_cast<u32>(heaps.size());
+	}
+
+	void RenderGraph::CreateRenderPasses() {
+		//Layout the next use after position wants, nullopt if the target isn't used again this frame
+		auto nextLayout = [&](Resource target, u32 position) -> std::optional<VkImageLayout> {
+			const AttachmentSync sync = SyncFor(resources[target].desc.format);
+			for (u32 p = position + 1; p < order.size(); p++) {
+				const PassNode& pass = passes[order[p]];
+				if (std::find(pass.reads.begin(), pass.reads.end(), target) != pass.reads.end()) {
+					return sync.readLayout;
+				}
+
+				for (const Output& output : pass.writes) {
+					if (output.target == target) {
+						return sync.layout;
+					}
+				}
+			}
+
+			return std::nullopt;
+		};
+
+		//Consumers of what position writes, their stages make up its outgoing dependency
+		auto consumers = [&](Resource target, u32 position, VkPipelineStageFlags& stages, VkAccessFlags& access) {
+			const AttachmentSync sync = SyncFor(resources[target].desc.format);
+			for (u32 p = position + 1; p < order.size(); p++) {
+				const PassNode& pass = passes[order[p]];
+				if (std::find(pass.reads.begin(), pass.reads.end(), target) != pass.reads.end()) {
+					stages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+					access |= VK_ACCESS_SHADER_READ_BIT;
+					stats.hazards++;
+				}
+
+				for (const Output& output : pass.writes) {
+					if (output.target == target && output.load == LoadOp::Load) {
+						stages |= sync.stages;
+						access |= sync.read | sync.write;
+						stats.hazards++;
+					}
+				}
+			}
+		};
+
+		stats.dependencies = 0;
+		stats.hazards = 0;
+
+		std::vector<VkImageLayout> layouts(resources.size(), VK_IMAGE_LAYOUT_UNDEFINED);
+
+		for (u32 position = 0; position < order.size(); position++) {
+			PassNode& pass = passes[order[position]];
+
+			const Output& first = pass.writes.front();
+			const VkExtent2D extent = first.target == BACKBUFFER
+				? vk::VecToExtent(windowSize)
+				: resources[first.target].target->Extent();
+
+			RenderPass::Builder builder(extent, 1);
+
+			VkPipelineStageFlags srcStages = 0, dstStages = 0;
+			VkAccessFlags dstAccess = 0;
+
+			VkPipelineStageFlags outStages = 0;
+			VkAccessFlags outAccess = 0, outSrcAccess = 0;
+			VkPipelineStageFlags outSrcStages = 0;
+
+			for (const Output& output : pass.writes) {
+				const std::optional<VkImageLayout> next = nextLayout(output.target, position);
+
+				u32 flags = 0;
+				switch (output.load) {
+				case LoadOp::Clear:
+					flags |= RenderPass::Builder::Clear;
+					break;
+				case LoadOp::Load:
+					flags |= RenderPass::Builder::Load;
+					break;
+				default:
+					break;
+				}
+
+				if (output.target == BACKBUFFER) {
+					if (!next) {
+						flags |= RenderPass::Builder::Presentable;
+					}
+
+					builder.AddSwapAttachment({ {0, RenderTarget::Color} }, flags, output.clear.color);
+					layouts[BACKBUFFER] = next ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+				}
+				else {
+					const RenderTarget& target = *resources[output.target].target;
+
+					//Nothing after this pass uses the target, so its contents don't have to reach memory
+					if (next) {
+						flags |= RenderPass::Builder::Store;
+					}
+
+					builder.AddAttachment(
+						target,
+						{ {0, vk::IsColorFormat(target.GetFormat()) ? RenderTarget::Color : RenderTarget::Depth} },
+						flags,
+						output.clear,
+						layouts[output.target],
+						next.value_or(VK_IMAGE_LAYOUT_UNDEFINED)
+					);
+					layouts[output.target] = next.value_or(VK_IMAGE_LAYOUT_UNDEFINED);
+				}
+
+				//Overwriting has to wait for earlier reads of the image, including targets that were
+				//aliased into the same memory and last frame's uses of it
+				const AttachmentSync sync = SyncFor(output.target == BACKBUFFER
+					? global.platform->swapchain->Format()
+					: resources[output.target].desc.format);
+				if (output.load != LoadOp::Load) {
+					srcStages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | sync.stages;
+					dstStages |= sync.stages;
+					dstAccess |= sync.write;
+					stats.hazards++;
+				}
+
+				VkPipelineStageFlags stages = 0;
+				VkAccessFlags access = 0;
+				consumers(output.target, position, stages, access);
+				if (stages != 0) {
+					outSrcStages |= sync.stages;
+					outSrcAccess |= sync.write;
+					outStages |= stages;
+					outAccess |= access;
+				}
+			}
+
+			//Everything the pass waits on goes into one dependency, and so does everything waiting on it
+			if (srcStages != 0) {
+				builder.AddDependency(VK_SUBPASS_EXTERNAL, 0, srcStages, dstStages, 0, dstAccess);
+				stats.dependencies++;
+			}
+
+			if (outStages != 0) {
+				builder.AddDependency(0, VK_SUBPASS_EXTERNAL, outSrcStages, outStages, outSrcAccess, outAccess);
+				stats.dependencies++;
+			}
+
+			pass.renderPass = builder.Create();
+		}
+	}
+
+	void RenderGraph::FreeHeaps() {
+		for (Heap& heap : heaps) {
+			for (auto& allocation : heap.memory) {
+				global.platform->device->Allocator().Free(allocation);
+			}
+		}
+
+		heaps.clear();
+	}
+
+	VkExtent2D RenderGraph::TargetExtent(const ResourceNode& resource) const {
+		if (resource.desc.size.x == 0 || resource.desc.size.y == 0) {
+			return vk::VecToExtent(windowSize);
+		}
+
+		return vk::VecToExtent(resource.desc.size);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "RenderPass.h"
+#include "RenderTarget.h"
+
+namespace gfx {
+
+	class GpuProfiler;
+
+	//Describes a frame as passes that read and write render targets. Compile culls passes whose
+	//output is never used, orders the rest by their dependencies, picks every attachment's layouts
+	//so the render passes do all transitions, merges each pass's synchronization into one external
+	//dependency and lets transient targets with disjoint lifetimes share memory.
+	//Every pass is one render pass with a single subpass, reads are sampled in fragment shaders.
+	//Readers see the result of all writers of a target, so ping-ponging needs two targets (which
+	//aliasing makes free). Targets only live for one frame, their contents aren't kept
+	class RenderGraph {
+	public:
+		using Resource = u32;
+
+		static constexpr Resource BACKBUFFER = 0; //The swapchain image, always imported
+		static constexpr Resource NONE = UINT32_MAX;
+
+		enum class LoadOp : u32 {
+			Clear,
+			Load, //Keeps what earlier passes wrote
+			DontCare
+		};
+
+		struct TargetDesc {
+			VkFormat format;
+			uvec2 size{ 0u }; //0 follows the window
+			VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+		};
+
+		using ExecuteFn = std::function<void(VkCommandBuffer commandBuffer, uint32_t imageIndex)>;
+
+		class PassBuilder {
+		public:
+			PassBuilder(RenderGraph& graph, u32 pass) : graph(graph), pass(pass) {}
+
+			PassBuilder& Write(Resource target, LoadOp load = LoadOp::Clear, VkClearValue clear = {});
+			PassBuilder& Read(Resource target);
+			PassBuilder& Execute(ExecuteFn execute);
+
+			//Never culled, for passes with side effects outside the graph
+			PassBuilder& KeepAlive();
+
+			//The pass is recorded into secondary command buffers, its execute function may only call vkCmdExecuteCommands
+			PassBuilder& Secondary();
+
+		private:
+			RenderGraph& graph;
+			u32 pass;
+		};
+
+		struct Stats {
+			u32 passes = 0;
+			u32 culled = 0;
+			u32 targets = 0;
+			u32 heaps = 0;
+			u32 dependencies = 0; //After merging, one per pass at most
+			u32 hazards = 0; //Before merging
+			VkDeviceSize transientBytes = 0; //Without aliasing, per swapchain image
+			VkDeviceSize aliasedBytes = 0; //With aliasing, per swapchain image
+		};
+
+		RenderGraph();
+		~RenderGraph();
+
+		RenderGraph(const RenderGraph& other) = delete;
+		RenderGraph& operator=(const RenderGraph& other) = delete;
+
+		Resource CreateTarget(const std::string& name, const TargetDesc& desc);
+		PassBuilder AddPass(const std::string& name);
+
+		//Has to be called once after every pass is added, the graph can't change afterwards
+		void Compile(uvec2 windowSize);
+
+		//Recreates window sized targets and redoes the aliasing, render passes stay valid
+		void Resize(uvec2 windowSize);
+
+		//Every pass is a GPU zone when profiler is given
+		void Execute(VkCommandBuffer commandBuffer, uint32_t imageIndex, GpuProfiler* profiler = nullptr);
+
+		//VK_NULL_HANDLE if the pass was culled
+		VkRenderPass GetRenderPass(const std::string& name) const;
+		//nullptr if the pass was culled
+		const RenderPass* GetPass(const std::string& name) const;
+		const RenderTarget& Target(Resource resource) const;
+
+		inline const Stats& GetStats() const { return stats; }
+		void LogStats() const;
+
+	private:
+		struct Output {
+			Resource target;
+			LoadOp load;
+			VkClearValue clear;
+		};
+
+		struct PassNode {
+			std::string name;
+			std::vector<Output> writes;
+			std::vector<Resource> reads;
+			ExecuteFn execute;
+			b8 keepAlive = false;
+			b8 secondary = false;
+
+			b8 culled = false;
+			std::unique_ptr<RenderPass> renderPass;
+		};
+
+		struct ResourceNode {
+			std::string name;
+			TargetDesc desc;
+			std::unique_ptr<RenderTarget> target;
+			b8 sampled = false;
+			VkDeviceSize size = 0;
+
+			//Position in the execution order of the first and last use, only alive passes count
+			u32 firstUse = UINT32_MAX;
+			u32 lastUse = 0;
+
+			u32 heap = UINT32_MAX;
+			VkDeviceSize offset = 0;
+
+			inline b8 Used() const { return firstUse != UINT32_MAX; }
+		};
+
+		//Memory shared by aliased targets, one allocation per swapchain image
+		struct Heap {
+			VkDeviceSize size = 0;
+			VkDeviceSize alignment = 1;
+			uint32_t typeBits = ~0u;
+			std::vector<Resource> residents;
+			std::vector<platform::Allocation> memory;
+		};
+
+		void Cull();
+		void Sort();
+		void ComputeLifetimes();
+		void CreateTargets();
+		void Alias();
+		void CreateRenderPasses();
+		void FreeHeaps();
+
+		VkExtent2D TargetExtent(const ResourceNode& resource) const;
+		VkDeviceSize FindOffset(const Heap& heap, const ResourceNode& resource, const VkMemoryRequirements& memReqs) const;
+
+		std::vector<PassNode> passes;
+		std::vector<ResourceNode> resources;
+		std::vector<u32> order; //Alive passes in execution order
+		std::vector<Heap> heaps;
+
+		uvec2 windowSize{ 0u };
+		b8 compiled = false;
+
+		Stats stats;
+	};
+}
\ No newline at end of file
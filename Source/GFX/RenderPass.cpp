@@ -38,7 +38,8 @@ namespace gfx {
 			attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 		}
 		else {
-			attachment.finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			//finalLayout can't be UNDEFINED, the contents are thrown away either way
+			attachment.finalLayout = layoutType;
 			attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		}
 
@@ -67,6 +68,7 @@ namespace gfx {
 
 		Attachment attach{};
 		attach.description = attachment;
+		attach.clear = clear;
 		attach.target = &target;
 
 		attachments.push_back(attach);
@@ -235,7 +237,7 @@ namespace gfx {
 		vkDestroyRenderPass(*global.platform->device, renderPass, nullptr);
 	}
 
-	void RenderPass::Begin(VkCommandBuffer commandBuffer, uint32_t imageIndex) const {
+	void RenderPass::Begin(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkSubpassContents contents) const {
 		VkRenderPassBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 		beginInfo.renderPass = renderPass;
@@ -245,8 +247,14 @@ namespace gfx {
 		beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 		beginInfo.pClearValues = clearValues.data();
 
-		vkCmdBeginRenderPass(commandBuffer, &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		vkCmdBeginRenderPass(commandBuffer, &beginInfo, contents);
 
+		if (contents == VK_SUBPASS_CONTENTS_INLINE) {
+			SetViewport(commandBuffer);
+		}
+	}
+
+	void RenderPass::SetViewport(VkCommandBuffer commandBuffer) const {
 		VkViewport viewport{};
 		viewport.x = 0;
 		viewport.y = 0;
@@ -79,7 +79,18 @@ namespace gfx {
 		inline operator VkRenderPass() const { return renderPass; }
 		inline VkRenderPass GetRenderPass() const { return renderPass; }
 
-		void Begin(VkCommandBuffer commandBuffer, uint32_t imageIndex) const;
+		//With secondary contents the viewport and scissor are left to the secondary buffers
+		void Begin(
+			VkCommandBuffer commandBuffer,
+			uint32_t imageIndex,
+			VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE
+		) const;
+
+		//Covers the whole pass
+		void SetViewport(VkCommandBuffer commandBuffer) const;
+
+		inline VkFramebuffer GetFramebuffer(uint32_t imageIndex) const { return framebuffers[imageIndex]; }
+		inline VkExtent2D Extent() const { return extent; }
 		void Recreate(VkExtent2D newExtent);
 
 	private:
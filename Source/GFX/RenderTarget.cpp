@@ -10,11 +10,12 @@ namespace gfx {
 		VkFormat format,
 		VkExtent2D extent,
 		VkSampleCountFlagBits samples,
-		b8 sampled
-	) : format(format), samples(samples) {
+		b8 sampled,
+		b8 aliased
+	) : format(format), extent(extent), samples(samples), aliased(aliased) {
 		uid = nextID++;
 
-		VkImageUsageFlags usage = sampled ? VK_IMAGE_USAGE_SAMPLED_BIT : 0;
+		usage = sampled ? VK_IMAGE_USAGE_SAMPLED_BIT : 0;
 		if (vk::IsColorFormat(format)) {
 			usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 		}
@@ -22,78 +23,82 @@ namespace gfx {
 			usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
 		}
 
-		images.resize(global.platform->swapchain->ImageCount());
-		views.resize(global.platform->swapchain->ImageCount());
-		memory.resize(global.platform->swapchain->ImageCount());
-		for (u32 i = 0; i < images.size(); i++) {
-			VULKAN_CHECK(global.platform->device->CreateImage(
-				format,
-				vk::Extent2DTo3D(extent),
-				VK_IMAGE_TYPE_2D,
-				1, 1,
-				VK_IMAGE_TILING_OPTIMAL,
-				VK_IMAGE_LAYOUT_UNDEFINED,
-				samples,
-				usage,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				vk::QueueFamilies::Graphics,
-				images[i],
-				memory[i]
-			), "Failed to create render texture!");
-
-			VULKAN_CHECK(global.platform->device->CreateImageView(
-				images[i],
-				format,
-				VK_IMAGE_VIEW_TYPE_2D,
-				1, 1,
-				vk::AspectFromFormat(format),
-				views[i]
-			), "Failed to create target image view!");
-		}
+		CreateImages();
 	}
 
 	RenderTarget::~RenderTarget() {
-		for (u32 i = 0; i < images.size(); i++) {
-			vkDestroyImageView(*global.platform->device, views[i], nullptr);
-			vkDestroyImage(*global.platform->device, images[i], nullptr);
-			vkFreeMemory(*global.platform->device, memory[i], nullptr);
-		}
+		DestroyImages();
 	}
 
 	VkDescriptorImageInfo RenderTarget::GetDescriptorInfo(uint32_t index) const {
 		VkDescriptorImageInfo info{};
 		info.imageView = views[index];
+		//Descriptors are for sampling, so the pass writing the target has to end in a read only layout
 		if (vk::IsColorFormat(format)) {
-			info.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 		}
 		else {
-			info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+			info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 		}
 		return info;
 	}
 
 	void RenderTarget::Resize(VkExtent2D newExtent) {
-		for (u32 i = 0; i < images.size(); i++) {
-			vkDestroyImageView(*global.platform->device, views[i], nullptr);
-			vkDestroyImage(*global.platform->device, images[i], nullptr);
-			vkFreeMemory(*global.platform->device, memory[i], nullptr);
-		}
+		DestroyImages();
+		extent = newExtent;
+		CreateImages();
+	}
 
-		VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT;
-		if (vk::IsColorFormat(format)) {
-			usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-		}
-		else {
-			usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-		}
+	VkMemoryRequirements RenderTarget::MemoryRequirements() const {
+		//Every image has the same description, so they all have the same requirements
+		VkMemoryRequirements memReqs;
+		vkGetImageMemoryRequirements(*global.platform->device, images[0], &memReqs);
+		return memReqs;
+	}
 
+	void RenderTarget::BindMemory(uint32_t index, VkDeviceMemory memory, VkDeviceSize offset) {
+		ASSERT(aliased, "Only aliased render targets can be bound to external memory!");
+		ASSERT(views[index] == VK_NULL_HANDLE, "Render target image is already bound!");
+
+		VULKAN_CHECK(vkBindImageMemory(*global.platform->device, images[index], memory, offset),
+			"Failed to bind render target memory!");
+
+		VULKAN_CHECK(global.platform->device->CreateImageView(
+			images[index],
+			format,
+			VK_IMAGE_VIEW_TYPE_2D,
+			1, 1,
+			vk::AspectFromFormat(format),
+			views[index]
+		), "Failed to create target image view!");
+	}
+
+	void RenderTarget::CreateImages() {
 		images.resize(global.platform->swapchain->ImageCount());
-		views.resize(global.platform->swapchain->ImageCount());
+		views.resize(global.platform->swapchain->ImageCount(), VK_NULL_HANDLE);
 		memory.resize(global.platform->swapchain->ImageCount());
 		for (u32 i = 0; i < images.size(); i++) {
+			if (aliased) {
+				VULKAN_CHECK(global.platform->device->CreateImage(
+					format,
+					vk::Extent2DTo3D(extent),
+					VK_IMAGE_TYPE_2D,
+					1, 1,
+					VK_IMAGE_TILING_OPTIMAL,
+					VK_IMAGE_LAYOUT_UNDEFINED,
+					samples,
+					usage,
+					vk::QueueFamilies::Graphics,
+					images[i]
+				), "Failed to create render texture!");
+
+				views[i] = VK_NULL_HANDLE;
+				continue;
+			}
+
 			VULKAN_CHECK(global.platform->device->CreateImage(
 				format,
-				vk::Extent2DTo3D(newExtent),
+				vk::Extent2DTo3D(extent),
 				VK_IMAGE_TYPE_2D,
 				1, 1,
 				VK_IMAGE_TILING_OPTIMAL,
@@ -116,4 +121,20 @@ namespace gfx {
 			), "Failed to create target image view!");
 		}
 	}
+
+	void RenderTarget::DestroyImages() {
+		for (u32 i = 0; i < images.size(); i++) {
+			if (views[i] != VK_NULL_HANDLE) {
+				vkDestroyImageView(*global.platform->device, views[i], nullptr);
+			}
+
+			//Aliased memory belongs to whoever bound it
+			if (aliased) {
+				vkDestroyImage(*global.platform->device, images[i], nullptr);
+			}
+			else {
+				global.platform->device->DestroyImage(images[i], memory[i]);
+			}
+		}
+	}
 }
\ No newline at end of file
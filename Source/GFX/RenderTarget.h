@@ -3,6 +3,7 @@
 #include "Util\Types.h"
 #include "Util\Std.h"
 #include "Util\Vulkan.h"
+#include "Platform\Allocator.h"
 
 namespace gfx {
 
@@ -15,32 +16,47 @@ namespace gfx {
 			Depth
 		};
 
+		//Aliased targets are created without memory, BindMemory has to be called for every
+		//image before its view can be used. Lets the render graph overlap transient targets
 		RenderTarget(
 			VkFormat format,
 			VkExtent2D extent,
 			VkSampleCountFlagBits samples,
-			b8 sampled = false
+			b8 sampled = false,
+			b8 aliased = false
 		);
 
 		~RenderTarget();
 
+		//Aliased targets lose their memory binding and have to be bound again
 		void Resize(VkExtent2D extent);
 
+		VkMemoryRequirements MemoryRequirements() const;
+		void BindMemory(uint32_t index, VkDeviceMemory memory, VkDeviceSize offset);
+
 		inline usize UID() const { return uid; }
 		inline u32 NumViews() const { return static_cast<u32>(views.size()); }
 		inline VkFormat GetFormat() const { return format; }
 		inline VkSampleCountFlagBits NumSamples() const { return samples; }
+		inline VkExtent2D Extent() const { return extent; }
+		inline b8 IsAliased() const { return aliased; }
 		inline VkImageView GetView(uint32_t index) const { return views[index]; }
 		VkDescriptorImageInfo GetDescriptorInfo(uint32_t index) const;
 
 	private:
+		void CreateImages();
+		void DestroyImages();
+
 		usize uid;
 
 		std::vector<VkImage> images;
 		std::vector<VkImageView> views;
-		std::vector<VkDeviceMemory> memory;
+		std::vector<platform::Allocation> memory;
 		VkFormat format;
+		VkExtent2D extent;
 		VkSampleCountFlagBits samples;
+		VkImageUsageFlags usage;
+		b8 aliased;
 
 		static usize nextID;
 	};
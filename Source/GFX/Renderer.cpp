@@ -1,43 +1,68 @@
 #include "Renderer.h"
 #include "Platform\Platform.h"
 #include "Util\Configuration.h"
+#include "Util\File.h"
+#include "Util\JobSystem.h"
+#include "Util\Profiler.h"
 #include "State.h"
 
 namespace gfx {
 
-	Renderer::Renderer() : extent(vk::ExtentToVec(global.platform->swapchain->Extent())), cache(global.config->pipelineCache) {
-		VkCommandBufferAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		allocInfo.commandPool = global.platform->device->GraphicsPool();
-		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		allocInfo.commandBufferCount = vk::MAX_FRAMES_IN_FLIGHT;
-		commandBuffers.resize(vk::MAX_FRAMES_IN_FLIGHT);
-
-		VULKAN_CHECK(vkAllocateCommandBuffers(
-			*global.platform->device,
-			&allocInfo,
-			commandBuffers.data()
-		), "Failed to allocate command buffers!");
-	}
-
-	Renderer::~Renderer() {
-		vkFreeCommandBuffers(
-			*global.platform->device,
-			global.platform->device->GraphicsPool(),
-			vk::MAX_FRAMES_IN_FLIGHT,
-			commandBuffers.data()
-		);
+	Renderer::Renderer() : extent(vk::ExtentToVec(global.platform->swapchain->Extent())),
+		virtualExtent(global.config->virtualSize), cache(global.config->pipelineCache) {
+		commandPools = std::make_unique<CommandPools>(global.jobs->NumWorkers());
+		uploader = std::make_unique<Uploader>();
+		gpuProfiler = std::make_unique<GpuProfiler>();
 	}
 
 	void Renderer::Init() {
-		passes["Main"] = RenderPass::Builder(vk::VecToExtent(extent), 1)
-			.AddSwapAttachment(
-				{ {0, RenderTarget::Color} },
-				RenderPass::Builder::Clear | RenderPass::Builder::Presentable,
-				{ {0.f, 0.f, 0.f} })
-			.Create();
-
-		triRenderer.Init(&cache, *passes["Main"]);
+		//The scene is drawn at the virtual resolution and only the composite runs at window resolution,
+		//so fill rate and bandwidth follow the virtual size
+		virtualTarget = graph.CreateTarget("Virtual", RenderGraph::TargetDesc{
+			global.platform->swapchain->Format(),
+			virtualExtent
+		});
+
+		graph.AddPass("Scene")
+			.Write(virtualTarget, RenderGraph::LoadOp::Clear, VkClearValue{ { {0.f, 0.f, 0.f, 1.f} } })
+			.Secondary()
+			.Execute([this](VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+				RenderScene(commandBuffer, imageIndex);
+			});
+
+		graph.AddPass("Composite")
+			.Read(virtualTarget)
+			.Write(RenderGraph::BACKBUFFER, RenderGraph::LoadOp::Clear, VkClearValue{ { {0.f, 0.f, 0.f, 1.f} } })
+			.Execute([this](VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+				upscaler.Render(commandBuffer, imageIndex, extent);
+			});
+
+		graph.Compile(extent);
+		scenePass = graph.GetPass("Scene");
+
+		triRenderer.Init(&cache, graph.GetRenderPass("Scene"));
+		spriteBatch.Init(&cache, graph.GetRenderPass("Scene"));
+		tilemapRenderer.Init(&cache, graph.GetRenderPass("Scene"));
+
+		upscaler.Init(&cache, graph.GetRenderPass("Composite"), graph.Target(virtualTarget), virtualExtent);
+		upscaler.SetMode(global.config->upscale);
+
+		if (util::FileExists(SPRITE_DIRECTORY)) {
+			atlas = std::make_unique<TextureAtlas>();
+			atlas->LoadOrBuild(SPRITE_DIRECTORY);
+		}
+
+		if (global.config->spriteBenchmark > 0) {
+			spriteBenchmark = std::make_unique<SpriteBenchmark>(global.config->spriteBenchmark);
+		}
+
+		if (global.config->tilemapBenchmark > 0) {
+			tilemapBenchmark = std::make_unique<TilemapBenchmark>(global.config->tilemapBenchmark);
+		}
+
+		if (global.config->recordBenchmark > 0) {
+			recordBenchmark = std::make_unique<RecordBenchmark>(global.config->recordBenchmark, &cache, scenePass->GetRenderPass());
+		}
 	}
 
 	void Renderer::Destroy() {
@@ -45,10 +70,13 @@ namespace gfx {
 	}
 
 	VkCommandBuffer Renderer::Begin() {
+		PROFILE_FUNCTION();
 		ASSERT(!frameStarted, "Can't call Renderer::Begin when the frame is already running!");
 
 		frameStarted = true;
 
+		uploader->Update();
+
 		VkResult result = global.platform->swapchain->AcquireImage(&imageIndex);
 		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
 			Resized();
@@ -57,39 +85,113 @@ namespace gfx {
 			ERROR((i32)result, util::Logger::Vulkan, "Failed to acquire swapchain image!");
 		}
 
-		//VULKAN_CHECK(vkResetCommandBuffer(
-		//	commandBuffers[global.platform->swapchain->CurrentFrame()], 0),
-		//	"Failed to reset command buffer!");
+		//The frame's fence was waited on in AcquireImage, so everything it recorded last time can be recycled
+		commandPools->BeginFrame(global.platform->swapchain->CurrentFrame());
+		VkCommandBuffer commandBuffer = commandPools->Primary();
 
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 		
 		VULKAN_CHECK(vkBeginCommandBuffer(
-			commandBuffers[global.platform->swapchain->CurrentFrame()],
+			commandBuffer,
 			&beginInfo),
 			"Failed to begin command buffer!");
 
-		return commandBuffers[global.platform->swapchain->CurrentFrame()];
+		gpuProfiler->BeginFrame(commandBuffer, global.platform->swapchain->CurrentFrame());
+
+		return commandBuffer;
 	}
 
 	void Renderer::Composite(VkCommandBuffer commandBuffer) {
 		ASSERT(frameStarted, "Can't composite frame when it hasn't started yet!");
 
-		passes["Main"]->Begin(commandBuffer, imageIndex);
+		if (tilemapBenchmark) {
+			tilemapBenchmark->Update();
+		}
+
+		graph.Execute(commandBuffer, imageIndex, gpuProfiler.get());
+	}
+
+	void Renderer::RenderScene(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+		PROFILE_FUNCTION();
+		const uint32_t frameIndex = global.platform->swapchain->CurrentFrame();
+
+		//SpriteBatch isn't thread safe, so sprites are queued before recording starts
+		if (spriteBenchmark) {
+			spriteBenchmark->Update(spriteBatch, static_cast<vec2>(virtualExtent));
+		}
+
+		//Every renderer records into its own secondary buffer on whichever worker picks it up.
+		//They're executed in a fixed order, so the draw order is the same as recording inline
+		enum Slot : u32 { Tilemap, Triangle, Sprites, NumSlots };
+		std::array<VkCommandBuffer, NumSlots> recorded{};
+		util::JobSystem::Counter counter;
+
+		static constexpr std::array<const char*, NumSlots> SLOT_NAMES = { "Tilemap", "Triangle", "Sprites" };
+		auto record = [&](Slot slot, std::function<void(VkCommandBuffer)> draw) {
+			global.jobs->Run([&, slot, draw = std::move(draw)]() {
+				VkCommandBuffer secondary = commandPools->BeginSecondary(*scenePass, imageIndex);
+				{
+					GpuProfiler::Zone zone{ *gpuProfiler, secondary, SLOT_NAMES[slot] };
+					draw(secondary);
+				}
+				commandPools->EndSecondary(secondary);
+				recorded[slot] = secondary;
+			}, &counter);
+		};
+
+		if (tilemapBenchmark) {
+			record(Tilemap, [&](VkCommandBuffer secondary) {
+				tilemapBenchmark->Render(secondary, tilemapRenderer, static_cast<vec2>(virtualExtent));
+			});
+		}
 
 		//TODO: draw here
-		triRenderer.Render(commandBuffer,
-			global.platform->swapchain->CurrentFrame());
+		record(Triangle, [&](VkCommandBuffer secondary) {
+			triRenderer.Render(secondary, frameIndex);
+		});
+
+		//Sprites are positioned in virtual pixels from the top left corner
+		record(Sprites, [&](VkCommandBuffer secondary) {
+			spriteBatch.Render(secondary, frameIndex,
+				math::Ortho(0.f, static_cast<f32>(virtualExtent.x), 0.f, static_cast<f32>(virtualExtent.y), 0.f, 1.f));
+		});
+
+		//Quads go between the triangle and the sprites, recorded from here while the others run
+		std::vector<VkCommandBuffer> benchmark;
+		if (recordBenchmark) {
+			recordBenchmark->Record(*commandPools, *scenePass, imageIndex, static_cast<vec2>(virtualExtent), benchmark);
+		}
+
+		global.jobs->Wait(counter);
 
-		vkCmdEndRenderPass(commandBuffer);
+		std::vector<VkCommandBuffer> secondaries;
+		for (u32 slot = 0; slot < NumSlots; slot++) {
+			if (slot == Sprites) {
+				secondaries.insert(secondaries.end(), benchmark.begin(), benchmark.end());
+			}
+
+			if (recorded[slot] != VK_NULL_HANDLE) {
+				secondaries.push_back(recorded[slot]);
+			}
+		}
+
+		vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaries.size()), secondaries.data());
 	}
 
 	void Renderer::End(VkCommandBuffer commandBuffer) {
+		PROFILE_FUNCTION();
 		ASSERT(frameStarted, "Can't end frame when it hasn't started yet!");
 
+		gpuProfiler->EndFrame(commandBuffer);
+
 		VULKAN_CHECK(vkEndCommandBuffer(commandBuffer),
 			"Failed to end command buffer!");
 
+		//Uploads recorded this frame go first on the graphics queue, so the frame can use them
+		uploader->Submit();
+
 		VkResult result = global.platform->swapchain->SubmitFrame(
 			commandBuffer, &imageIndex);
 
@@ -113,13 +215,14 @@ namespace gfx {
 		vkDeviceWaitIdle(*global.platform->device);
 
 		global.platform->swapchain->Recreate();
+		gpuProfiler->Calibrate();
 
 		extent = static_cast<uvec2>(vk::ExtentToVec(global.platform->swapchain->Extent()));
 
 		LOGNG(util::Logger::GFX, "Window resized to $.", extent);
 
-		for (auto& [name, pass] : passes) {
-			pass->Recreate(vk::VecToExtent(extent));
-		}
+		//Targets are recreated when the graph redoes its aliasing, so the sets reading them are too
+		graph.Resize(extent);
+		upscaler.SetSource(graph.Target(virtualTarget));
 	}
 }
\ No newline at end of file
@@ -1,15 +1,25 @@
 #pragma once
 
-#include "RenderPass.h"
-#include "RenderTarget.h"
+#include "RenderGraph.h"
 #include "TriangleRenderer.h"
+#include "SpriteBatch.h"
+#include "SpriteBenchmark.h"
+#include "TilemapRenderer.h"
+#include "TilemapBenchmark.h"
+#include "Upscaler.h"
+#include "CommandPools.h"
+#include "RecordBenchmark.h"
+#include "Uploader.h"
+#include "GpuProfiler.h"
 
 namespace gfx {
 
 	class Renderer {
 	public:
+		//Every image in here is packed into the sprite atlas
+		static constexpr const char* SPRITE_DIRECTORY = "Resources\\Sprites";
+
 		Renderer();
-		~Renderer();
 
 		void Init();
 		void Destroy();
@@ -20,22 +30,44 @@ namespace gfx {
 
 		void Resized();
 
-		inline f32 Aspect() const { return extent.x / static_cast<f32>(extent.y); }
+		//The scene is drawn at the virtual resolution, so this is the aspect of that and not the window
+		inline f32 Aspect() const { return virtualExtent.x / static_cast<f32>(virtualExtent.y); }
+		inline uvec2 VirtualExtent() const { return virtualExtent; }
+		inline Uploader& GetUploader() { return *uploader; }
+		inline SpriteBatch& Sprites() { return spriteBatch; }
+		inline TextureAtlas* Atlas() { return atlas.get(); }
+		inline TilemapRenderer& Tilemaps() { return tilemapRenderer; }
+		inline RenderGraph& Graph() { return graph; }
+		inline GpuProfiler& Gpu() { return *gpuProfiler; }
 
 	private:
-		std::unordered_map<std::string, std::unique_ptr<RenderPass>> passes;
+		void RenderScene(VkCommandBuffer commandBuffer, uint32_t imageIndex);
 
-		std::unordered_map<std::string, std::unique_ptr<RenderTarget>> targets;
+		RenderGraph graph;
+		RenderGraph::Resource virtualTarget = RenderGraph::NONE;
+		const RenderPass* scenePass = nullptr;
 
-		std::vector<VkCommandBuffer> commandBuffers;
+		std::unique_ptr<CommandPools> commandPools;
+		std::unique_ptr<GpuProfiler> gpuProfiler;
 
 		bool frameStarted = false;
 
 		uvec2 extent;
+		uvec2 virtualExtent;
 		uint32_t imageIndex;
 
 		PipelineCache cache;
 
+		std::unique_ptr<Uploader> uploader;
+
 		TriangleRenderer triRenderer;
+		SpriteBatch spriteBatch;
+		TilemapRenderer tilemapRenderer;
+		Upscaler upscaler;
+		std::unique_ptr<TextureAtlas> atlas;
+
+		std::unique_ptr<SpriteBenchmark> spriteBenchmark;
+		std::unique_ptr<TilemapBenchmark> tilemapBenchmark;
+		std::unique_ptr<RecordBenchmark> recordBenchmark;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "SpriteBatch.h"
+#include "Util\Time.h"
+#include "Util\Profiler.h"
+#include "State.h"
+
+namespace gfx {
+
+	namespace {
+		//Flips the bits of a float so that unsigned comparison matches float comparison
+		u32 SortableFloat(f32 value) {
+			u32 bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+		}
+
+		VkPipelineColorBlendAttachmentState BlendState(SpriteBatch::Blend blend) {
+			VkPipelineColorBlendAttachmentState state{};
+			state.blendEnable = VK_TRUE;
+			state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+			state.dstColorBlendFactor = blend == SpriteBatch::Blend::Additive
+				? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+			state.colorBlendOp = VK_BLEND_OP_ADD;
+			state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+			state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+			state.alphaBlendOp = VK_BLEND_OP_ADD;
+			state.colorWriteMask = VK_COLOR_COMPONENT_R_BIT
+				| VK_COLOR_COMPONENT_G_BIT
+				| VK_COLOR_COMPONENT_B_BIT
+				| VK_COLOR_COMPONENT_A_BIT;
+			return state;
+		}
+	}
+
+	void SpriteBatch::Init(PipelineCache* cache, VkRenderPass renderPass, u32 capacity) {
+		textureSets = std::make_unique<TextureSetCache>(MAX_TEXTURES, VK_SHADER_STAGE_FRAGMENT_BIT);
+
+		Pipeline::LayoutSettings layoutSettings;
+		layoutSettings.sets.push_back(textureSets->Layout());
+		layoutSettings.ranges.push_back(VkPushConstantRange{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(mat4) });
+
+		Shader vertShader{ "Shaders\\sprite.vert.spv", VK_SHADER_STAGE_VERTEX_BIT };
+		Shader fragShader{ "Shaders\\sprite.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT };
+
+		for (usize i = 0; i < pipelines.size(); i++) {
+			auto settings = GraphicsPipeline::DefaultSettings<SpriteInstance>(vertShader, fragShader, renderPass);
+			settings.blending.attachments[0] = BlendState(static_cast<Blend>(i));
+
+			pipelines[i] = std::make_unique<GraphicsPipeline>(layoutSettings, settings, cache);
+		}
+
+		instanceBuffers.resize(vk::MAX_FRAMES_IN_FLIGHT);
+		for (uint32_t i = 0; i < vk::MAX_FRAMES_IN_FLIGHT; i++) {
+			Reserve(i, capacity);
+		}
+
+		instances.reserve(capacity);
+		order.reserve(capacity);
+	}
+
+	void SpriteBatch::Draw(
+		const Texture& texture,
+		vec2 pos, vec2 size,
+		vec4 rect,
+		u32 tint,
+		f32 layer,
+		Blend blend
+	) {
+		const u64 key = (static_cast<u64>(SortableFloat(layer)) << 32)
+			| (static_cast<u64>(blend) << 24)
+			| TextureSlot(texture);
+
+		order.push_back(SortEntry{ key, static_cast<u32>(instances.size()) });
+		instances.push_back(SpriteInstance{ pos, size, rect, tint });
+	}
+
+	void SpriteBatch::Draw(
+		const TextureAtlas& atlas,
+		const TextureAtlas::Region& region,
+		vec2 pos,
+		u32 tint,
+		f32 layer,
+		Blend blend
+	) {
+		Draw(atlas.Page(region.page), pos, static_cast<vec2>(region.size), region.rect, tint, layer, blend);
+	}
+
+	void SpriteBatch::Render(VkCommandBuffer commandBuffer, uint32_t frameIndex, const mat4& viewProj) {
+		PROFILE_FUNCTION();
+		const f64 start = global.time->CurrentTime();
+
+		stats = Stats{};
+		stats.sprites = static_cast<u32>(instances.size());
+		stats.textures = static_cast<u32>(textures.size());
+
+		if (instances.empty()) {
+			return;
+		}
+
+		//Index breaks ties so sprites in the same batch keep their submission order
+		std::sort(order.begin(), order.end(), [](const SortEntry& a, const SortEntry& b) {
+			return a.key < b.key || (a.key == b.key && a.index < b.index);
+		});
+
+		Reserve(frameIndex, stats.sprites);
+
+		Buffer& instanceBuffer = *instanceBuffers[frameIndex];
+		SpriteInstance* mapped = static_cast<SpriteInstance*>(instanceBuffer.GetMappedMemory());
+		for (u32 i = 0; i < stats.sprites; i++) {
+			mapped[i] = instances[order[i].index];
+		}
+		instanceBuffer.Flush();
+
+		VkBuffer buffers[] = { instanceBuffer };
+		VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+
+		const u64 NONE = ~0ull;
+		const u64 BLEND_MASK = 0xFF000000ull;
+		const u64 TEXTURE_MASK = 0x00FFFFFFull;
+
+		u64 boundBlend = NONE, boundTexture = NONE;
+		u32 first = 0;
+		while (first < stats.sprites) {
+			const u64 key = order[first].key;
+
+			u32 last = first + 1;
+			while (last < stats.sprites && order[last].key == key) {
+				last++;
+			}
+
+			if ((key & BLEND_MASK) != boundBlend) {
+				boundBlend = key & BLEND_MASK;
+
+				GraphicsPipeline& pipeline = *pipelines[boundBlend >> 24];
+				pipeline.Bind(commandBuffer);
+				vkCmdPushConstants(
+					commandBuffer, pipeline.GetLayout(),
+					VK_SHADER_STAGE_VERTEX_BIT,
+					0, sizeof(mat4), &viewProj
+				);
+			}
+
+			if ((key & TEXTURE_MASK) != boundTexture) {
+				boundTexture = key & TEXTURE_MASK;
+
+				VkDescriptorSet set = textureSets->Get(*textures[boundTexture]);
+				vkCmdBindDescriptorSets(
+					commandBuffer,
+					VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines[0]->GetLayout(),
+					0,
+					1, &set,
+					0, nullptr
+				);
+			}
+
+			vkCmdDraw(commandBuffer, 6, last - first, 0, first);
+			stats.drawCalls++;
+
+			first = last;
+		}
+
+		instances.clear();
+		order.clear();
+		textures.clear();
+		textureSlots.clear();
+
+		stats.cpuTime = global.time->CurrentTime() - start;
+	}
+
+	u32 SpriteBatch::TextureSlot(const Texture& texture) {
+		auto [it, inserted] = textureSlots.try_emplace(&texture, static_cast<u32>(textures.size()));
+		if (inserted) {
+			textures.push_back(&texture);
+		}
+		return it->second;
+	}
+
+	void SpriteBatch::Reserve(uint32_t frameIndex, u32 count) {
+		auto& buffer = instanceBuffers[frameIndex];
+		if (buffer && buffer->InstanceCount() >= count) {
+			return;
+		}
+
+		//The previous submit using this frame index has already finished when the frame begins
+		u32 capacity = buffer ? static_cast<u32>(buffer->InstanceCount()) : math::Max(count, 1u);
+		while (capacity < count) {
+			capacity *= 2;
+		}
+
+		buffer = std::make_unique<Buffer>(
+			sizeof(SpriteInstance),
+			capacity,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			vk::QueueFamilies::Graphics
+		);
+		buffer->Map();
+	}
+}
\ No newline at end of file
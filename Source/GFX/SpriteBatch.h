@@ -0,0 +1,81 @@
+#pragma once
+
+#include "GraphicsPipeline.h"
+#include "Buffer.h"
+#include "TextureSets.h"
+#include "TextureAtlas.h"
+
+namespace gfx {
+
+	//Queues sprites during the frame and draws them with one instanced draw per run of sprites
+	//that share a layer, blend mode and texture. Instance data is written into a persistently
+	//mapped buffer per frame in flight that grows when a frame queues more sprites than it holds.
+	class SpriteBatch {
+	public:
+		enum class Blend : u8 {
+			Alpha,
+			Additive,
+			Count
+		};
+
+		struct Stats {
+			u32 sprites = 0;
+			u32 drawCalls = 0;
+			u32 textures = 0;
+			f64 cpuTime = 0.0; //Sorting, writing instances and recording, in ms
+		};
+
+		static constexpr u32 DEFAULT_CAPACITY = 16384;
+		static constexpr u32 MAX_TEXTURES = 256; //Descriptor sets per pool, more textures than that start another
+
+		void Init(PipelineCache* cache, VkRenderPass renderPass, u32 capacity = DEFAULT_CAPACITY);
+
+		//Lower layers are drawn first, sprites inside a layer are reordered to batch by blend mode and texture.
+		//The texture needs a sampler and has to stay alive until the frame is done on the GPU
+		void Draw(
+			const Texture& texture,
+			vec2 pos, vec2 size,
+			vec4 rect = vec4{ 0.f, 0.f, 1.f, 1.f },
+			u32 tint = 0xFFFFFFFF,
+			f32 layer = 0.f,
+			Blend blend = Blend::Alpha
+		);
+
+		//Draws an atlas region at its size in pixels
+		void Draw(
+			const TextureAtlas& atlas,
+			const TextureAtlas::Region& region,
+			vec2 pos,
+			u32 tint = 0xFFFFFFFF,
+			f32 layer = 0.f,
+			Blend blend = Blend::Alpha
+		);
+
+		//Sorts everything queued since the last call and records it into commandBuffer, which has to be inside a render pass
+		void Render(VkCommandBuffer commandBuffer, uint32_t frameIndex, const mat4& viewProj);
+
+		inline usize Pending() const { return instances.size(); }
+		inline const Stats& LastStats() const { return stats; }
+
+	private:
+		struct SortEntry {
+			u64 key;
+			u32 index;
+		};
+
+		u32 TextureSlot(const Texture& texture);
+		void Reserve(uint32_t frameIndex, u32 count);
+
+		std::array<std::unique_ptr<GraphicsPipeline>, static_cast<usize>(Blend::Count)> pipelines;
+		std::unique_ptr<TextureSetCache> textureSets;
+
+		std::vector<std::unique_ptr<Buffer>> instanceBuffers;
+
+		std::vector<SpriteInstance> instances;
+		std::vector<SortEntry> order;
+		std::vector<const Texture*> textures;
+		std::unordered_map<const Texture*, u32> textureSlots;
+
+		Stats stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "SpriteBenchmark.h"
+#include "Renderer.h"
+#include "Util\Time.h"
+#include "State.h"
+
+namespace gfx {
+
+	SpriteBenchmark::SpriteBenchmark(u32 count) {
+		Texture::SamplerSettings samplerSettings{};
+		samplerSettings.filter = VK_FILTER_NEAREST;
+		samplerSettings.enableAnisotropy = VK_FALSE;
+
+		//Checkerboards with a different color each, so batches are easy to tell apart
+		const std::array<u32, NUM_TEXTURES> colors = { 0xFF3030E0, 0xFF30E030, 0xFFE03030, 0xFF30E0E0 };
+
+		std::vector<u32> pixels(TEXTURE_SIZE * TEXTURE_SIZE);
+		for (u32 i = 0; i < NUM_TEXTURES; i++) {
+			for (u32 y = 0; y < TEXTURE_SIZE; y++) {
+				for (u32 x = 0; x < TEXTURE_SIZE; x++) {
+					pixels[y * TEXTURE_SIZE + x] = ((x / 4 + y / 4) & 1) ? colors[i] : 0xFFFFFFFF;
+				}
+			}
+
+			auto& texture = textures.emplace_back(std::make_unique<Texture>(
+				VK_FORMAT_R8G8B8A8_SRGB,
+				VkExtent3D{ TEXTURE_SIZE, TEXTURE_SIZE, 1 },
+				VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+				1u, 1u,
+				VK_SAMPLE_COUNT_1_BIT,
+				true,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				vk::QueueFamilies::Graphics,
+				VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				samplerSettings
+			));
+
+			global.renderer->GetUploader().UploadImage(*texture, pixels.data(), pixels.size() * sizeof(u32));
+		}
+
+		std::mt19937 rng(1234);
+		std::uniform_real_distribution<f32> unit(0.f, 1.f);
+		std::uniform_int_distribution<u32> texture(0, NUM_TEXTURES - 1);
+		std::uniform_int_distribution<u32> layer(0, NUM_LAYERS - 1);
+
+		bodies.resize(count);
+		for (auto& body : bodies) {
+			body.pos = vec2{ unit(rng), unit(rng) } * 512.f;
+			body.vel = (vec2{ unit(rng), unit(rng) } - vec2{ 0.5f }) * 400.f;
+			body.texture = texture(rng);
+			body.tint = 0xFF000000 | (rng() & 0x00FFFFFF);
+			body.layer = static_cast<f32>(layer(rng));
+			body.blend = unit(rng) < 0.1f ? SpriteBatch::Blend::Additive : SpriteBatch::Blend::Alpha;
+		}
+
+		lastUpdate = lastReport = global.time->CurrentTime();
+
+		LOGNG(util::Logger::GFX, "Sprite benchmark running with $ sprites.", count);
+	}
+
+	void SpriteBenchmark::Update(SpriteBatch& batch, vec2 bounds) {
+		const f64 now = global.time->CurrentTime();
+		const f32 dt = static_cast<f32>(now - lastUpdate) / 1000.f;
+		lastUpdate = now;
+
+		//Stats of the frame that was just rendered
+		const SpriteBatch::Stats& last = batch.LastStats();
+		frames++;
+		sprites += last.sprites;
+		drawCalls += last.drawCalls;
+		cpuTime += last.cpuTime;
+
+		if (now - lastReport >= 1000.0) {
+			const f64 seconds = (now - lastReport) / 1000.0;
+			LOGNG(util::Logger::GFX,
+				"Sprites: $/s, $ draw calls/frame, $ms SpriteBatch CPU/frame, $ FPS",
+				static_cast<u64>(sprites / seconds),
+				static_cast<f64>(drawCalls) / frames,
+				cpuTime / frames,
+				frames / seconds);
+
+			lastReport = now;
+			frames = sprites = drawCalls = 0;
+			cpuTime = 0.0;
+		}
+
+		const vec2 max = bounds - vec2{ SPRITE_SIZE };
+		for (auto& body : bodies) {
+			body.pos += body.vel * dt;
+
+			if (body.pos.x < 0.f || body.pos.x > max.x) {
+				body.vel.x = -body.vel.x;
+				body.pos.x = math::Clamp(body.pos.x, 0.f, max.x);
+			}
+			if (body.pos.y < 0.f || body.pos.y > max.y) {
+				body.vel.y = -body.vel.y;
+				body.pos.y = math::Clamp(body.pos.y, 0.f, max.y);
+			}
+
+			batch.Draw(
+				*textures[body.texture],
+				body.pos, vec2{ SPRITE_SIZE },
+				vec4{ 0.f, 0.f, 1.f, 1.f },
+				body.tint,
+				body.layer,
+				body.blend
+			);
+		}
+	}
+}
\ No newline at end of file
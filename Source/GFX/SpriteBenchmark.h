@@ -0,0 +1,38 @@
+#pragma once
+
+#include "SpriteBatch.h"
+
+namespace gfx {
+
+	//Stress scene for SpriteBatch, enabled with spriteBenchmark under [Debug] in the config.
+	//Bounces sprites across a few textures, layers and blend modes and logs sprites/sec,
+	//draw calls and SpriteBatch CPU time once a second
+	class SpriteBenchmark {
+	public:
+		static constexpr u32 NUM_TEXTURES = 4;
+		static constexpr u32 NUM_LAYERS = 4;
+		static constexpr u32 TEXTURE_SIZE = 16;
+		static constexpr f32 SPRITE_SIZE = 16.f;
+
+		SpriteBenchmark(u32 count);
+
+		//Queues every sprite for this frame, call before SpriteBatch::Render
+		void Update(SpriteBatch& batch, vec2 bounds);
+
+	private:
+		struct Body {
+			vec2 pos, vel;
+			u32 texture;
+			u32 tint;
+			f32 layer;
+			SpriteBatch::Blend blend;
+		};
+
+		std::vector<Body> bodies;
+		std::vector<std::unique_ptr<Texture>> textures;
+
+		f64 lastUpdate, lastReport;
+		u64 frames = 0, sprites = 0, drawCalls = 0;
+		f64 cpuTime = 0.0;
+	};
+}
\ No newline at end of file
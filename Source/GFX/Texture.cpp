@@ -3,34 +3,24 @@
 #include "State.h"
 #include "Util\File.h"
 #define STB_IMAGE_IMPLEMENTATION
+//Images are decoded on the workers, stbi_failure_reason() has to be per thread
+#define STBI_THREAD_LOCAL thread_local
 //#include "Util\STBImage.h"
 #include "stb_image.h"
 #include "Buffer.h"
-
-static void GetTransitionInfo(VkImageLayout layout, VkAccessFlags& access, VkPipelineStageFlags& stages) {
-	if (layout == VK_IMAGE_LAYOUT_UNDEFINED) {
-		access = 0;
-		stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-	}
-	else if (layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
-		access = VK_ACCESS_TRANSFER_READ_BIT;
-		stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
-	}
-	else if (layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-		access = VK_ACCESS_TRANSFER_WRITE_BIT;
-		stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
-	}
-	else if (layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-		access = VK_ACCESS_SHADER_READ_BIT;
-		stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
-	}
-	else {
-		WARN("Unsupported layout transition ($)!", layout);
-	}
-}
+#include "Renderer.h"
+#include "TextureBatch.h"
+#include "Util\JobSystem.h"
+#include "Util\MappedFile.h"
+#include "TextureContainer.h"
 
 namespace gfx {
 
+	u64 Texture::NextId() {
+		static std::atomic<u64> next{ 1 };
+		return next.fetch_add(1, std::memory_order_relaxed);
+	}
+
 	Texture::Texture(
 		VkFormat format,
 		VkExtent3D extent,
@@ -123,6 +113,9 @@ namespace gfx {
 	}
 
 	Texture& Texture::operator=(const Texture& other) {
+		global.renderer->GetUploader().Wait(other.uploadTicket);
+
+		id = NextId();
 		format = other.format;
 		extent = other.extent;
 		layout = other.layout;
@@ -137,8 +130,7 @@ namespace gfx {
 
 		if (image) {
 			vkDestroyImageView(*global.platform->device, imageView, nullptr);
-			vkFreeMemory(*global.platform->device, memory, nullptr);
-			vkDestroyImage(*global.platform->device, image, nullptr);
+			global.platform->device->DestroyImage(image, memory);
 
 			if (sampler) {
 				vkDestroySampler(*global.platform->device, sampler, nullptr);
@@ -203,101 +195,15 @@ namespace gfx {
 				"Failed to create texture sampler!");
 		}
 
+		//Copy every level, both images end up in the other texture's layout
 		auto commandBuffer =
 			global.platform->device->BeginSingleTime();
 
-		//Transition both images
-		VkImageMemoryBarrier barrier{};
-		barrier.image = image;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.subresourceRange.aspectMask = ImageAspect();
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = layers;
-		barrier.subresourceRange.baseMipLevel = 0;
-		barrier.subresourceRange.levelCount = levels;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.srcAccessMask = 0;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-		vkCmdPipelineBarrier(
-			commandBuffer,
-			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-			VK_PIPELINE_STAGE_TRANSFER_BIT,
-			0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier
-		);
-
-		VkAccessFlags access;
-		VkPipelineStageFlags stage;
-		GetTransitionInfo(other.layout, access, stage);
-
-		barrier.image = other.image;
-		barrier.oldLayout = other.layout;
-		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-		barrier.srcAccessMask = access;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-		vkCmdPipelineBarrier(
-			commandBuffer,
-			stage, VK_PIPELINE_STAGE_TRANSFER_BIT,
-			0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier
-		);
-
-		//Copy the images
-		for (uint32_t i = 0; i < levels; i++) {
-			VkImageCopy copy{};
-			copy.extent = extent;
-
-			copy.srcOffset = { 0, 0, 0 };
-			copy.srcSubresource.aspectMask = ImageAspect();
-			copy.srcSubresource.baseArrayLayer = 0;
-			copy.srcSubresource.layerCount = layers;
-			copy.srcSubresource.mipLevel = i;
-
-			copy.dstOffset = { 0, 0, 0 };
-			copy.dstSubresource.aspectMask = ImageAspect();
-			copy.dstSubresource.baseArrayLayer = 0;
-			copy.dstSubresource.layerCount = layers;
-			copy.dstSubresource.mipLevel = i;
-
-			vkCmdCopyImage(
-				commandBuffer,
-				other.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-				image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				1, &copy
-			);
-		}
-
-		//Transition them back
-		VkImageMemoryBarrier srcBarrier = barrier;
-		barrier.image = image;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.newLayout = other.layout;
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = access;
-
-		VkImageMemoryBarrier dstBarrier = srcBarrier;
-		barrier.image = other.image;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-		VkImageMemoryBarrier barriers[] = { srcBarrier, dstBarrier };
-
-		vkCmdPipelineBarrier(
-			commandBuffer,
-			VK_PIPELINE_STAGE_TRANSFER_BIT, stage,
-			0,
-			0, nullptr,
-			0, nullptr,
-			2, barriers
-		);
+		layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		TextureBatch(commandBuffer)
+			.Copy(*this, other)
+			.Transition(*this, other.layout)
+			.Record();
 
 		global.platform->device->EndSingleTime(commandBuffer);
 
@@ -312,16 +218,18 @@ namespace gfx {
 	Texture& Texture::operator=(Texture&& other) noexcept {
 		if (image) {
 			vkDestroyImageView(*global.platform->device, imageView, nullptr);
-			vkFreeMemory(*global.platform->device, memory, nullptr);
-			vkDestroyImage(*global.platform->device, image, nullptr);
+			global.platform->device->DestroyImage(image, memory);
 
 			if (sampler) {
 				vkDestroySampler(*global.platform->device, sampler, nullptr);
 			}
 		}
 
+		id = other.id;
+		other.id = NextId();
 		image = other.image;
 		memory = other.memory;
+		other.memory = platform::Allocation{};
 		imageView = other.imageView;
 		sampler = other.sampler;
 
@@ -336,6 +244,7 @@ namespace gfx {
 		memProps = other.memProps;
 		queueFamilies = other.queueFamilies;
 		samplerSettings = other.samplerSettings;
+		uploadTicket = other.uploadTicket;
 
 		other.image = VK_NULL_HANDLE;
 
@@ -345,8 +254,7 @@ namespace gfx {
 	Texture::~Texture() {
 		if (image) {
 			vkDestroyImageView(*global.platform->device, imageView, nullptr);
-			vkFreeMemory(*global.platform->device, memory, nullptr);
-			vkDestroyImage(*global.platform->device, image, nullptr);
+			global.platform->device->DestroyImage(image, memory);
 
 			if (sampler != VK_NULL_HANDLE) {
 				vkDestroySampler(*global.platform->device, sampler, nullptr);
@@ -354,6 +262,83 @@ namespace gfx {
 		}
 	}
 
+	namespace {
+		struct DecodedImage {
+			std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels{ nullptr, &stbi_image_free };
+			int width = 0, height = 0;
+			usize fileSize = 0;
+			std::string error;
+
+			f64 readTime = 0.0, decodeTime = 0.0; //In ms
+		};
+
+		//Safe to call from any thread, errors are reported back instead of raised
+		DecodedImage DecodeImage(const std::string& file) {
+			DecodedImage decoded;
+
+			const f64 start = global.time->CurrentTime();
+			auto imageData = util::ReadFileBinary(file);
+			const f64 read = global.time->CurrentTime();
+			decoded.readTime = read - start;
+
+			if (imageData.IsErr()) {
+				decoded.error = "Failed to read image file " + file + "!";
+				return decoded;
+			}
+
+			const std::vector<u8> bytes = imageData.Unwrap();
+			decoded.fileSize = bytes.size();
+
+			int comp;
+			decoded.pixels.reset(stbi_load_from_memory(
+				bytes.data(), static_cast<int>(bytes.size()),
+				&decoded.width, &decoded.height, &comp, STBI_rgb_alpha));
+			decoded.decodeTime = global.time->CurrentTime() - read;
+
+			if (!decoded.pixels) {
+				decoded.error = "Failed to load texture " + file + ": " + stbi_failure_reason() + "!";
+			}
+
+			return decoded;
+		}
+
+		std::unique_ptr<Texture> CreateTexture(
+			const DecodedImage& decoded,
+			VkImageUsageFlags usage,
+			VkMemoryPropertyFlags memProps,
+			uint32_t families,
+			b8 mipmap,
+			const std::optional<SamplerSettings>& samplerSettings
+		) {
+			uint32_t levels = 1;
+			if (mipmap) {
+				levels = static_cast<uint32_t>(math::Floor(math::Log2(
+					static_cast<f32>(math::Min(decoded.width, decoded.height))))) + 1;
+			}
+
+			VkExtent3D extent{ static_cast<uint32_t>(decoded.width), static_cast<uint32_t>(decoded.height), 1 };
+
+			auto texture = std::make_unique<Texture>(
+				VK_FORMAT_R8G8B8A8_SRGB,
+				extent,
+				VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | usage,
+				levels, 1u,
+				VK_SAMPLE_COUNT_1_BIT,
+				samplerSettings.has_value(),
+				memProps,
+				families,
+				VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				samplerSettings.value_or(SamplerSettings{})
+			);
+
+			global.renderer->GetUploader().UploadImage(
+				*texture, decoded.pixels.get(), static_cast<VkDeviceSize>(decoded.width) * decoded.height * 4);
+
+			return texture;
+		}
+	}
+
 	std::unique_ptr<Texture> Texture::Load(
 		const std::string& file,
 		VkImageUsageFlags usage,
@@ -364,43 +349,138 @@ namespace gfx {
 	) {
 		ASSERT(util::FileExists(file), "Image file " + file + " does not exist!");
 
-		const std::vector<u8> imageData = util::ReadFileBinary(file).Unwrap();
+		const DecodedImage decoded = DecodeImage(file);
+		if (!decoded.pixels) {
+			ERROR(-1, util::Logger::GFX, "$", decoded.error);
+		}
 
-		int width, height, comp;
-		stbi_uc* pixels = stbi_load_from_memory(
-			imageData.data(), static_cast<int>(imageData.size()),
-			&width, &height, &comp, STBI_rgb_alpha);
+		return CreateTexture(decoded, usage, memProps, families, mipmap, samplerSettings);
+	}
 
-		if (!pixels) {
-			ERROR(-1, util::Logger::GFX, "Failed to load texture: $!", stbi_failure_reason());
+	std::vector<std::unique_ptr<Texture>> Texture::LoadBatch(
+		const std::vector<std::string>& files,
+		VkImageUsageFlags usage,
+		VkMemoryPropertyFlags memProps,
+		uint32_t families,
+		b8 mipmap,
+		std::optional<SamplerSettings> samplerSettings
+	) {
+		const f64 start = global.time->CurrentTime();
+
+		std::vector<std::future<DecodedImage>> pending;
+		pending.reserve(files.size());
+		for (const auto& file : files) {
+			ASSERT(util::FileExists(file), "Image file " + file + " does not exist!");
+			pending.push_back(global.jobs->Submit([&file]() { return DecodeImage(file); }));
 		}
 
-		auto pixelBuffer = std::make_unique<Buffer>(
-			sizeof(stbi_uc),
-			width * height * 4,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			vk::QueueFamilies::Graphics
-			);
-		pixelBuffer->Map();
-		pixelBuffer->Write((void*)pixels);
-		pixelBuffer->UnMap();
+		//Decoding keeps running on the workers while earlier images are uploaded here
+		std::vector<std::unique_ptr<Texture>> textures;
+		textures.reserve(files.size());
+
+		f64 readTime = 0.0, decodeTime = 0.0, uploadTime = 0.0, waitTime = 0.0;
+		u64 fileBytes = 0, pixelBytes = 0;
+
+		for (auto& future : pending) {
+			const f64 waitStart = global.time->CurrentTime();
+			const DecodedImage decoded = future.get();
+			const f64 uploadStart = global.time->CurrentTime();
+			waitTime += uploadStart - waitStart;
+
+			if (!decoded.pixels) {
+				ERROR(-1, util::Logger::GFX, "$", decoded.error);
+			}
+
+			textures.push_back(CreateTexture(decoded, usage, memProps, families, mipmap, samplerSettings));
+
+			uploadTime += global.time->CurrentTime() - uploadStart;
+			readTime += decoded.readTime;
+			decodeTime += decoded.decodeTime;
+			fileBytes += decoded.fileSize;
+			pixelBytes += static_cast<u64>(decoded.width) * decoded.height * 4;
+		}
+
+		const f64 totalTime = global.time->CurrentTime() - start;
+		const f64 pixelMiB = static_cast<f64>(pixelBytes) / (1024.0 * 1024.0);
+
+		//Read and decode times are summed over all workers, upload and wait are on this thread
+		LOGNG(util::Logger::GFX,
+			"Loaded $ textures ($ MiB read, $ MiB decoded) in $ms on $ workers: read $ms, decode $ms ($ MiB/s per worker), "
+			"upload $ms ($ MiB/s), waited on decode $ms",
+			textures.size(), static_cast<f64>(fileBytes) / (1024.0 * 1024.0), pixelMiB, totalTime, global.jobs->NumWorkers(),
+			readTime, decodeTime, decodeTime > 0.0 ? pixelMiB / (decodeTime / 1000.0) : 0.0,
+			uploadTime, uploadTime > 0.0 ? pixelMiB / (uploadTime / 1000.0) : 0.0,
+			waitTime);
+
+		return textures;
+	}
+
+	std::unique_ptr<Texture> Texture::LoadContainer(
+		const std::string& file,
+		VkImageUsageFlags usage,
+		VkMemoryPropertyFlags memProps,
+		uint32_t families,
+		std::optional<SamplerSettings> samplerSettings
+	) {
+		using Header = TextureContainer::Header;
+
+		util::MappedFile mapped;
+		if (auto error = mapped.Open(file)) {
+			ERROR(-1, util::Logger::GFX, "$", *error);
+		}
+
+		if (mapped.Size() < sizeof(Header)) {
+			ERROR(-1, util::Logger::GFX, "Texture container $ is truncated!", file);
+		}
 
-		stbi_image_free(pixels);
+		Header header;
+		std::memcpy(&header, mapped.Data(), sizeof(Header));
 
-		uint32_t levels = 1;
-		if (mipmap) {
-			levels = static_cast<uint32_t>(math::Floor(math::Log2(
-				static_cast<f32>(math::Min(width, height))))) + 1;
+		if (header.magic != TextureContainer::MAGIC || header.version != TextureContainer::VERSION) {
+			ERROR(-1, util::Logger::GFX, "$ is not a version $ texture container, rebake it with --bake!",
+				file, TextureContainer::VERSION);
 		}
 
-		VkExtent3D extent{ static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1 };
+		//Everything is checked against what's left of the file one piece at a time, so no sum or product can wrap.
+		//Extents past the device limits couldn't be created anyway and keep TexelCount() from overflowing
+		const VkPhysicalDeviceLimits limits = global.platform->device->Limits();
+		const u32 maxExtent = header.depth > 1 ? limits.maxImageDimension3D : limits.maxImageDimension2D;
+		b8 valid = header.width > 0 && header.width <= maxExtent
+			&& header.height > 0 && header.height <= maxExtent
+			&& header.depth > 0 && header.depth <= maxExtent
+			&& header.levels > 0 && header.levels <= 32
+			&& header.layers > 0 && header.layers <= limits.maxImageArrayLayers;
+
+		const b8 palette = header.encoding == TextureContainer::Encoding::Palette;
+		const usize paletteBytes = static_cast<usize>(header.paletteSize) * sizeof(u32);
+		const usize available = mapped.Size() - sizeof(Header);
+		valid = valid && paletteBytes <= available && header.dataSize <= available - paletteBytes;
+
+		const u64 texels = valid ? TextureContainer::TexelCount(header) : 0;
+		const u64 formatSize = vk::FormatSize(header.format);
+		if (palette) {
+			valid = valid
+				&& (header.format == VK_FORMAT_R8G8B8A8_SRGB || header.format == VK_FORMAT_R8G8B8A8_UNORM)
+				&& header.paletteSize <= TextureContainer::MAX_PALETTE_SIZE
+				&& header.dataSize == texels;
+		}
+		else {
+			valid = valid && formatSize > 0
+				&& texels <= header.dataSize / formatSize
+				&& header.dataSize == texels * formatSize;
+		}
+
+		if (!valid) {
+			ERROR(-1, util::Logger::GFX, "Texture container $ is corrupt!", file);
+		}
+
+		VkExtent3D extent{ header.width, header.height, header.depth };
 
 		auto texture = std::make_unique<Texture>(
-			VK_FORMAT_R8G8B8A8_SRGB,
+			header.format,
 			extent,
 			VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | usage,
-			levels, 1u,
+			header.levels, header.layers,
 			VK_SAMPLE_COUNT_1_BIT,
 			samplerSettings.has_value(),
 			memProps,
@@ -410,17 +490,28 @@ namespace gfx {
 			samplerSettings.value_or(SamplerSettings{})
 		);
 
-		texture->TransitionLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+		Uploader& uploader = global.renderer->GetUploader();
 
-		global.platform->device->CopyBufferToImage(*pixelBuffer, *texture, extent, texture->ImageAspect());
+		const VkDeviceSize size = texels * formatSize;
+		const Uploader::Staging staging = uploader.Stage(size);
+		const u8* data = mapped.Data() + sizeof(Header) + paletteBytes;
 
-		if (mipmap) {
-			texture->FillMipmaps(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		if (palette) {
+			std::array<u32, TextureContainer::MAX_PALETTE_SIZE> colors{};
+			std::memcpy(colors.data(), mapped.Data() + sizeof(Header), paletteBytes);
+
+			u32* dst = reinterpret_cast<u32*>(staging.data);
+			for (u64 i = 0; i < texels; i++) {
+				dst[i] = colors[data[i]];
+			}
 		}
 		else {
-			texture->TransitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+			//Levels are already laid out the way the copy expects them
+			std::memcpy(staging.data, data, size);
 		}
 
+		uploader.CopyToImage(staging, *texture, header.levels);
+
 		return texture;
 	}
 
@@ -428,148 +519,30 @@ namespace gfx {
 		auto commandBuffer =
 			global.platform->device->BeginSingleTime();
 
-		VkImageMemoryBarrier barrier{};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.image = image;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.subresourceRange.aspectMask = ImageAspect();
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = layers;
-		barrier.subresourceRange.baseMipLevel = 0;
-		barrier.subresourceRange.levelCount = levels;
-
-		barrier.oldLayout = layout;
-		barrier.newLayout = newLayout;
-		
-		VkAccessFlags srcAccess, dstAccess;
-		VkPipelineStageFlags srcStages, dstStages;
-		GetTransitionInfo(layout, srcAccess, srcStages);
-		GetTransitionInfo(newLayout, dstAccess, dstStages);
-
-		barrier.srcAccessMask = srcAccess;
-		barrier.dstAccessMask = dstAccess;
-
-		vkCmdPipelineBarrier(
-			commandBuffer,
-			srcStages, dstStages,
-			0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier
-		);
+		TransitionLayout(commandBuffer, newLayout);
 
 		global.platform->device->EndSingleTime(commandBuffer);
 	}
 
-	void Texture::FillMipmaps(VkImageLayout dstLayout) {
-		VkFormatProperties props;
-		vkGetPhysicalDeviceFormatProperties(global.platform->device->PhysicalDevice(), format, &props);
-
-		ASSERT(props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT, "Format doesn't support linear blitting!");
+	void Texture::TransitionLayout(VkCommandBuffer commandBuffer, VkImageLayout newLayout) {
+		TextureBatch(commandBuffer)
+			.Transition(*this, newLayout)
+			.Record();
+	}
 
+	void Texture::FillMipmaps(VkImageLayout dstLayout) {
 		auto commandBuffer = global.platform->device->BeginSingleTime();
 
-		VkImageMemoryBarrier barrier{};
-		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-		barrier.image = image;
-		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-		barrier.subresourceRange.aspectMask = ImageAspect();
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = layers;
-		barrier.subresourceRange.levelCount = 1;
-
-		int32_t mipWidth = extent.width;
-		int32_t mipHeight = extent.height;
-		int32_t mipDepth = extent.depth;
-
-		VkAccessFlags access;
-		VkPipelineStageFlags stages;
-		GetTransitionInfo(dstLayout, access, stages);
-
-		for (uint32_t i = 1; i < levels; i++) {
-			//Transition the previous level to optimal as src for transfer
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.subresourceRange.baseMipLevel = i - 1;
-
-			vkCmdPipelineBarrier(
-				commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
-				0,
-				0, nullptr,
-				0, nullptr,
-				1, &barrier
-			);
-
-			//Blit from level i - 1 to i
-			VkImageBlit blit{};
-			blit.srcOffsets[0] = { 0, 0, 0 };
-			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-			blit.srcSubresource.aspectMask = ImageAspect();
-			blit.srcSubresource.baseArrayLayer = 0;
-			blit.srcSubresource.layerCount = layers;
-			blit.srcSubresource.mipLevel = i - 1;
-			blit.dstOffsets[0] = { 0, 0, 0 };
-			blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1,
-				mipHeight > 1 ? mipHeight / 2 : 1,
-				mipDepth > 1 ? mipDepth : 1 };
-			blit.dstSubresource.aspectMask = ImageAspect();
-			blit.dstSubresource.baseArrayLayer = 0;
-			blit.dstSubresource.layerCount = layers;
-			blit.dstSubresource.mipLevel = i;
-
-			vkCmdBlitImage(
-				commandBuffer,
-				image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-				image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-				1, &blit,
-				VK_FILTER_LINEAR
-			);
-
-			//Transition the previous level to dstLayout
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-			barrier.dstAccessMask = access;
-			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-			barrier.newLayout = dstLayout;
-			barrier.subresourceRange.baseMipLevel = i - 1;
-
-			vkCmdPipelineBarrier(
-				commandBuffer,
-				VK_PIPELINE_STAGE_TRANSFER_BIT, stages,
-				0,
-				0, nullptr,
-				0, nullptr,
-				1, &barrier
-			);
-
-			if (mipWidth > 1) mipWidth /= 2;
-			if (mipHeight > 1) mipHeight /= 2;
-			if (mipDepth > 1) mipDepth /= 2;
-		}
-
-		//Transition the final layout to dstLayout (never blitted from)
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = access;
-		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		barrier.newLayout = dstLayout;
-		barrier.subresourceRange.baseMipLevel = levels - 1;
-
-		vkCmdPipelineBarrier(
-			commandBuffer,
-			VK_PIPELINE_STAGE_TRANSFER_BIT, stages,
-			0,
-			0, nullptr,
-			0, nullptr,
-			1, &barrier
-		);
+		FillMipmaps(commandBuffer, dstLayout);
 
 		global.platform->device->EndSingleTime(commandBuffer);
+	}
 
-		layout = dstLayout;
+	//Expects level 0 to be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+	void Texture::FillMipmaps(VkCommandBuffer commandBuffer, VkImageLayout dstLayout) {
+		TextureBatch(commandBuffer)
+			.GenerateMipmaps(*this, dstLayout)
+			.Record();
 	}
 
 	VkDescriptorImageInfo Texture::DescriptorInfo() const {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Platform\Device.h"
+#include "Uploader.h"
 
 namespace gfx {
 
@@ -49,6 +50,8 @@ namespace gfx {
 		//Getters and setters
 		inline operator VkImage() const { return image; }
 		inline VkImage Image() const { return image; }
+		//Unique for every image a texture holds, unlike its handles which the driver can hand out again
+		inline u64 Id() const { return id; }
 		inline VkImageView ImageView() const { return imageView; }
 		inline VkSampler Sampler() const { return sampler; }
 		inline VkFormat Format() const { return format; }
@@ -61,6 +64,18 @@ namespace gfx {
 		inline uint32_t MipLevels() const { return levels; }
 		inline uint32_t ArrayLayers() const { return layers; }
 		inline VkSampleCountFlagBits NumSamples() const { return samples; }
+		inline uint32_t QueueFamilies() const { return queueFamilies; }
+
+		//Tightly packed size of a mip level (all layers) in bytes
+		inline VkDeviceSize LevelSize(uint32_t level) const {
+			return static_cast<VkDeviceSize>(math::Max(extent.width >> level, 1u))
+				* math::Max(extent.height >> level, 1u)
+				* math::Max(extent.depth >> level, 1u)
+				* layers * vk::FormatSize(format);
+		}
+
+		//Ticket of the upload that fills this texture, it shouldn't be sampled before it completes
+		inline Uploader::Ticket UploadTicket() const { return uploadTicket; }
 
 		inline VkImageType ImageType() const {
 			return (extent.depth == 1) ? VK_IMAGE_TYPE_2D
@@ -99,14 +114,42 @@ namespace gfx {
 			std::optional<SamplerSettings> samplerSettings = SamplerSettings{}
 		);
 
+		//Reads and decodes every file in parallel on the worker pool, textures are created and
+		//queued for upload on the calling thread in the same order as files
+		static std::vector<std::unique_ptr<Texture>> LoadBatch(
+			const std::vector<std::string>& files,
+			VkImageUsageFlags usage,
+			VkMemoryPropertyFlags memProps,
+			uint32_t families,
+			b8 mipmap = true,
+			std::optional<SamplerSettings> samplerSettings = SamplerSettings{}
+		);
+
+		//Maps a baked .ptex container (see TextureContainer) and copies every mip level
+		//straight into staging memory, no decoding or mip generation at runtime
+		static std::unique_ptr<Texture> LoadContainer(
+			const std::string& file,
+			VkImageUsageFlags usage,
+			VkMemoryPropertyFlags memProps,
+			uint32_t families,
+			std::optional<SamplerSettings> samplerSettings = SamplerSettings{}
+		);
+
 		void TransitionLayout(VkImageLayout newLayout);
 		void FillMipmaps(VkImageLayout newLayout);
 
+		//Record into an existing command buffer instead of a single-time one
+		void TransitionLayout(VkCommandBuffer commandBuffer, VkImageLayout newLayout);
+		void FillMipmaps(VkCommandBuffer commandBuffer, VkImageLayout newLayout);
+
 		VkDescriptorImageInfo DescriptorInfo() const;
 
 	private:
+		static u64 NextId();
+
+		u64 id = NextId();
 		VkImage image;
-		VkDeviceMemory memory;
+		platform::Allocation memory;
 		VkImageView imageView;
 		VkSampler sampler = VK_NULL_HANDLE;
 
@@ -121,5 +164,10 @@ namespace gfx {
 		VkMemoryPropertyFlags memProps;
 		uint32_t queueFamilies;
 		std::optional<SamplerSettings> samplerSettings;
+
+		Uploader::Ticket uploadTicket = 0;
+
+		friend Uploader;
+		friend class TextureBatch;
 	};
 }
\ No newline at end of file
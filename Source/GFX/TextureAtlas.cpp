@@ -0,0 +1,364 @@
+#include "TextureAtlas.h"
+#include "TextureContainer.h"
+#include "Renderer.h"
+#include "State.h"
+#include "Util\Configuration.h"
+#include "Util\File.h"
+#include "Util\Time.h"
+#include "Util\JobSystem.h"
+#include "stb_image.h"
+
+namespace gfx {
+
+	namespace {
+		Texture::SamplerSettings PageSampler() {
+			Texture::SamplerSettings settings{};
+			settings.addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			settings.filter = VK_FILTER_NEAREST;
+			settings.enableAnisotropy = VK_FALSE;
+			settings.mipMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+			return settings;
+		}
+
+		std::unique_ptr<Texture> CreatePage(u32 pageSize) {
+			return std::make_unique<Texture>(
+				VK_FORMAT_R8G8B8A8_SRGB,
+				VkExtent3D{ pageSize, pageSize, 1 },
+				VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+				1u, 1u,
+				VK_SAMPLE_COUNT_1_BIT,
+				true,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				vk::QueueFamilies::Graphics,
+				VK_IMAGE_TILING_OPTIMAL,
+				VK_IMAGE_LAYOUT_UNDEFINED,
+				PageSampler()
+			);
+		}
+
+		//Repeats the edge texels into the padding so filtering never picks up a neighbouring image
+		std::vector<u32> Extrude(const u32* pixels, uvec2 size, u32 padding) {
+			const uvec2 padded = size + uvec2{ 2 * padding };
+
+			std::vector<u32> block(static_cast<usize>(padded.x) * padded.y);
+			for (u32 y = 0; y < padded.y; y++) {
+				const u32 sy = math::Clamp(y, padding, padding + size.y - 1) - padding;
+				for (u32 x = 0; x < padded.x; x++) {
+					const u32 sx = math::Clamp(x, padding, padding + size.x - 1) - padding;
+					block[static_cast<usize>(y) * padded.x + x] = pixels[static_cast<usize>(sy) * size.x + sx];
+				}
+			}
+
+			return block;
+		}
+	}
+
+	TextureAtlas::TextureAtlas(u32 pageSize, u32 padding)
+		: pageSize(pageSize), padding(padding) { }
+
+	std::string TextureAtlas::LayoutPath() {
+		return std::filesystem::path(global.config->pipelineCache).replace_filename("atlas.layout").generic_string();
+	}
+
+	std::string TextureAtlas::PagePath(const std::string& layoutFile, u32 page) {
+		std::filesystem::path path(layoutFile);
+		const std::string stem = path.stem().string();
+		return path.replace_filename(stem + std::to_string(page) + TextureContainer::EXTENSION).generic_string();
+	}
+
+	TextureAtlas::Region TextureAtlas::MakeRegion(u32 page, uvec2 pos, uvec2 size) const {
+		const f32 scale = 1.f / static_cast<f32>(pageSize);
+
+		Region region;
+		region.page = page;
+		region.pos = pos;
+		region.size = size;
+		region.rect = vec4{
+			static_cast<f32>(pos.x) * scale,
+			static_cast<f32>(pos.y) * scale,
+			static_cast<f32>(pos.x + size.x) * scale,
+			static_cast<f32>(pos.y + size.y) * scale
+		};
+		return region;
+	}
+
+	void TextureAtlas::LoadOrBuild(const std::string& directory) {
+		const std::string layoutFile = LayoutPath();
+
+		//Adding or removing a file touches the directory itself
+		b8 upToDate = util::FileExists(layoutFile)
+			&& std::filesystem::last_write_time(directory) <= std::filesystem::last_write_time(layoutFile);
+
+		if (upToDate) {
+			const auto layoutTime = std::filesystem::last_write_time(layoutFile);
+			for (const auto& file : util::ListFiles(directory).UnwrapOr({})) {
+				if (TextureContainer::IsSourceImage(file) && std::filesystem::last_write_time(file) > layoutTime) {
+					upToDate = false;
+					break;
+				}
+			}
+		}
+
+		if (!upToDate || !Load(layoutFile)) {
+			if (auto error = Build(directory, layoutFile, pageSize, padding)) {
+				ERROR(-1, util::Logger::GFX, "$", *error);
+			}
+
+			if (!Load(layoutFile)) {
+				ERROR(-1, util::Logger::GFX, "Failed to load texture atlas $!", layoutFile);
+			}
+		}
+
+		LOGNG(util::Logger::GFX, "Texture atlas has $ regions on $ pages.", regions.size(), pages.size());
+	}
+
+	b8 TextureAtlas::Load(const std::string& layoutFile) {
+		pages.clear();
+		regions.clear();
+
+		auto text = util::ReadFile(layoutFile);
+		if (text.IsErr()) {
+			return false;
+		}
+
+		std::istringstream in(text.Unwrap());
+
+		std::string tag;
+		u32 version, size, pad;
+		usize count;
+		in >> tag >> version >> size >> pad >> count;
+		if (!in || tag != "atlas" || version != LAYOUT_VERSION || size != pageSize || pad != padding) {
+			return false;
+		}
+
+		while (in >> tag) {
+			if (tag == "page") {
+				u32 index;
+				u64 usedArea;
+				usize segments;
+				in >> index >> usedArea >> segments;
+
+				std::vector<AtlasPacker::Segment> skyline(segments);
+				for (auto& segment : skyline) {
+					in >> segment.x >> segment.y >> segment.width;
+				}
+
+				const std::string pageFile = PagePath(layoutFile, index);
+				if (!in || index != pages.size() || !util::FileExists(pageFile)) {
+					return false;
+				}
+
+				pages.push_back(Page{
+					Texture::LoadContainer(
+						pageFile,
+						VK_IMAGE_USAGE_SAMPLED_BIT,
+						VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+						vk::QueueFamilies::Graphics,
+						PageSampler()
+					),
+					AtlasPacker(uvec2{ pageSize, pageSize }, std::move(skyline), usedArea)
+				});
+			}
+			else if (tag == "region") {
+				std::string name;
+				u32 page;
+				uvec2 pos, extent;
+				in >> std::quoted(name) >> page >> pos.x >> pos.y >> extent.x >> extent.y;
+
+				if (!in || page >= pages.size()) {
+					return false;
+				}
+
+				regions[name] = MakeRegion(page, pos, extent);
+			}
+			else {
+				return false;
+			}
+		}
+
+		return pages.size() == count;
+	}
+
+	std::optional<std::string> TextureAtlas::Build(
+		const std::string& directory,
+		const std::string& layoutFile,
+		u32 pageSize,
+		u32 padding
+	) {
+		const f64 start = global.time->CurrentTime();
+
+		auto files = util::ListFiles(directory);
+		if (files.IsErr()) {
+			return files.UnwrapErr();
+		}
+
+		struct Source {
+			std::string name;
+			uvec2 size;
+			std::vector<u32> pixels;
+			std::string error;
+		};
+
+		std::vector<std::future<Source>> pending;
+		for (const auto& file : files.Unwrap()) {
+			if (!TextureContainer::IsSourceImage(file)) {
+				continue;
+			}
+
+			pending.push_back(global.jobs->Submit([file]() {
+				Source source;
+				source.name = std::filesystem::path(file).stem().generic_string();
+
+				int width, height, comp;
+				stbi_uc* pixels = stbi_load(file.c_str(), &width, &height, &comp, STBI_rgb_alpha);
+				if (!pixels) {
+					source.error = "Failed to decode " + file + ": " + stbi_failure_reason();
+					return source;
+				}
+
+				source.size = uvec2{ static_cast<u32>(width), static_cast<u32>(height) };
+				source.pixels.assign(
+					reinterpret_cast<const u32*>(pixels),
+					reinterpret_cast<const u32*>(pixels) + static_cast<usize>(width) * height);
+				stbi_image_free(pixels);
+				return source;
+			}));
+		}
+
+		std::vector<Source> sources;
+		sources.reserve(pending.size());
+		for (auto& future : pending) {
+			sources.push_back(future.get());
+			if (!sources.back().error.empty()) {
+				return sources.back().error;
+			}
+		}
+
+		//Tallest first keeps the skyline flat, the name makes the result independent of directory order
+		std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+			if (a.size.y != b.size.y) return a.size.y > b.size.y;
+			if (a.size.x != b.size.x) return a.size.x > b.size.x;
+			return a.name < b.name;
+		});
+
+		std::vector<AtlasPacker> packers;
+		std::vector<std::vector<u32>> pagePixels;
+
+		std::ostringstream regionLines;
+		for (const auto& source : sources) {
+			const uvec2 padded = source.size + uvec2{ 2 * padding };
+			if (padded.x > pageSize || padded.y > pageSize) {
+				return "Image " + source.name + " doesn't fit in a " + std::to_string(pageSize) + " atlas page!";
+			}
+
+			std::optional<uvec2> pos;
+			u32 page = 0;
+			for (; page < packers.size(); page++) {
+				if ((pos = packers[page].Pack(padded))) {
+					break;
+				}
+			}
+
+			if (!pos) {
+				packers.emplace_back(uvec2{ pageSize, pageSize });
+				pagePixels.emplace_back(static_cast<usize>(pageSize) * pageSize, 0u);
+				page = static_cast<u32>(packers.size() - 1);
+				pos = packers.back().Pack(padded);
+			}
+
+			const std::vector<u32> block = Extrude(source.pixels.data(), source.size, padding);
+			for (u32 y = 0; y < padded.y; y++) {
+				std::memcpy(
+					pagePixels[page].data() + static_cast<usize>(pos->y + y) * pageSize + pos->x,
+					block.data() + static_cast<usize>(y) * padded.x,
+					padded.x * sizeof(u32));
+			}
+
+			regionLines << "region " << std::quoted(source.name) << ' ' << page << ' '
+				<< pos->x + padding << ' ' << pos->y + padding << ' '
+				<< source.size.x << ' ' << source.size.y << '\n';
+		}
+
+		//Mips would bleed neighbouring images into each other, so pages only get level 0
+		for (u32 page = 0; page < pagePixels.size(); page++) {
+			if (auto error = TextureContainer::Write(PagePath(layoutFile, page), pagePixels[page].data(), pageSize, pageSize, false)) {
+				return error;
+			}
+		}
+
+		std::ostringstream layout;
+		layout << "atlas " << LAYOUT_VERSION << ' ' << pageSize << ' ' << padding << ' ' << packers.size() << '\n';
+
+		u64 usedArea = 0;
+		for (u32 page = 0; page < packers.size(); page++) {
+			const auto& skyline = packers[page].Skyline();
+
+			layout << "page " << page << ' ' << packers[page].UsedArea() << ' ' << skyline.size();
+			for (const auto& segment : skyline) {
+				layout << ' ' << segment.x << ' ' << segment.y << ' ' << segment.width;
+			}
+			layout << '\n';
+
+			usedArea += packers[page].UsedArea();
+		}
+		layout << regionLines.str();
+
+		auto result = util::WriteFile(layoutFile, layout.str());
+		if (result.IsErr()) {
+			return result.UnwrapErr();
+		}
+
+		const f64 occupancy = packers.empty() ? 0.0
+			: static_cast<f64>(usedArea) / (static_cast<f64>(pageSize) * pageSize * packers.size());
+
+		LOGNG(util::Logger::GFX, "Packed $ images from $ into $ atlas pages ($% used) in $ms.",
+			sources.size(), directory, packers.size(), occupancy * 100.0, global.time->CurrentTime() - start);
+
+		return std::nullopt;
+	}
+
+	const TextureAtlas::Region& TextureAtlas::Add(const std::string& name, const u32* pixels, uvec2 size) {
+		if (auto it = regions.find(name); it != regions.end()) {
+			WARNNG(util::Logger::GFX, "Texture atlas already has a region named $!", name);
+			return it->second;
+		}
+
+		const uvec2 padded = size + uvec2{ 2 * padding };
+		ASSERT(padded.x <= pageSize && padded.y <= pageSize, "Image " + name + " doesn't fit in an atlas page!");
+
+		std::optional<uvec2> pos;
+		u32 page = 0;
+		for (; page < pages.size(); page++) {
+			if ((pos = pages[page].packer.Pack(padded))) {
+				break;
+			}
+		}
+
+		if (!pos) {
+			pages.push_back(Page{ CreatePage(pageSize), AtlasPacker(uvec2{ pageSize, pageSize }) });
+			page = static_cast<u32>(pages.size() - 1);
+			pos = pages.back().packer.Pack(padded);
+		}
+
+		const std::vector<u32> block = Extrude(pixels, size, padding);
+		global.renderer->GetUploader().UploadImageRegion(
+			*pages[page].texture,
+			block.data(),
+			VkOffset3D{ static_cast<int32_t>(pos->x), static_cast<int32_t>(pos->y), 0 },
+			VkExtent3D{ padded.x, padded.y, 1 }
+		);
+
+		return regions[name] = MakeRegion(page, *pos + uvec2{ padding }, size);
+	}
+
+	const TextureAtlas::Region* TextureAtlas::Find(const std::string& name) const {
+		auto it = regions.find(name);
+		return it != regions.end() ? &it->second : nullptr;
+	}
+
+	const TextureAtlas::Region& TextureAtlas::Get(const std::string& name) const {
+		const Region* region = Find(name);
+		ASSERT(region, "Texture atlas has no region named " + name + "!");
+		return *region;
+	}
+}
\ No newline at end of file
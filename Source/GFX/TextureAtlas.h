@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Texture.h"
+#include "AtlasPacker.h"
+
+namespace gfx {
+
+	//Packs many small images into a few large pages so sprites can share descriptor sets.
+	//Pages and their layout are baked offline (Build, or --atlas on the command line) as .ptex
+	//containers next to the pipeline cache, and more images can be packed in at runtime with Add.
+	class TextureAtlas {
+	public:
+		static constexpr u32 DEFAULT_PAGE_SIZE = 2048;
+		static constexpr u32 DEFAULT_PADDING = 1;
+		static constexpr u32 LAYOUT_VERSION = 1;
+
+		struct Region {
+			u32 page;
+			uvec2 pos, size; //In pixels, without padding
+			vec4 rect; //uv min in xy, uv max in zw
+		};
+
+		TextureAtlas(u32 pageSize = DEFAULT_PAGE_SIZE, u32 padding = DEFAULT_PADDING);
+
+		//Loads the baked pages if the layout is newer than every image in directory, rebuilds them otherwise
+		void LoadOrBuild(const std::string& directory);
+
+		//Packs every image in directory, writes the pages and the layout file. Returns an error message on failure
+		static std::optional<std::string> Build(
+			const std::string& directory,
+			const std::string& layoutFile,
+			u32 pageSize = DEFAULT_PAGE_SIZE,
+			u32 padding = DEFAULT_PADDING
+		);
+
+		//Packs and uploads an RGBA8 image, opening a new page if none have room. Runtime additions aren't saved
+		const Region& Add(const std::string& name, const u32* pixels, uvec2 size);
+
+		const Region* Find(const std::string& name) const;
+		const Region& Get(const std::string& name) const;
+
+		inline const Texture& Page(u32 index) const { return *pages[index].texture; }
+		inline usize PageCount() const { return pages.size(); }
+		inline usize RegionCount() const { return regions.size(); }
+
+		//Next to the pipeline cache file
+		static std::string LayoutPath();
+
+	private:
+		struct Page {
+			std::unique_ptr<Texture> texture;
+			AtlasPacker packer;
+		};
+
+		b8 Load(const std::string& layoutFile);
+		Region MakeRegion(u32 page, uvec2 paddedPos, uvec2 size) const;
+
+		static std::string PagePath(const std::string& layoutFile, u32 page);
+
+		u32 pageSize, padding;
+
+		std::vector<Page> pages;
+		std::unordered_map<std::string, Region> regions;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,401 @@
+#include "TextureBatch.h"
+#include "Texture.h"
+#include "Platform\Platform.h"
+#include "State.h"
+
+namespace gfx {
+
+	void TextureBatch::TransitionInfo(VkImageLayout layout, VkAccessFlags& access, VkPipelineStageFlags& stages) {
+		switch (layout) {
+		case VK_IMAGE_LAYOUT_UNDEFINED:
+		case VK_IMAGE_LAYOUT_PREINITIALIZED:
+			access = 0;
+			stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			break;
+		case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+			access = VK_ACCESS_TRANSFER_READ_BIT;
+			stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			break;
+		case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+			access = VK_ACCESS_TRANSFER_WRITE_BIT;
+			stages = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			break;
+		case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+			//Both stages, so overwriting a texture that earlier frames sampled waits on their fragment shaders
+			access = VK_ACCESS_SHADER_READ_BIT;
+			stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			break;
+		case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+			access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			break;
+		case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+			access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			break;
+		case VK_IMAGE_LAYOUT_GENERAL:
+			access = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+			stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			break;
+		default:
+			WARN("Unsupported layout transition ($)!", layout);
+			access = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+			stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			break;
+		}
+	}
+
+	TextureBatch::TextureBatch(VkCommandBuffer commandBuffer)
+		: commandBuffer(commandBuffer) { }
+
+	TextureBatch::Entry& TextureBatch::Find(Texture& texture) {
+		for (auto& entry : entries) {
+			if (entry.texture == &texture) {
+				return entry;
+			}
+		}
+
+		Entry& entry = entries.emplace_back();
+		entry.texture = &texture;
+		entry.oldLayout = texture.layout;
+		entry.finalLayout = texture.layout;
+		return entry;
+	}
+
+	TextureBatch& TextureBatch::Transition(Texture& texture, VkImageLayout newLayout) {
+		Entry& entry = Find(texture);
+		entry.finalLayout = newLayout;
+		texture.layout = newLayout;
+		return *this;
+	}
+
+	TextureBatch& TextureBatch::Copy(Texture& dst, VkBuffer src, VkDeviceSize srcOffset, uint32_t dataLevels) {
+		Entry& entry = Find(dst);
+		ASSERT(!entry.Copies(), "Texture already has a copy in this batch!");
+
+		entry.buffer = src;
+		entry.bufferOffset = srcOffset;
+		entry.bufferLevels = dataLevels;
+		entry.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		dst.layout = entry.finalLayout;
+		return *this;
+	}
+
+	TextureBatch& TextureBatch::Copy(Texture& dst, const Texture& src) {
+		Entry& entry = Find(dst);
+		ASSERT(!entry.Copies(), "Texture already has a copy in this batch!");
+
+		entry.image = &src;
+		entry.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		dst.layout = entry.finalLayout;
+
+		sources.push_back({ &src, src.layout });
+		return *this;
+	}
+
+	TextureBatch& TextureBatch::CopyRegion(
+		Texture& dst,
+		VkBuffer src, VkDeviceSize srcOffset,
+		VkOffset3D offset, VkExtent3D extent,
+		uint32_t level
+	) {
+		Entry& entry = Find(dst);
+		ASSERT(entry.buffer == VK_NULL_HANDLE && entry.image == nullptr, "Texture already has a full copy in this batch!");
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = srcOffset;
+		region.imageOffset = offset;
+		region.imageExtent = extent;
+		region.imageSubresource.aspectMask = dst.ImageAspect();
+		region.imageSubresource.mipLevel = level;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = dst.ArrayLayers();
+
+		entry.regions.push_back({ src, region });
+		entry.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		dst.layout = entry.finalLayout;
+		return *this;
+	}
+
+	TextureBatch& TextureBatch::GenerateMipmaps(Texture& texture, VkImageLayout finalLayout) {
+		VkFormatProperties props;
+		vkGetPhysicalDeviceFormatProperties(global.platform->device->PhysicalDevice(), texture.Format(), &props);
+
+		ASSERT(props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT, "Format doesn't support linear blitting!");
+
+		Entry& entry = Find(texture);
+		entry.mipmaps = true;
+		entry.finalLayout = finalLayout;
+		texture.layout = finalLayout;
+		return *this;
+	}
+
+	TextureBatch& TextureBatch::Release(Texture& texture, uint32_t srcFamily, uint32_t dstFamily) {
+		Find(texture).release = Ownership{ srcFamily, dstFamily };
+		return *this;
+	}
+
+	TextureBatch& TextureBatch::Acquire(Texture& texture, uint32_t srcFamily, uint32_t dstFamily) {
+		Find(texture).acquire = Ownership{ srcFamily, dstFamily };
+		return *this;
+	}
+
+	void TextureBatch::AddBarrier(
+		const Texture& texture,
+		VkImageLayout oldLayout, VkImageLayout newLayout,
+		uint32_t baseLevel, uint32_t levelCount,
+		const std::optional<Ownership>& ownership,
+		b8 release
+	) {
+		VkAccessFlags srcAccess, dstAccess;
+		VkPipelineStageFlags srcStage, dstStage;
+		TransitionInfo(oldLayout, srcAccess, srcStage);
+		TransitionInfo(newLayout, dstAccess, dstStage);
+
+		VkImageMemoryBarrier& barrier = barriers.emplace_back();
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.image = texture;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.subresourceRange.aspectMask = texture.ImageAspect();
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = texture.ArrayLayers();
+		barrier.subresourceRange.baseMipLevel = baseLevel;
+		barrier.subresourceRange.levelCount = levelCount;
+		barrier.oldLayout = oldLayout;
+		barrier.newLayout = newLayout;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstAccessMask = dstAccess;
+
+		if (ownership) {
+			barrier.srcQueueFamilyIndex = ownership->srcFamily;
+			barrier.dstQueueFamilyIndex = ownership->dstFamily;
+
+			//Only one side of an ownership transfer has a meaningful access scope
+			if (release) {
+				barrier.dstAccessMask = 0;
+				dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			}
+			else {
+				barrier.srcAccessMask = 0;
+				srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			}
+		}
+
+		srcStages |= srcStage;
+		dstStages |= dstStage;
+	}
+
+	void TextureBatch::FlushBarriers() {
+		if (barriers.empty()) {
+			return;
+		}
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			srcStages ? srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			dstStages ? dstStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			0,
+			0, nullptr,
+			0, nullptr,
+			static_cast<uint32_t>(barriers.size()), barriers.data()
+		);
+
+		barriers.clear();
+		srcStages = 0;
+		dstStages = 0;
+	}
+
+	void TextureBatch::Record() {
+		//Acquire ownership, the layout has to match the other queue's release
+		for (const auto& entry : entries) {
+			if (entry.acquire) {
+				AddBarrier(*entry.texture, entry.oldLayout, entry.oldLayout,
+					0, entry.texture->MipLevels(), entry.acquire, false);
+			}
+		}
+		FlushBarriers();
+
+		//Move everything into transfer layouts, full copies overwrite so their old contents can be dropped
+		for (const auto& entry : entries) {
+			if (entry.Copies() && entry.oldLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+				AddBarrier(*entry.texture,
+					entry.regions.empty() ? VK_IMAGE_LAYOUT_UNDEFINED : entry.oldLayout,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					0, entry.texture->MipLevels());
+			}
+			else if (entry.mipmaps && entry.oldLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
+				AddBarrier(*entry.texture, entry.oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					0, entry.texture->MipLevels());
+			}
+		}
+		for (const auto& source : sources) {
+			AddBarrier(*source.texture, source.layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				0, source.texture->MipLevels());
+		}
+		FlushBarriers();
+
+		//Copies
+		std::vector<VkBufferImageCopy> regions;
+		for (const auto& entry : entries) {
+			const Texture& texture = *entry.texture;
+
+			for (const auto& [buffer, region] : entry.regions) {
+				vkCmdCopyBufferToImage(
+					commandBuffer,
+					buffer, texture,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					1, &region
+				);
+			}
+
+			if (entry.buffer) {
+				ASSERT(vk::FormatSize(texture.Format()) != 0, "Unsupported copy format " + vk::ToString(texture.Format()) + "!");
+
+				regions.resize(entry.bufferLevels);
+				VkDeviceSize offset = entry.bufferOffset;
+				for (uint32_t level = 0; level < entry.bufferLevels; level++) {
+					VkBufferImageCopy& region = regions[level];
+					region = VkBufferImageCopy{};
+					region.bufferOffset = offset;
+					region.imageExtent = VkExtent3D{
+						math::Max(texture.Width() >> level, 1u),
+						math::Max(texture.Height() >> level, 1u),
+						math::Max(texture.Depth() >> level, 1u)
+					};
+					region.imageSubresource.aspectMask = texture.ImageAspect();
+					region.imageSubresource.mipLevel = level;
+					region.imageSubresource.baseArrayLayer = 0;
+					region.imageSubresource.layerCount = texture.ArrayLayers();
+
+					offset += texture.LevelSize(level);
+				}
+
+				vkCmdCopyBufferToImage(
+					commandBuffer,
+					entry.buffer, texture,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					static_cast<uint32_t>(regions.size()), regions.data()
+				);
+			}
+			else if (entry.image) {
+				const uint32_t levels = math::Min(texture.MipLevels(), entry.image->MipLevels());
+				for (uint32_t level = 0; level < levels; level++) {
+					VkImageCopy copy{};
+					copy.extent = VkExtent3D{
+						math::Max(texture.Width() >> level, 1u),
+						math::Max(texture.Height() >> level, 1u),
+						math::Max(texture.Depth() >> level, 1u)
+					};
+					copy.srcSubresource.aspectMask = texture.ImageAspect();
+					copy.srcSubresource.baseArrayLayer = 0;
+					copy.srcSubresource.layerCount = texture.ArrayLayers();
+					copy.srcSubresource.mipLevel = level;
+					copy.dstSubresource = copy.srcSubresource;
+
+					vkCmdCopyImage(
+						commandBuffer,
+						*entry.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+						texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+						1, &copy
+					);
+				}
+			}
+		}
+
+		//Mips, level by level across every texture so each level costs one barrier.
+		//The barrier before blitting level i also moves level i - 2 to its final layout.
+		uint32_t maxLevels = 0;
+		for (const auto& entry : entries) {
+			if (entry.mipmaps) {
+				maxLevels = math::Max(maxLevels, entry.texture->MipLevels());
+			}
+		}
+
+		for (uint32_t i = 1; i < maxLevels; i++) {
+			for (const auto& entry : entries) {
+				if (!entry.mipmaps || entry.texture->MipLevels() <= i) {
+					continue;
+				}
+
+				AddBarrier(*entry.texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, i - 1, 1);
+				if (i >= 2) {
+					AddBarrier(*entry.texture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, entry.finalLayout, i - 2, 1);
+				}
+			}
+			FlushBarriers();
+
+			for (const auto& entry : entries) {
+				if (!entry.mipmaps || entry.texture->MipLevels() <= i) {
+					continue;
+				}
+
+				const Texture& texture = *entry.texture;
+
+				VkImageBlit blit{};
+				blit.srcOffsets[0] = { 0, 0, 0 };
+				blit.srcOffsets[1] = {
+					static_cast<int32_t>(math::Max(texture.Width() >> (i - 1), 1u)),
+					static_cast<int32_t>(math::Max(texture.Height() >> (i - 1), 1u)),
+					static_cast<int32_t>(math::Max(texture.Depth() >> (i - 1), 1u))
+				};
+				blit.srcSubresource.aspectMask = texture.ImageAspect();
+				blit.srcSubresource.baseArrayLayer = 0;
+				blit.srcSubresource.layerCount = texture.ArrayLayers();
+				blit.srcSubresource.mipLevel = i - 1;
+				blit.dstOffsets[0] = { 0, 0, 0 };
+				blit.dstOffsets[1] = {
+					static_cast<int32_t>(math::Max(texture.Width() >> i, 1u)),
+					static_cast<int32_t>(math::Max(texture.Height() >> i, 1u)),
+					static_cast<int32_t>(math::Max(texture.Depth() >> i, 1u))
+				};
+				blit.dstSubresource = blit.srcSubresource;
+				blit.dstSubresource.mipLevel = i;
+
+				vkCmdBlitImage(
+					commandBuffer,
+					texture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					1, &blit,
+					VK_FILTER_LINEAR
+				);
+			}
+		}
+
+		//Final layouts and releases
+		for (const auto& entry : entries) {
+			const Texture& texture = *entry.texture;
+			const uint32_t levels = texture.MipLevels();
+
+			if (entry.mipmaps && levels > 1) {
+				//Levels below levels - 2 were moved while blitting
+				AddBarrier(texture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, entry.finalLayout,
+					levels - 2, 1, entry.release, true);
+				AddBarrier(texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, entry.finalLayout,
+					levels - 1, 1, entry.release, true);
+
+				if (entry.release && levels > 2) {
+					AddBarrier(texture, entry.finalLayout, entry.finalLayout,
+						0, levels - 2, entry.release, true);
+				}
+			}
+			else {
+				VkImageLayout current = (entry.Copies() || entry.mipmaps)
+					? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : entry.oldLayout;
+
+				if (current != entry.finalLayout || entry.release) {
+					AddBarrier(texture, current, entry.finalLayout,
+						0, levels, entry.release, true);
+				}
+			}
+		}
+		for (const auto& source : sources) {
+			AddBarrier(*source.texture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, source.layout,
+				0, source.texture->MipLevels());
+		}
+		FlushBarriers();
+
+		entries.clear();
+		sources.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Platform\Device.h"
+
+namespace gfx {
+
+	class Texture;
+
+	//Collects layout transitions, copies and mip generation for any number of textures and
+	//records them into one command buffer. Work is grouped into phases so that every phase
+	//costs a single vkCmdPipelineBarrier no matter how many textures are in the batch:
+	//acquire -> transfer layouts -> copies -> mips (one barrier per level) -> final layouts/release.
+	//Each texture's CurrentLayout() is updated immediately, the textures must outlive Record().
+	class TextureBatch {
+	public:
+		TextureBatch(VkCommandBuffer commandBuffer);
+
+		TextureBatch& Transition(Texture& texture, VkImageLayout newLayout);
+
+		//buffer holds dataLevels tightly packed mip levels
+		TextureBatch& Copy(Texture& dst, VkBuffer src, VkDeviceSize srcOffset = 0, uint32_t dataLevels = 1);
+		TextureBatch& Copy(Texture& dst, const Texture& src);
+
+		//Copies a tightly packed block into part of one level, the rest of the image keeps its contents.
+		//Can be called any number of times per texture, but not together with a full copy
+		TextureBatch& CopyRegion(
+			Texture& dst,
+			VkBuffer src, VkDeviceSize srcOffset,
+			VkOffset3D offset, VkExtent3D extent,
+			uint32_t level = 0
+		);
+
+		//Blits level 0 down the rest of the chain
+		TextureBatch& GenerateMipmaps(Texture& texture, VkImageLayout finalLayout);
+
+		//Queue family ownership transfer, both sides must agree on the layouts
+		TextureBatch& Release(Texture& texture, uint32_t srcFamily, uint32_t dstFamily);
+		TextureBatch& Acquire(Texture& texture, uint32_t srcFamily, uint32_t dstFamily);
+
+		void Record();
+
+		inline b8 Empty() const { return entries.empty() && sources.empty(); }
+		inline usize Size() const { return entries.size(); }
+
+		static void TransitionInfo(VkImageLayout layout, VkAccessFlags& access, VkPipelineStageFlags& stages);
+
+	private:
+		struct Ownership {
+			uint32_t srcFamily, dstFamily;
+		};
+
+		struct Entry {
+			Texture* texture;
+			VkImageLayout oldLayout;
+			VkImageLayout finalLayout;
+
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize bufferOffset = 0;
+			uint32_t bufferLevels = 0;
+			const Texture* image = nullptr;
+
+			std::vector<std::pair<VkBuffer, VkBufferImageCopy>> regions;
+
+			b8 mipmaps = false;
+			std::optional<Ownership> acquire, release;
+
+			inline b8 Copies() const { return buffer != VK_NULL_HANDLE || image != nullptr || !regions.empty(); }
+		};
+
+		struct Source {
+			const Texture* texture;
+			VkImageLayout layout;
+		};
+
+		Entry& Find(Texture& texture);
+
+		void AddBarrier(
+			const Texture& texture,
+			VkImageLayout oldLayout, VkImageLayout newLayout,
+			uint32_t baseLevel, uint32_t levelCount,
+			const std::optional<Ownership>& ownership = std::nullopt,
+			b8 release = false
+		);
+		void FlushBarriers();
+
+		VkCommandBuffer commandBuffer;
+
+		std::vector<Entry> entries;
+		std::vector<Source> sources;
+
+		std::vector<VkImageMemoryBarrier> barriers;
+		VkPipelineStageFlags srcStages = 0, dstStages = 0;
+	};
+}
\ No newline at end of file
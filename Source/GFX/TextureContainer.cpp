@@ -0,0 +1,238 @@
+#include "TextureContainer.h"
+#include "State.h"
+#include "Util\File.h"
+#include "Util\Log.h"
+#include "Util\JobSystem.h"
+#include "stb_image.h"
+
+namespace gfx {
+
+	namespace {
+		struct Image {
+			u32 width, height;
+			std::vector<u32> pixels;
+		};
+
+		f32 ToLinear(u32 value) {
+			static const std::array<f32, 256> table = []() {
+				std::array<f32, 256> result;
+				for (u32 i = 0; i < 256; i++) {
+					const f32 c = static_cast<f32>(i) / 255.0f;
+					result[i] = c <= 0.04045f ? c / 12.92f : math::Pow((c + 0.055f) / 1.055f, 2.4f);
+				}
+				return result;
+			}();
+
+			return table[value];
+		}
+
+		u8 ToSRGB(f32 value) {
+			const f32 c = value <= 0.0031308f
+				? value * 12.92f
+				: 1.055f * math::Pow(value, 1.0f / 2.4f) - 0.055f;
+			return static_cast<u8>(math::Clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+		}
+
+		//2x2 box filter in linear space, color is weighted by alpha so transparent texels don't bleed in
+		Image Downsample(const Image& src) {
+			Image dst;
+			dst.width = math::Max(src.width >> 1, 1u);
+			dst.height = math::Max(src.height >> 1, 1u);
+			dst.pixels.resize(static_cast<usize>(dst.width) * dst.height);
+
+			for (u32 y = 0; y < dst.height; y++) {
+				for (u32 x = 0; x < dst.width; x++) {
+					f32 r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+
+					for (u32 i = 0; i < 4; i++) {
+						const u32 sx = math::Min(x * 2 + (i & 1), src.width - 1);
+						const u32 sy = math::Min(y * 2 + (i >> 1), src.height - 1);
+						const u32 texel = src.pixels[static_cast<usize>(sy) * src.width + sx];
+
+						const f32 alpha = static_cast<f32>(texel >> 24) / 255.0f;
+						r += ToLinear(texel & 0xFF) * alpha;
+						g += ToLinear((texel >> 8) & 0xFF) * alpha;
+						b += ToLinear((texel >> 16) & 0xFF) * alpha;
+						a += alpha;
+					}
+
+					u32 result = 0;
+					if (a > 0.0f) {
+						result = ToSRGB(r / a)
+							| (ToSRGB(g / a) << 8)
+							| (ToSRGB(b / a) << 16)
+							| (static_cast<u32>(a * 0.25f * 255.0f + 0.5f) << 24);
+					}
+					dst.pixels[static_cast<usize>(y) * dst.width + x] = result;
+				}
+			}
+
+			return dst;
+		}
+	}
+
+	u64 TextureContainer::TexelCount(const Header& header) {
+		u64 texels = 0;
+		for (u32 level = 0; level < header.levels; level++) {
+			texels += static_cast<u64>(math::Max(header.width >> level, 1u))
+				* math::Max(header.height >> level, 1u)
+				* math::Max(header.depth >> level, 1u);
+		}
+		return texels * header.layers;
+	}
+
+	std::optional<std::string> TextureContainer::Bake(const std::string& src, const std::string& dst, b8 mipmap) {
+		auto fileData = util::ReadFileBinary(src);
+		if (fileData.IsErr()) {
+			return fileData.UnwrapErr();
+		}
+		const std::vector<u8> bytes = fileData.Unwrap();
+
+		int width, height, comp;
+		stbi_uc* pixels = stbi_load_from_memory(
+			bytes.data(), static_cast<int>(bytes.size()),
+			&width, &height, &comp, STBI_rgb_alpha);
+		if (!pixels) {
+			return "Failed to decode " + src + ": " + stbi_failure_reason();
+		}
+
+		auto result = Write(dst, reinterpret_cast<const u32*>(pixels),
+			static_cast<u32>(width), static_cast<u32>(height), mipmap);
+		stbi_image_free(pixels);
+
+		return result;
+	}
+
+	std::optional<std::string> TextureContainer::Write(
+		const std::string& dst,
+		const u32* pixels,
+		u32 width, u32 height,
+		b8 mipmap
+	) {
+		Header header{};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.format = VK_FORMAT_R8G8B8A8_SRGB;
+		header.width = width;
+		header.height = height;
+		header.depth = 1;
+		header.layers = 1;
+		header.levels = 1;
+		if (mipmap) {
+			header.levels = static_cast<u32>(math::Floor(math::Log2(
+				static_cast<f32>(math::Min(width, height))))) + 1;
+		}
+
+		std::vector<Image> chain;
+		chain.reserve(header.levels);
+		chain.push_back(Image{ width, height, std::vector<u32>(pixels, pixels + static_cast<usize>(width) * height) });
+
+		for (u32 level = 1; level < header.levels; level++) {
+			chain.push_back(Downsample(chain.back()));
+		}
+
+		//Pixel art rarely has more than a few colors, so try to fit the whole chain in one palette
+		std::unordered_map<u32, u8> indices;
+		std::vector<u32> palette;
+		for (const auto& image : chain) {
+			for (u32 texel : image.pixels) {
+				if (indices.size() > MAX_PALETTE_SIZE) {
+					break;
+				}
+				if (indices.try_emplace(texel, static_cast<u8>(palette.size())).second) {
+					palette.push_back(texel);
+				}
+			}
+		}
+
+		const u64 texels = TexelCount(header);
+		const b8 usePalette = palette.size() <= MAX_PALETTE_SIZE;
+
+		header.encoding = usePalette ? Encoding::Palette : Encoding::Raw;
+		header.paletteSize = usePalette ? static_cast<u32>(palette.size()) : 0;
+		header.dataSize = usePalette ? texels : texels * sizeof(u32);
+
+		std::vector<u8> output(sizeof(Header) + header.paletteSize * sizeof(u32) + header.dataSize);
+		u8* out = output.data();
+
+		std::memcpy(out, &header, sizeof(Header));
+		out += sizeof(Header);
+
+		if (usePalette) {
+			std::memcpy(out, palette.data(), palette.size() * sizeof(u32));
+			out += palette.size() * sizeof(u32);
+
+			for (const auto& image : chain) {
+				for (u32 texel : image.pixels) {
+					*out++ = indices[texel];
+				}
+			}
+		}
+		else {
+			for (const auto& image : chain) {
+				std::memcpy(out, image.pixels.data(), image.pixels.size() * sizeof(u32));
+				out += image.pixels.size() * sizeof(u32);
+			}
+		}
+
+		auto result = util::WriteFileBinary(dst, output);
+		if (result.IsErr()) {
+			return result.UnwrapErr();
+		}
+
+		return std::nullopt;
+	}
+
+	b8 TextureContainer::IsSourceImage(const std::string& file) {
+		static const std::array<std::string_view, 5> SOURCE_EXTENSIONS = {
+			".png", ".jpg", ".jpeg", ".bmp", ".tga"
+		};
+
+		std::string extension = std::filesystem::path(file).extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(),
+			[](char c) { return static_cast<char>(std::tolower(c)); });
+
+		return std::find(SOURCE_EXTENSIONS.begin(), SOURCE_EXTENSIONS.end(), extension) != SOURCE_EXTENSIONS.end();
+	}
+
+	void TextureContainer::BakeDirectory(const std::string& directory) {
+		auto files = util::ListFiles(directory);
+		if (files.IsErr()) {
+			ERROR(-1, util::Logger::GFX, files.UnwrapErr());
+		}
+
+		struct Job {
+			std::string src, dst;
+			std::future<std::optional<std::string>> result;
+		};
+		std::vector<Job> jobs;
+
+		for (const auto& file : files.Unwrap()) {
+			if (!IsSourceImage(file)) {
+				continue;
+			}
+
+			std::string dst = std::filesystem::path(file).replace_extension(EXTENSION).generic_string();
+			if (util::FileExists(dst)
+				&& std::filesystem::last_write_time(dst) >= std::filesystem::last_write_time(file)) {
+				continue;
+			}
+
+			Job& job = jobs.emplace_back(Job{ file, dst, {} });
+			job.result = global.jobs->Submit([src = job.src, dst = job.dst]() { return Bake(src, dst); });
+		}
+
+		u32 failed = 0;
+		for (auto& job : jobs) {
+			if (auto error = job.result.get()) {
+				WARNNG(util::Logger::GFX, "Failed to bake $: $", job.src, *error);
+				failed++;
+			}
+			else {
+				LOGNG(util::Logger::GFX, "Baked $ -> $", job.src, job.dst);
+			}
+		}
+
+		LOGNG(util::Logger::GFX, "Baked $ textures in $ ($ failed)", jobs.size() - failed, directory, failed);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Util\Types.h"
+#include "Util\Std.h"
+#include "Util\Vulkan.h"
+
+namespace gfx {
+
+	//Offline texture format (.ptex) built from the source images in Resources/.
+	//Layout is the header, then paletteSize RGBA8 colors, then every mip level largest first
+	//with all layers of a level packed together, which is what Uploader::CopyToImage expects.
+	//Palette encoded containers store one byte per texel instead of four.
+	struct TextureContainer {
+		static constexpr u32 MAGIC = 0x58455450; //"PTEX"
+		static constexpr u32 VERSION = 1;
+		static constexpr u32 MAX_PALETTE_SIZE = 256;
+		static constexpr const char* EXTENSION = ".ptex";
+
+		enum class Encoding : u32 {
+			Raw = 0,
+			Palette = 1
+		};
+
+		struct Header {
+			u32 magic;
+			u32 version;
+			VkFormat format;
+			u32 width, height, depth;
+			u32 levels, layers;
+			Encoding encoding;
+			u32 paletteSize;
+			u64 dataSize; //Bytes after the palette
+		};
+
+		static_assert(sizeof(Header) == 48, "TextureContainer::Header has to match the file layout!");
+
+		//Tightly packed size of the whole mip chain in texels
+		static u64 TexelCount(const Header& header);
+
+		//Decodes src with stb_image, builds the mip chain on the CPU and writes the container to dst.
+		//Returns an error message on failure
+		static std::optional<std::string> Bake(const std::string& src, const std::string& dst, b8 mipmap = true);
+
+		//Writes RGBA8 sRGB pixels to a container, building the mip chain if asked to
+		static std::optional<std::string> Write(
+			const std::string& dst,
+			const u32* pixels,
+			u32 width, u32 height,
+			b8 mipmap = true
+		);
+
+		//Whether file has an extension stb_image can decode
+		static b8 IsSourceImage(const std::string& file);
+
+		//Bakes every image in directory next to its source, skipping containers that are up to date
+		static void BakeDirectory(const std::string& directory);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "TextureSets.h"
+#include "Util\Time.h"
+#include "State.h"
+
+namespace gfx {
+
+	TextureSetCache::TextureSetCache(u32 setsPerPool, VkShaderStageFlags stages) : setsPerPool(setsPerPool) {
+		layout = DescriptorSetLayout::Builder()
+			.AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, stages)
+			.Create();
+
+		pool = CreatePool();
+	}
+
+	std::unique_ptr<DescriptorPool> TextureSetCache::CreatePool() const {
+		return DescriptorPool::Builder()
+			.SetMaxSets(setsPerPool)
+			.AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setsPerPool)
+			.Create();
+	}
+
+	VkDescriptorSet TextureSetCache::Get(const Texture& texture) {
+		const u64 frame = global.time->FrameCount();
+		while (!retired.empty() && retired.front().frame + vk::MAX_FRAMES_IN_FLIGHT < frame) {
+			retired.pop_front();
+		}
+
+		auto it = sets.find(texture.Id());
+		if (it != sets.end()) {
+			return it->second;
+		}
+
+		const VkDescriptorImageInfo info = texture.DescriptorInfo();
+		ASSERT(info.sampler != VK_NULL_HANDLE, "Textures in a set need a sampler!");
+
+		VkDescriptorSet set;
+		VkResult result = DescriptorBuilder(*pool, *layout).WriteImage(0, info).Build(set);
+		if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+			//Filling a pool within the frames in flight means more textures are drawn than it holds
+			if (!retired.empty()) {
+				setsPerPool *= 2;
+			}
+
+			//Sets of destroyed textures go with the old pool, the ones still drawn get rewritten on their next use
+			retired.push_back(Retired{ frame, std::move(pool) });
+			pool = CreatePool();
+			sets.clear();
+
+			result = DescriptorBuilder(*pool, *layout).WriteImage(0, info).Build(set);
+		}
+		VULKAN_CHECK(result, "Failed to write texture descriptor set!");
+
+		sets[texture.Id()] = set;
+		return set;
+	}
+}
\ No newline at end of file
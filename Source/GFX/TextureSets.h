@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Descriptors.h"
+#include "Texture.h"
+
+namespace gfx {
+
+	//Descriptor sets holding a single texture at binding 0, written once per texture and reused every frame.
+	//They're looked up by Texture::Id(), which is never reused, so a recycled image view can't pick up a
+	//set written for a texture that's gone. When the pool runs out the sets start over in a fresh one,
+	//the old pool is destroyed once no frame in flight can still be using its sets
+	class TextureSetCache {
+	public:
+		TextureSetCache(u32 setsPerPool, VkShaderStageFlags stages);
+
+		TextureSetCache(const TextureSetCache& other) = delete;
+		TextureSetCache& operator=(const TextureSetCache& other) = delete;
+
+		VkDescriptorSet Get(const Texture& texture);
+
+		inline const DescriptorSetLayout& Layout() const { return *layout; }
+
+	private:
+		struct Retired {
+			u64 frame;
+			std::unique_ptr<DescriptorPool> pool;
+		};
+
+		std::unique_ptr<DescriptorPool> CreatePool() const;
+
+		u32 setsPerPool;
+		std::unique_ptr<DescriptorSetLayout> layout;
+		std::unique_ptr<DescriptorPool> pool;
+		std::deque<Retired> retired;
+
+		std::unordered_map<u64, VkDescriptorSet> sets;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "Tilemap.h"
+#include "Renderer.h"
+#include "Util\Time.h"
+#include "Util\JobSystem.h"
+#include "Util\Profiler.h"
+#include "State.h"
+
+namespace gfx {
+
+	Tilemap::Tilemap(uvec2 size, u32 layerCount, const Tileset& tileset)
+		: size(size),
+		chunks((size.x + CHUNK_SIZE - 1) / CHUNK_SIZE, (size.y + CHUNK_SIZE - 1) / CHUNK_SIZE),
+		tileset(tileset) {
+		ASSERT(tileset.texture && tileset.columns > 0, "Tilemap needs a tileset!");
+
+		layers.resize(layerCount);
+		for (auto& layer : layers) {
+			layer.resize(static_cast<usize>(chunks.x) * chunks.y);
+		}
+		buffers.Reserve(layerCount * chunks.x * chunks.y);
+	}
+
+	Tilemap::Tile Tilemap::Get(u32 layer, uvec2 pos) const {
+		ASSERT(layer < layers.size() && pos.x < size.x && pos.y < size.y, "Tile out of range!");
+
+		const Chunk& chunk = layers[layer][ChunkIndex(pos)];
+		return chunk.tiles[(pos.y % CHUNK_SIZE) * CHUNK_SIZE + pos.x % CHUNK_SIZE];
+	}
+
+	void Tilemap::Set(u32 layer, uvec2 pos, Tile tile) {
+		ASSERT(layer < layers.size() && pos.x < size.x && pos.y < size.y, "Tile out of range!");
+
+		const usize index = ChunkIndex(pos);
+		Tile& dst = layers[layer][index].tiles[(pos.y % CHUNK_SIZE) * CHUNK_SIZE + pos.x % CHUNK_SIZE];
+		if (dst != tile) {
+			dst = tile;
+			MarkDirty(layer, index);
+		}
+	}
+
+	void Tilemap::Fill(u32 layer, uvec2 min, uvec2 max, Tile tile) {
+		max = uvec2{ math::Min(max.x, size.x), math::Min(max.y, size.y) };
+		for (u32 y = min.y; y < max.y; y++) {
+			for (u32 x = min.x; x < max.x; x++) {
+				Set(layer, uvec2{ x, y }, tile);
+			}
+		}
+	}
+
+	void Tilemap::MarkDirty(u32 layer, usize chunk) {
+		Chunk& dst = layers[layer][chunk];
+		if (!dst.dirty) {
+			dst.dirty = true;
+			dirty.push_back({ layer, chunk });
+		}
+	}
+
+	void Tilemap::Update() {
+		PROFILE_FUNCTION();
+		stats = Stats{};
+
+		const u64 frame = global.time->FrameCount();
+		while (!retired.empty() && retired.front().frame + vk::MAX_FRAMES_IN_FLIGHT < frame) {
+			buffers.Destroy(retired.front().buffer);
+			retired.pop_front();
+		}
+
+		//Packing tiles is independent per chunk, so it's spread over the workers. Creating buffers
+		//and recording uploads isn't thread safe and stays on this thread
+		scratch.resize(dirty.size() * CHUNK_TILES);
+		global.jobs->ParallelFor(static_cast<u32>(dirty.size()), 4, [this](u32 begin, u32 end) {
+			for (u32 i = begin; i < end; i++) {
+				const auto& [layer, index] = dirty[i];
+				Pack(layers[layer][index], &scratch[static_cast<usize>(i) * CHUNK_TILES]);
+			}
+		});
+
+		for (usize i = 0; i < dirty.size(); i++) {
+			const auto& [layer, index] = dirty[i];
+			Chunk& chunk = layers[layer][index];
+			chunk.dirty = false;
+
+			if (chunk.instances.Valid()) {
+				retired.push_back(Retired{ frame, chunk.instances });
+				chunk.instances = {};
+			}
+
+			Upload(chunk, &scratch[i * CHUNK_TILES]);
+			stats.uploadedChunks++;
+			stats.uploadedBytes += chunk.count * sizeof(TileInstance);
+		}
+		dirty.clear();
+	}
+
+	void Tilemap::Pack(Chunk& chunk, TileInstance* instances) {
+		u32 count = 0;
+		for (u32 i = 0; i < CHUNK_TILES; i++) {
+			if (chunk.tiles[i] != EMPTY) {
+				instances[count++] = TileInstance{ (i % CHUNK_SIZE) | ((i / CHUNK_SIZE) << 8) | (static_cast<u32>(chunk.tiles[i]) << 16) };
+			}
+		}
+
+		chunk.count = count;
+	}
+
+	void Tilemap::Upload(Chunk& chunk, const TileInstance* instances) {
+		if (chunk.count == 0) {
+			return;
+		}
+
+		chunk.instances = buffers.Create(
+			sizeof(TileInstance),
+			chunk.count,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			vk::QueueFamilies::Graphics
+		);
+
+		global.renderer->GetUploader().UploadBuffer(
+			buffers[chunk.instances],
+			instances, chunk.count * sizeof(TileInstance),
+			0,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+			VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+		);
+	}
+}
\ No newline at end of file
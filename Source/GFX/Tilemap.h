@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Buffer.h"
+#include "Texture.h"
+#include "Vertex.h"
+#include "Util\Pool.h"
+
+namespace gfx {
+
+	//Tile layers stored in fixed-size chunks. Every chunk keeps a device-local instance buffer
+	//with one entry per non-empty tile that is only rebuilt when one of its tiles changed.
+	//Replaced buffers are kept alive until no frame in flight can still be reading them. The buffers
+	//live in a pool, so rebuilding a chunk reuses a slot instead of a heap allocation.
+	class Tilemap {
+	public:
+		using Tile = u16;
+
+		static constexpr Tile EMPTY = 0; //Tile n uses cell n - 1 of the tileset
+		static constexpr u32 CHUNK_SIZE = 32;
+		static constexpr u32 CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE;
+
+		struct Tileset {
+			const Texture* texture;
+			vec4 rect = vec4{ 0.f, 0.f, 1.f, 1.f }; //Part of the texture holding the tiles, e.g. an atlas region
+			uvec2 tileSize; //In pixels
+			u32 columns;
+		};
+
+		struct Stats {
+			u32 uploadedChunks = 0;
+			u64 uploadedBytes = 0;
+		};
+
+		Tilemap(uvec2 size, u32 layers, const Tileset& tileset);
+
+		Tile Get(u32 layer, uvec2 pos) const;
+		void Set(u32 layer, uvec2 pos, Tile tile);
+
+		//Fills every tile in [min, max)
+		void Fill(u32 layer, uvec2 min, uvec2 max, Tile tile);
+
+		//Uploads the chunks changed since the last call, call once per frame before rendering
+		void Update();
+
+		inline uvec2 Size() const { return size; }
+		inline uvec2 SizeInChunks() const { return chunks; }
+		inline u32 Layers() const { return static_cast<u32>(layers.size()); }
+		inline const Tileset& GetTileset() const { return tileset; }
+		inline const Stats& LastStats() const { return stats; }
+
+	private:
+		struct Chunk {
+			std::array<Tile, CHUNK_TILES> tiles{};
+			util::Handle<Buffer> instances;
+			u32 count = 0;
+			b8 dirty = false;
+		};
+
+		struct Retired {
+			u64 frame;
+			util::Handle<Buffer> buffer;
+		};
+
+		inline usize ChunkIndex(uvec2 pos) const {
+			return static_cast<usize>(pos.y / CHUNK_SIZE) * chunks.x + pos.x / CHUNK_SIZE;
+		}
+
+		void MarkDirty(u32 layer, usize chunk);
+
+		//Pack can run on any thread, Upload only on the render thread
+		static void Pack(Chunk& chunk, TileInstance* instances);
+		void Upload(Chunk& chunk, const TileInstance* instances);
+
+		uvec2 size, chunks;
+		Tileset tileset;
+
+		util::Pool<Buffer> buffers;
+		std::vector<std::vector<Chunk>> layers;
+		std::vector<std::pair<u32, usize>> dirty;
+		std::deque<Retired> retired;
+
+		std::vector<TileInstance> scratch;
+
+		Stats stats;
+
+		friend class TilemapRenderer;
+	};
+}
\ No newline at end of file
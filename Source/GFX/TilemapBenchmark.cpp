@@ -0,0 +1,115 @@
+#include "TilemapBenchmark.h"
+#include "Renderer.h"
+#include "Util\Time.h"
+#include "State.h"
+
+namespace gfx {
+
+	TilemapBenchmark::TilemapBenchmark(u32 size) {
+		Texture::SamplerSettings samplerSettings{};
+		samplerSettings.filter = VK_FILTER_NEAREST;
+		samplerSettings.enableAnisotropy = VK_FALSE;
+		samplerSettings.addressMode = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+
+		//Every cell of the tileset gets its own flat color with a darker border
+		const u32 tilesetSize = TILE_SIZE * TILESET_COLUMNS;
+		std::vector<u32> pixels(tilesetSize * tilesetSize);
+		for (u32 y = 0; y < tilesetSize; y++) {
+			for (u32 x = 0; x < tilesetSize; x++) {
+				const u32 cell = (y / TILE_SIZE) * TILESET_COLUMNS + x / TILE_SIZE;
+				const b8 border = x % TILE_SIZE == 0 || y % TILE_SIZE == 0;
+				const u32 shade = border ? 0x40 : 0xA0;
+				pixels[y * tilesetSize + x] = 0xFF000000
+					| ((shade + cell * 7) & 0xFF)
+					| (((shade + cell * 13) & 0xFF) << 8)
+					| (((shade + cell * 29) & 0xFF) << 16);
+			}
+		}
+
+		tileset = std::make_unique<Texture>(
+			VK_FORMAT_R8G8B8A8_SRGB,
+			VkExtent3D{ tilesetSize, tilesetSize, 1 },
+			VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+			1u, 1u,
+			VK_SAMPLE_COUNT_1_BIT,
+			true,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			vk::QueueFamilies::Graphics,
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_LAYOUT_UNDEFINED,
+			samplerSettings
+		);
+		global.renderer->GetUploader().UploadImage(*tileset, pixels.data(), pixels.size() * sizeof(u32));
+
+		Tilemap::Tileset settings{};
+		settings.texture = tileset.get();
+		settings.tileSize = uvec2{ TILE_SIZE };
+		settings.columns = TILESET_COLUMNS;
+
+		tilemap = std::make_unique<Tilemap>(uvec2{ size }, 2, settings);
+
+		const u32 cells = TILESET_COLUMNS * TILESET_COLUMNS;
+		std::uniform_int_distribution<u32> ground(1, cells / 2);
+		std::uniform_int_distribution<u32> decoration(cells / 2 + 1, cells);
+		std::uniform_real_distribution<f32> unit(0.f, 1.f);
+
+		for (u32 y = 0; y < size; y++) {
+			for (u32 x = 0; x < size; x++) {
+				tilemap->Set(0, uvec2{ x, y }, static_cast<Tilemap::Tile>(ground(rng)));
+				if (unit(rng) < 0.1f) {
+					tilemap->Set(1, uvec2{ x, y }, static_cast<Tilemap::Tile>(decoration(rng)));
+				}
+			}
+		}
+
+		lastReport = global.time->CurrentTime();
+
+		LOGNG(util::Logger::GFX, "Tilemap benchmark running on a $x$ map ($ chunks per layer).",
+			size, size, tilemap->SizeInChunks().x * tilemap->SizeInChunks().y);
+	}
+
+	void TilemapBenchmark::Update() {
+		const uvec2 size = tilemap->Size();
+		std::uniform_int_distribution<u32> x(0, size.x - 1), y(0, size.y - 1);
+		std::uniform_int_distribution<u32> tile(1, TILESET_COLUMNS * TILESET_COLUMNS);
+
+		for (u32 i = 0; i < EDITS_PER_FRAME; i++) {
+			tilemap->Set(1, uvec2{ x(rng), y(rng) }, static_cast<Tilemap::Tile>(tile(rng)));
+		}
+
+		tilemap->Update();
+		uploads += tilemap->LastStats().uploadedChunks;
+	}
+
+	void TilemapBenchmark::Render(VkCommandBuffer commandBuffer, TilemapRenderer& renderer, vec2 bounds) {
+		const f64 now = global.time->CurrentTime();
+
+		//Pan diagonally across the whole map and back
+		const vec2 mapSize = static_cast<vec2>(tilemap->Size()) * static_cast<f32>(TILE_SIZE);
+		const vec2 range = vec2{ math::Max(mapSize.x - bounds.x, 0.f), math::Max(mapSize.y - bounds.y, 0.f) };
+		const f32 t = static_cast<f32>(math::Mod(now / 60000.0, 1.0));
+		const vec2 camera = range * (t < 0.5f ? t * 2.f : 2.f - t * 2.f);
+
+		const mat4 viewProj = math::Ortho(camera.x, camera.x + bounds.x, camera.y, camera.y + bounds.y, 0.f, 1.f);
+		renderer.Render(commandBuffer, *tilemap, viewProj, vec4{ camera.x, camera.y, camera.x + bounds.x, camera.y + bounds.y });
+
+		const TilemapRenderer::Stats& last = renderer.LastStats();
+		frames++;
+		chunks += last.chunks;
+		tiles += last.tiles;
+		cpuTime += last.cpuTime;
+
+		if (now - lastReport >= 1000.0) {
+			LOGNG(util::Logger::GFX,
+				"Tilemap: $ chunks, $ tiles, $ chunk uploads, $ms CPU per frame",
+				static_cast<f64>(chunks) / frames,
+				static_cast<f64>(tiles) / frames,
+				static_cast<f64>(uploads) / frames,
+				cpuTime / frames);
+
+			lastReport = now;
+			frames = chunks = tiles = uploads = 0;
+			cpuTime = 0.0;
+		}
+	}
+}
\ No newline at end of file
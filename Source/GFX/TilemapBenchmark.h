@@ -0,0 +1,32 @@
+#pragma once
+
+#include "TilemapRenderer.h"
+
+namespace gfx {
+
+	//Stress scene for the tilemap path, enabled with tilemapBenchmark under [Debug] in the config
+	//(the map is that many tiles on each side). Scrolls across a random two layer map, edits a few
+	//tiles every frame and logs visible chunks, tiles, uploads and CPU time once a second
+	class TilemapBenchmark {
+	public:
+		static constexpr u32 TILE_SIZE = 16;
+		static constexpr u32 TILESET_COLUMNS = 8;
+		static constexpr u32 EDITS_PER_FRAME = 16;
+
+		TilemapBenchmark(u32 size);
+
+		//Applies this frame's edits and uploads, call before Render
+		void Update();
+		void Render(VkCommandBuffer commandBuffer, TilemapRenderer& renderer, vec2 bounds);
+
+	private:
+		std::unique_ptr<Texture> tileset;
+		std::unique_ptr<Tilemap> tilemap;
+
+		std::mt19937 rng{ 1234 };
+
+		f64 lastReport;
+		u64 frames = 0, chunks = 0, tiles = 0, uploads = 0;
+		f64 cpuTime = 0.0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "TilemapRenderer.h"
+#include "Util\Time.h"
+#include "State.h"
+
+namespace gfx {
+
+	namespace {
+		//Matches the push constant block in tile.vert
+		struct ChunkConstants {
+			mat4 viewProj;
+			vec2 origin;
+			vec2 tileSize;
+			vec2 uvOrigin;
+			vec2 uvTile;
+			u32 columns;
+		};
+	}
+
+	void TilemapRenderer::Init(PipelineCache* cache, VkRenderPass renderPass) {
+		textureSets = std::make_unique<TextureSetCache>(MAX_TILESETS, VK_SHADER_STAGE_FRAGMENT_BIT);
+
+		Pipeline::LayoutSettings layoutSettings;
+		layoutSettings.sets.push_back(textureSets->Layout());
+		layoutSettings.ranges.push_back(VkPushConstantRange{ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ChunkConstants) });
+
+		Shader vertShader{ "Shaders\\tile.vert.spv", VK_SHADER_STAGE_VERTEX_BIT };
+		Shader fragShader{ "Shaders\\tile.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT };
+
+		auto settings = GraphicsPipeline::DefaultSettings<TileInstance>(vertShader, fragShader, renderPass);
+
+		//Upper layers are alpha blended over the lower ones
+		auto& blend = settings.blending.attachments[0];
+		blend.blendEnable = VK_TRUE;
+		blend.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		blend.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+		pipeline = std::make_unique<GraphicsPipeline>(layoutSettings, settings, cache);
+	}
+
+	void TilemapRenderer::Render(
+		VkCommandBuffer commandBuffer,
+		const Tilemap& tilemap,
+		const mat4& viewProj,
+		vec4 view,
+		vec2 origin
+	) {
+		const f64 start = global.time->CurrentTime();
+		stats = Stats{};
+
+		const Tilemap::Tileset& tileset = tilemap.GetTileset();
+		const vec2 tileSize = static_cast<vec2>(tileset.tileSize);
+		const vec2 chunkSize = tileSize * static_cast<f32>(Tilemap::CHUNK_SIZE);
+
+		//Chunks overlapping the view, everything else is skipped without being looked at
+		const vec2 first = (vec2{ view.x, view.y } - origin) / chunkSize;
+		const vec2 last = (vec2{ view.z, view.w } - origin) / chunkSize;
+		const uvec2 chunks = tilemap.SizeInChunks();
+
+		const i32 minX = math::Max(static_cast<i32>(math::Floor(first.x)), 0);
+		const i32 minY = math::Max(static_cast<i32>(math::Floor(first.y)), 0);
+		const i32 maxX = math::Min(static_cast<i32>(math::Ceil(last.x)), static_cast<i32>(chunks.x));
+		const i32 maxY = math::Min(static_cast<i32>(math::Ceil(last.y)), static_cast<i32>(chunks.y));
+
+		if (minX >= maxX || minY >= maxY) {
+			stats.cpuTime = global.time->CurrentTime() - start;
+			return;
+		}
+
+		pipeline->Bind(commandBuffer);
+
+		VkDescriptorSet set = textureSets->Get(*tileset.texture);
+		vkCmdBindDescriptorSets(
+			commandBuffer,
+			pipeline->BindPoint(), pipeline->GetLayout(),
+			0,
+			1, &set,
+			0, nullptr
+		);
+
+		const vec2 textureSize{ static_cast<f32>(tileset.texture->Width()), static_cast<f32>(tileset.texture->Height()) };
+
+		ChunkConstants constants{};
+		constants.viewProj = viewProj;
+		constants.tileSize = tileSize;
+		constants.uvOrigin = vec2{ tileset.rect.x, tileset.rect.y };
+		constants.uvTile = tileSize / textureSize;
+		constants.columns = tileset.columns;
+
+		vkCmdPushConstants(
+			commandBuffer, pipeline->GetLayout(),
+			VK_SHADER_STAGE_VERTEX_BIT,
+			0, sizeof(ChunkConstants), &constants
+		);
+
+		const VkDeviceSize offset = 0;
+		for (const auto& layer : tilemap.layers) {
+			for (i32 y = minY; y < maxY; y++) {
+				for (i32 x = minX; x < maxX; x++) {
+					const Tilemap::Chunk& chunk = layer[static_cast<usize>(y) * chunks.x + x];
+					if (chunk.count == 0) {
+						continue;
+					}
+
+					const vec2 chunkOrigin = origin + vec2{ static_cast<f32>(x), static_cast<f32>(y) } * chunkSize;
+					vkCmdPushConstants(
+						commandBuffer, pipeline->GetLayout(),
+						VK_SHADER_STAGE_VERTEX_BIT,
+						offsetof(ChunkConstants, origin), sizeof(vec2), &chunkOrigin
+					);
+
+					VkBuffer buffer = tilemap.buffers[chunk.instances];
+					vkCmdBindVertexBuffers(commandBuffer, 0, 1, &buffer, &offset);
+					vkCmdDraw(commandBuffer, 6, chunk.count, 0, 0);
+
+					stats.chunks++;
+					stats.tiles += chunk.count;
+					stats.drawCalls++;
+				}
+			}
+		}
+
+		stats.cpuTime = global.time->CurrentTime() - start;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "GraphicsPipeline.h"
+#include "TextureSets.h"
+#include "Tilemap.h"
+
+namespace gfx {
+
+	//Draws the chunks of a Tilemap that overlap the view, one instanced draw per chunk and layer.
+	//Only visible chunks are visited, so the cost follows the view size instead of the map size
+	class TilemapRenderer {
+	public:
+		static constexpr u32 MAX_TILESETS = 64; //Descriptor sets per pool, more tilesets than that start another
+
+		struct Stats {
+			u32 chunks = 0;
+			u32 tiles = 0;
+			u32 drawCalls = 0;
+			f64 cpuTime = 0.0; //In ms
+		};
+
+		void Init(PipelineCache* cache, VkRenderPass renderPass);
+
+		//view is the visible area in pixels (min in xy, max in zw), origin is where tile (0, 0) is drawn
+		void Render(
+			VkCommandBuffer commandBuffer,
+			const Tilemap& tilemap,
+			const mat4& viewProj,
+			vec4 view,
+			vec2 origin = vec2{ 0.f }
+		);
+
+		inline const Stats& LastStats() const { return stats; }
+
+	private:
+		std::unique_ptr<GraphicsPipeline> pipeline;
+		std::unique_ptr<TextureSetCache> textureSets;
+
+		Stats stats;
+	};
+}
\ No newline at end of file
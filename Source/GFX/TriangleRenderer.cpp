@@ -1,5 +1,6 @@
 #include "TriangleRenderer.h"
 #include "Util\Time.h"
+#include "Util\File.h"
 #include "Renderer.h"
 #include "State.h"
 
@@ -57,12 +58,23 @@ namespace gfx {
 		vbuffer->Write((void*)vertices.data());
 		vbuffer->UnMap();
 
-		texture = Texture::Load(
-			"Resources\\statue.jpg",
-			VK_IMAGE_USAGE_SAMPLED_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-			vk::QueueFamilies::Graphics
-		);
+		//Prefer the baked container, the source image is only decoded if --bake hasn't been run
+		if (util::FileExists("Resources\\statue.ptex")) {
+			texture = Texture::LoadContainer(
+				"Resources\\statue.ptex",
+				VK_IMAGE_USAGE_SAMPLED_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				vk::QueueFamilies::Graphics
+			);
+		}
+		else {
+			texture = Texture::Load(
+				"Resources\\statue.jpg",
+				VK_IMAGE_USAGE_SAMPLED_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				vk::QueueFamilies::Graphics
+			);
+		}
 
 		uniforms.resize(vk::MAX_FRAMES_IN_FLIGHT);
 		sets.resize(vk::MAX_FRAMES_IN_FLIGHT);
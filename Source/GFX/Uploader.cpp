@@ -0,0 +1,447 @@
+#include "Uploader.h"
+#include "Texture.h"
+#include "Platform\Platform.h"
+#include "State.h"
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize align) {
+	return align > 1 ? (value + align - 1) / align * align : value;
+}
+
+namespace gfx {
+
+	Uploader::Uploader(VkDeviceSize stagingSize) : ringSize(stagingSize) {
+		const auto& device = *global.platform->device;
+		const auto indices = device.GetQueueFamilyIndices();
+		transferFamily = *indices.transferFamily;
+		graphicsFamily = *indices.graphicsFamily;
+		separateQueue = device.HasTransferQueue();
+
+		//Region copies read the ring from the graphics queue
+		staging = std::make_unique<Buffer>(
+			1, ringSize,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			vk::QueueFamilies::Transfer | vk::QueueFamilies::Graphics
+		);
+		mapped = reinterpret_cast<u8*>(staging->Map());
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = transferFamily;
+
+		VULKAN_CHECK(vkCreateCommandPool(device, &poolInfo, nullptr, &transferPool),
+			"Failed to create upload command pool!");
+
+		if (separateQueue) {
+			poolInfo.queueFamilyIndex = graphicsFamily;
+			VULKAN_CHECK(vkCreateCommandPool(device, &poolInfo, nullptr, &graphicsPool),
+				"Failed to create upload command pool!");
+		}
+		else {
+			graphicsPool = transferPool;
+		}
+
+		LOGNG(util::Logger::GFX, "Uploading through $ MiB staging ring on the $ queue.",
+			ringSize / (1024 * 1024), separateQueue ? "transfer" : "graphics");
+	}
+
+	Uploader::~Uploader() {
+		WaitIdle();
+
+		const VkDevice device = *global.platform->device;
+		for (auto& batch : freeBatches) {
+			vkDestroyFence(device, batch.fence, nullptr);
+			if (separateQueue) {
+				vkDestroySemaphore(device, batch.transferDone, nullptr);
+			}
+		}
+
+		if (separateQueue) {
+			vkDestroyCommandPool(device, graphicsPool, nullptr);
+		}
+		vkDestroyCommandPool(device, transferPool, nullptr);
+	}
+
+	Uploader::Batch& Uploader::Current() {
+		if (current) {
+			return *current;
+		}
+
+		const VkDevice device = *global.platform->device;
+
+		Batch batch;
+		if (!freeBatches.empty()) {
+			batch = std::move(freeBatches.back());
+			freeBatches.pop_back();
+		}
+		else {
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			allocInfo.commandPool = transferPool;
+
+			VULKAN_CHECK(vkAllocateCommandBuffers(device, &allocInfo, &batch.transferCommands),
+				"Failed to allocate upload command buffer!");
+
+			if (separateQueue) {
+				allocInfo.commandPool = graphicsPool;
+				VULKAN_CHECK(vkAllocateCommandBuffers(device, &allocInfo, &batch.graphicsCommands),
+					"Failed to allocate upload command buffer!");
+
+				VkSemaphoreCreateInfo semaphoreInfo{};
+				semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+				VULKAN_CHECK(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &batch.transferDone),
+					"Failed to create upload semaphore!");
+			}
+			else {
+				batch.graphicsCommands = batch.transferCommands;
+			}
+
+			VkFenceCreateInfo fenceInfo{};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+			VULKAN_CHECK(vkCreateFence(device, &fenceInfo, nullptr, &batch.fence),
+				"Failed to create upload fence!");
+		}
+
+		batch.ticket = nextTicket;
+		batch.copies = 0;
+		batch.transferTextures.emplace(batch.transferCommands);
+		if (separateQueue) {
+			batch.graphicsTextures.emplace(batch.graphicsCommands);
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		VULKAN_CHECK(vkBeginCommandBuffer(batch.transferCommands, &beginInfo),
+			"Failed to begin upload command buffer!");
+		if (separateQueue) {
+			VULKAN_CHECK(vkBeginCommandBuffer(batch.graphicsCommands, &beginInfo),
+				"Failed to begin upload command buffer!");
+		}
+
+		current = std::move(batch);
+		return *current;
+	}
+
+	//Record the copy for a Staging before staging anything else, since running out of ring space submits the current batch
+	Uploader::Staging Uploader::Stage(VkDeviceSize size, VkDeviceSize align) {
+		if (size > ringSize) {
+			auto buffer = std::make_unique<Buffer>(
+				1, size,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+				vk::QueueFamilies::Transfer
+			);
+
+			Staging src{ reinterpret_cast<u8*>(buffer->Map()), *buffer, 0, size };
+			Current().oversized.push_back(std::move(buffer));
+			return src;
+		}
+
+		while (true) {
+			const u64 phys = head % ringSize;
+			u64 pos = head + (AlignUp(phys, align) - phys);
+			if (pos % ringSize + size > ringSize) {
+				//Doesn't fit before the end of the ring, skip to the start
+				pos = head - phys + ringSize;
+			}
+
+			if (pos + size - tail <= ringSize) {
+				head = pos + size;
+				Current();
+				return Staging{ mapped + pos % ringSize, *staging, pos % ringSize, size };
+			}
+
+			if (current) {
+				Submit();
+			}
+			else if (!inFlight.empty()) {
+				WaitOldest();
+			}
+			else {
+				//Nothing holds on to the ring anymore
+				head = tail = 0;
+			}
+		}
+	}
+
+	Uploader::Ticket Uploader::CopyToBuffer(
+		const Staging& src,
+		const Buffer& dst,
+		VkDeviceSize dstOffset,
+		VkPipelineStageFlags dstStages,
+		VkAccessFlags dstAccess
+	) {
+		Batch& batch = Current();
+
+		VkBufferCopy copy{};
+		copy.srcOffset = src.offset;
+		copy.dstOffset = dstOffset;
+		copy.size = src.size;
+		vkCmdCopyBuffer(batch.transferCommands, src.buffer, dst, 1, &copy);
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.buffer = dst;
+		barrier.offset = dstOffset;
+		barrier.size = src.size;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+		if (!separateQueue) {
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = dstAccess;
+
+			vkCmdPipelineBarrier(
+				batch.graphicsCommands,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, dstStages,
+				0,
+				0, nullptr,
+				1, &barrier,
+				0, nullptr
+			);
+		}
+		else if (!global.platform->device->IsConcurrent(dst.QueueFamilies())) {
+			//Release on the transfer queue, acquire on the graphics queue
+			barrier.srcQueueFamilyIndex = transferFamily;
+			barrier.dstQueueFamilyIndex = graphicsFamily;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = 0;
+
+			vkCmdPipelineBarrier(
+				batch.transferCommands,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				0,
+				0, nullptr,
+				1, &barrier,
+				0, nullptr
+			);
+
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = dstAccess;
+
+			vkCmdPipelineBarrier(
+				batch.graphicsCommands,
+				VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStages,
+				0,
+				0, nullptr,
+				1, &barrier,
+				0, nullptr
+			);
+		}
+
+		batch.copies++;
+		return batch.ticket;
+	}
+
+	Uploader::Ticket Uploader::CopyToImage(
+		const Staging& src,
+		Texture& dst,
+		uint32_t dataLevels,
+		VkImageLayout finalLayout
+	) {
+		ASSERT(dataLevels == 1 || dataLevels == dst.MipLevels(),
+			"Uploads must either contain a single level or the full mip chain!");
+
+		ASSERT(vk::FormatSize(dst.Format()) != 0, "Unsupported upload format " + vk::ToString(dst.Format()) + "!");
+
+		VkDeviceSize size = 0;
+		for (uint32_t level = 0; level < dataLevels; level++) {
+			size += dst.LevelSize(level);
+		}
+		ASSERT(size <= src.size, "Image upload is larger than its staging memory!");
+
+		Batch& batch = Current();
+		TextureBatch& graphics = separateQueue ? *batch.graphicsTextures : *batch.transferTextures;
+
+		batch.transferTextures->Copy(dst, src.buffer, src.offset, dataLevels);
+
+		if (separateQueue && !global.platform->device->IsConcurrent(dst.QueueFamilies())) {
+			//Hand the image over to the graphics queue, which does the blits and final transition
+			batch.transferTextures->Release(dst, transferFamily, graphicsFamily);
+			graphics.Acquire(dst, transferFamily, graphicsFamily);
+		}
+
+		if (dataLevels < dst.MipLevels()) {
+			graphics.GenerateMipmaps(dst, finalLayout);
+		}
+		else {
+			graphics.Transition(dst, finalLayout);
+		}
+
+		dst.uploadTicket = batch.ticket;
+		batch.copies++;
+		return batch.ticket;
+	}
+
+	Uploader::Ticket Uploader::CopyToImageRegion(
+		const Staging& src,
+		Texture& dst,
+		VkOffset3D offset,
+		VkExtent3D extent,
+		VkImageLayout finalLayout
+	) {
+		ASSERT(static_cast<VkDeviceSize>(extent.width) * extent.height * extent.depth * dst.ArrayLayers()
+			* vk::FormatSize(dst.Format()) <= src.size, "Image region upload is larger than its staging memory!");
+
+		//Recorded on the graphics queue, earlier frames may still be sampling the rest of the image
+		//and a queue ownership transfer would throw its contents away
+		Batch& batch = Current();
+		TextureBatch& graphics = separateQueue ? *batch.graphicsTextures : *batch.transferTextures;
+
+		graphics.CopyRegion(dst, src.buffer, src.offset, offset, extent);
+		graphics.Transition(dst, finalLayout);
+
+		dst.uploadTicket = batch.ticket;
+		batch.copies++;
+		return batch.ticket;
+	}
+
+	Uploader::Ticket Uploader::UploadBuffer(
+		const Buffer& dst,
+		const void* data,
+		VkDeviceSize size,
+		VkDeviceSize dstOffset,
+		VkPipelineStageFlags dstStages,
+		VkAccessFlags dstAccess
+	) {
+		Staging src = Stage(size, 4);
+		std::memcpy(src.data, data, size);
+		return CopyToBuffer(src, dst, dstOffset, dstStages, dstAccess);
+	}
+
+	Uploader::Ticket Uploader::UploadImage(
+		Texture& dst,
+		const void* data,
+		VkDeviceSize size,
+		uint32_t dataLevels,
+		VkImageLayout finalLayout
+	) {
+		Staging src = Stage(size, math::Max(vk::FormatSize(dst.Format()), 4u));
+		std::memcpy(src.data, data, size);
+		return CopyToImage(src, dst, dataLevels, finalLayout);
+	}
+
+	Uploader::Ticket Uploader::UploadImageRegion(
+		Texture& dst,
+		const void* data,
+		VkOffset3D offset,
+		VkExtent3D extent,
+		VkImageLayout finalLayout
+	) {
+		const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * extent.depth
+			* dst.ArrayLayers() * vk::FormatSize(dst.Format());
+
+		Staging src = Stage(size, math::Max(vk::FormatSize(dst.Format()), 4u));
+		std::memcpy(src.data, data, size);
+		return CopyToImageRegion(src, dst, offset, extent, finalLayout);
+	}
+
+	Uploader::Ticket Uploader::Submit() {
+		if (!current) {
+			return nextTicket - 1;
+		}
+
+		Batch batch = std::move(*current);
+		current.reset();
+		batch.ringEnd = head;
+
+		//All image work in the batch shares a handful of barriers
+		batch.transferTextures->Record();
+		if (separateQueue) {
+			batch.graphicsTextures->Record();
+		}
+
+		VULKAN_CHECK(vkEndCommandBuffer(batch.transferCommands),
+			"Failed to end upload command buffer!");
+
+		const auto& device = *global.platform->device;
+		if (separateQueue) {
+			VULKAN_CHECK(vkEndCommandBuffer(batch.graphicsCommands),
+				"Failed to end upload command buffer!");
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &batch.transferCommands;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &batch.transferDone;
+
+			VULKAN_CHECK(vkQueueSubmit(device.TransferQueue(), 1, &submitInfo, VK_NULL_HANDLE),
+				"Failed to submit upload batch!");
+
+			VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			submitInfo = VkSubmitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &batch.graphicsCommands;
+			submitInfo.waitSemaphoreCount = 1;
+			submitInfo.pWaitSemaphores = &batch.transferDone;
+			submitInfo.pWaitDstStageMask = &waitStage;
+
+			VULKAN_CHECK(vkQueueSubmit(device.GraphicsQueue(), 1, &submitInfo, batch.fence),
+				"Failed to submit upload batch!");
+		}
+		else {
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &batch.transferCommands;
+
+			VULKAN_CHECK(vkQueueSubmit(device.GraphicsQueue(), 1, &submitInfo, batch.fence),
+				"Failed to submit upload batch!");
+		}
+
+		nextTicket++;
+
+		Ticket ticket = batch.ticket;
+		inFlight.push_back(std::move(batch));
+		return ticket;
+	}
+
+	void Uploader::Retire(Batch& batch) {
+		VULKAN_CHECK(vkResetFences(*global.platform->device, 1, &batch.fence),
+			"Failed to reset upload fence!");
+
+		tail = batch.ringEnd;
+		completed = batch.ticket;
+		batch.oversized.clear();
+
+		freeBatches.push_back(std::move(batch));
+	}
+
+	void Uploader::WaitOldest() {
+		Batch& batch = inFlight.front();
+		VULKAN_CHECK(vkWaitForFences(*global.platform->device, 1, &batch.fence, VK_TRUE, UINT64_MAX),
+			"Failed to wait for upload batch!");
+
+		Retire(batch);
+		inFlight.pop_front();
+	}
+
+	void Uploader::Update() {
+		while (!inFlight.empty()
+			&& vkGetFenceStatus(*global.platform->device, inFlight.front().fence) == VK_SUCCESS) {
+			Retire(inFlight.front());
+			inFlight.pop_front();
+		}
+	}
+
+	void Uploader::Wait(Ticket ticket) {
+		if (current && ticket >= current->ticket) {
+			Submit();
+		}
+
+		while (!IsComplete(ticket) && !inFlight.empty()) {
+			WaitOldest();
+		}
+	}
+
+	void Uploader::WaitIdle() {
+		Wait(current ? current->ticket : nextTicket - 1);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Buffer.h"
+#include "TextureBatch.h"
+
+namespace gfx {
+
+	class Texture;
+
+	//Streams buffer and image data to the GPU through a persistently mapped staging ring.
+	//Copies are batched into one submit on the transfer queue (or the graphics queue if the
+	//device has no separate transfer family), and each batch is tracked with a fence so
+	//callers get a ticket back instead of stalling on vkQueueWaitIdle.
+	class Uploader {
+	public:
+		using Ticket = u64;
+
+		static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 32ull * 1024ull * 1024ull;
+
+		//A chunk of staging memory that can be written to directly before recording a copy
+		struct Staging {
+			u8* data = nullptr;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			VkDeviceSize size = 0;
+		};
+
+		Uploader(VkDeviceSize stagingSize = DEFAULT_STAGING_SIZE);
+		~Uploader();
+
+		Uploader(const Uploader& other) = delete;
+		Uploader& operator=(const Uploader& other) = delete;
+
+		//Reserves staging memory in the current batch, flushing and waiting on old batches if the ring is full
+		Staging Stage(VkDeviceSize size, VkDeviceSize align = 16);
+
+		Ticket CopyToBuffer(
+			const Staging& src,
+			const Buffer& dst,
+			VkDeviceSize dstOffset = 0,
+			VkPipelineStageFlags dstStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			VkAccessFlags dstAccess = VK_ACCESS_MEMORY_READ_BIT
+		);
+
+		//src holds dataLevels tightly packed mip levels, the rest of the chain is generated with blits.
+		//Image work is recorded on Submit, so dst has to stay alive until then
+		Ticket CopyToImage(
+			const Staging& src,
+			Texture& dst,
+			uint32_t dataLevels = 1,
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		);
+
+		//src holds a tightly packed block that is copied into part of level 0, the rest of dst is kept
+		Ticket CopyToImageRegion(
+			const Staging& src,
+			Texture& dst,
+			VkOffset3D offset,
+			VkExtent3D extent,
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		);
+
+		Ticket UploadBuffer(
+			const Buffer& dst,
+			const void* data,
+			VkDeviceSize size,
+			VkDeviceSize dstOffset = 0,
+			VkPipelineStageFlags dstStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			VkAccessFlags dstAccess = VK_ACCESS_MEMORY_READ_BIT
+		);
+
+		Ticket UploadImage(
+			Texture& dst,
+			const void* data,
+			VkDeviceSize size,
+			uint32_t dataLevels = 1,
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		);
+
+		Ticket UploadImageRegion(
+			Texture& dst,
+			const void* data,
+			VkOffset3D offset,
+			VkExtent3D extent,
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		);
+
+		//Submits everything recorded so far, returns the ticket of the submitted batch
+		Ticket Submit();
+
+		//Retires finished batches and recycles their staging memory, never blocks
+		void Update();
+
+		b8 IsComplete(Ticket ticket) const { return ticket <= completed; }
+		void Wait(Ticket ticket);
+		void WaitIdle();
+
+		inline Ticket CurrentTicket() const { return nextTicket; }
+		inline Ticket CompletedTicket() const { return completed; }
+
+		inline VkDeviceSize StagingSize() const { return ringSize; }
+		inline VkDeviceSize StagingUsed() const { return head - tail; }
+
+	private:
+		struct Batch {
+			Ticket ticket = 0;
+			VkCommandBuffer transferCommands = VK_NULL_HANDLE;
+			VkCommandBuffer graphicsCommands = VK_NULL_HANDLE; //Same as transferCommands without a transfer queue
+			VkSemaphore transferDone = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+
+			std::optional<TextureBatch> transferTextures;
+			std::optional<TextureBatch> graphicsTextures; //Only used with a transfer queue
+
+			u64 ringEnd = 0;
+			u32 copies = 0;
+			std::vector<std::unique_ptr<Buffer>> oversized;
+		};
+
+		Batch& Current();
+		void Retire(Batch& batch);
+		void WaitOldest();
+
+		VkDeviceSize ringSize;
+		std::unique_ptr<Buffer> staging;
+		u8* mapped;
+
+		//Virtual offsets that only ever grow, physical offset is offset % ringSize
+		u64 head = 0;
+		u64 tail = 0;
+
+		VkCommandPool transferPool;
+		VkCommandPool graphicsPool;
+		uint32_t transferFamily, graphicsFamily;
+		b8 separateQueue;
+
+		std::optional<Batch> current;
+		std::deque<Batch> inFlight;
+		std::vector<Batch> freeBatches;
+
+		Ticket nextTicket = 1;
+		Ticket completed = 0;
+	};
+}
\ No newline at end of file
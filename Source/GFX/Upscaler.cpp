@@ -0,0 +1,171 @@
+#include "Upscaler.h"
+#include "Platform\Platform.h"
+#include "State.h"
+
+namespace gfx {
+
+	namespace {
+		//Matches the push constant block in composite.frag
+		struct UpscaleConstants {
+			vec2 sourceSize;
+			vec2 scale;
+		};
+	}
+
+	Upscaler::~Upscaler() {
+		if (sampler != VK_NULL_HANDLE) {
+			vkDestroySampler(*global.platform->device, sampler, nullptr);
+		}
+	}
+
+	void Upscaler::Init(PipelineCache* cache, VkRenderPass renderPass, const RenderTarget& source, uvec2 size) {
+		sourceSize = size;
+
+		const u32 imageCount = source.NumViews();
+
+		pool = DescriptorPool::Builder()
+			.SetMaxSets(imageCount)
+			.AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageCount)
+			.Create();
+
+		layout = DescriptorSetLayout::Builder()
+			.AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+				VK_SHADER_STAGE_FRAGMENT_BIT)
+			.Create();
+
+		Pipeline::LayoutSettings layoutSettings;
+		layoutSettings.sets.push_back(*layout);
+		layoutSettings.ranges.push_back(VkPushConstantRange{ VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(UpscaleConstants) });
+
+		Shader vertShader{ "Shaders\\composite.vert.spv", VK_SHADER_STAGE_VERTEX_BIT };
+		Shader fragShader{ "Shaders\\composite.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT };
+
+		//No vertex input, the triangle is built from gl_VertexIndex
+		auto settings = GraphicsPipeline::DefaultSettings(vertShader, fragShader, renderPass);
+
+		pipeline = std::make_unique<GraphicsPipeline>(layoutSettings, settings, cache);
+
+		//Linear filtering is what makes the sharp bilinear edges, integer scales only ever sample texel centers
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.maxLod = 0.f;
+
+		VULKAN_CHECK(vkCreateSampler(
+			*global.platform->device,
+			&samplerInfo,
+			nullptr,
+			&sampler
+		), "Failed to create upscale sampler!");
+
+		//The source has one image per swapchain image, so each set always reads the same image
+		sets.resize(imageCount);
+		for (u32 i = 0; i < imageCount; i++) {
+			VkDescriptorImageInfo info = source.GetDescriptorInfo(i);
+			info.sampler = sampler;
+
+			VULKAN_CHECK(
+				DescriptorBuilder(*pool, *layout)
+				.WriteImage(0, info)
+				.Build(sets[i]),
+				"Failed to write upscale descriptor set!"
+			);
+		}
+	}
+
+	void Upscaler::SetSource(const RenderTarget& source) {
+		ASSERT(source.NumViews() == sets.size(), "Upscale source changed its image count!");
+
+		for (u32 i = 0; i < sets.size(); i++) {
+			VkDescriptorImageInfo info = source.GetDescriptorInfo(i);
+			info.sampler = sampler;
+
+			DescriptorBuilder(*pool, *layout)
+				.WriteImage(0, info)
+				.Overwrite(sets[i]);
+		}
+	}
+
+	f32 Upscaler::Scale(uvec2 windowSize) const {
+		const f32 fit = math::Min(
+			static_cast<f32>(windowSize.x) / static_cast<f32>(sourceSize.x),
+			static_cast<f32>(windowSize.y) / static_cast<f32>(sourceSize.y)
+		);
+
+		//A window smaller than the virtual resolution can't fit a whole multiple, so it falls back to sharp bilinear
+		if (mode == util::Configuration::Upscale::Integer && fit >= 1.f) {
+			return math::Floor(fit);
+		}
+
+		return fit;
+	}
+
+	vec4 Upscaler::DestinationRect(uvec2 windowSize) const {
+		const f32 scale = Scale(windowSize);
+		const vec2 size = static_cast<vec2>(sourceSize) * scale;
+
+		//Snapped to whole pixels so the texel grid lines up with the window's
+		const vec2 offset{
+			math::Floor((static_cast<f32>(windowSize.x) - size.x) * 0.5f),
+			math::Floor((static_cast<f32>(windowSize.y) - size.y) * 0.5f)
+		};
+
+		return vec4{ offset.x, offset.y, size.x, size.y };
+	}
+
+	void Upscaler::Render(VkCommandBuffer commandBuffer, uint32_t imageIndex, uvec2 windowSize) {
+		const vec4 rect = DestinationRect(windowSize);
+
+		//The pass cleared the whole window, drawing only inside the rect leaves black bars around it
+		VkViewport viewport{};
+		viewport.x = rect.x;
+		viewport.y = rect.y;
+		viewport.width = rect.z;
+		viewport.height = rect.w;
+		viewport.minDepth = 0.f;
+		viewport.maxDepth = 1.f;
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+		const uvec2 scissorOffset{
+			static_cast<u32>(math::Max(rect.x, 0.f)),
+			static_cast<u32>(math::Max(rect.y, 0.f))
+		};
+
+		VkRect2D scissor{};
+		scissor.offset = { static_cast<i32>(scissorOffset.x), static_cast<i32>(scissorOffset.y) };
+		scissor.extent = {
+			math::Min(static_cast<u32>(math::Ceil(rect.z)), windowSize.x - scissorOffset.x),
+			math::Min(static_cast<u32>(math::Ceil(rect.w)), windowSize.y - scissorOffset.y)
+		};
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		pipeline->Bind(commandBuffer);
+
+		vkCmdBindDescriptorSets(
+			commandBuffer,
+			pipeline->BindPoint(), pipeline->GetLayout(),
+			0,
+			1, &sets[imageIndex],
+			0, nullptr
+		);
+
+		const f32 scale = Scale(windowSize);
+
+		UpscaleConstants constants{};
+		constants.sourceSize = static_cast<vec2>(sourceSize);
+		constants.scale = vec2{ scale, scale };
+
+		vkCmdPushConstants(
+			commandBuffer, pipeline->GetLayout(),
+			VK_SHADER_STAGE_FRAGMENT_BIT,
+			0, sizeof(UpscaleConstants), &constants
+		);
+
+		vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+	}
+}
\ No newline at end of file
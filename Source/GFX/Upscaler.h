@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GraphicsPipeline.h"
+#include "Descriptors.h"
+#include "RenderTarget.h"
+#include "Util\Configuration.h"
+
+namespace gfx {
+
+	//Draws the virtual resolution scene into the swapchain pass. Integer mode uses the largest
+	//whole scale that fits and letterboxes the rest, sharp bilinear fills the window keeping
+	//the aspect ratio and only blends across texel edges so pixels stay square
+	class Upscaler {
+	public:
+		Upscaler() = default;
+		~Upscaler();
+
+		Upscaler(const Upscaler& other) = delete;
+		Upscaler& operator=(const Upscaler& other) = delete;
+
+		//source has to stay alive and keep its size for as long as the upscaler is used
+		void Init(PipelineCache* cache, VkRenderPass renderPass, const RenderTarget& source, uvec2 sourceSize);
+
+		//Points the descriptor sets at new views, after the source was recreated
+		void SetSource(const RenderTarget& source);
+
+		//Must be called inside the swapchain pass, imageIndex picks the source image
+		void Render(VkCommandBuffer commandBuffer, uint32_t imageIndex, uvec2 windowSize);
+
+		inline void SetMode(util::Configuration::Upscale newMode) { mode = newMode; }
+
+		//Where the scene ends up in the window (offset in xy, size in zw) and the scale used
+		vec4 DestinationRect(uvec2 windowSize) const;
+		f32 Scale(uvec2 windowSize) const;
+
+	private:
+		std::unique_ptr<GraphicsPipeline> pipeline;
+		std::unique_ptr<DescriptorPool> pool;
+		std::unique_ptr<DescriptorSetLayout> layout;
+		std::vector<VkDescriptorSet> sets;
+		VkSampler sampler = VK_NULL_HANDLE;
+
+		uvec2 sourceSize;
+		util::Configuration::Upscale mode = util::Configuration::Upscale::Integer;
+	};
+}
\ No newline at end of file
@@ -49,4 +49,52 @@ namespace gfx {
 			.offset = offsetof(VertexPosColorUv, uv)
 		}
 	};
+
+	const VkVertexInputBindingDescription SpriteInstance::Binding = {
+		.binding = 0,
+		.stride = sizeof(SpriteInstance),
+		.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE
+	};
+
+	const std::vector<VkVertexInputAttributeDescription> SpriteInstance::Attributes = {
+		{
+			.location = 0,
+			.binding = 0,
+			.format = VK_FORMAT_R32G32_SFLOAT,
+			.offset = offsetof(SpriteInstance, pos)
+		},
+		{
+			.location = 1,
+			.binding = 0,
+			.format = VK_FORMAT_R32G32_SFLOAT,
+			.offset = offsetof(SpriteInstance, size)
+		},
+		{
+			.location = 2,
+			.binding = 0,
+			.format = VK_FORMAT_R32G32B32A32_SFLOAT,
+			.offset = offsetof(SpriteInstance, rect)
+		},
+		{
+			.location = 3,
+			.binding = 0,
+			.format = VK_FORMAT_R8G8B8A8_UNORM,
+			.offset = offsetof(SpriteInstance, tint)
+		}
+	};
+
+	const VkVertexInputBindingDescription TileInstance::Binding = {
+		.binding = 0,
+		.stride = sizeof(TileInstance),
+		.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE
+	};
+
+	const std::vector<VkVertexInputAttributeDescription> TileInstance::Attributes = {
+		{
+			.location = 0,
+			.binding = 0,
+			.format = VK_FORMAT_R32_UINT,
+			.offset = offsetof(TileInstance, packed)
+		}
+	};
 }
\ No newline at end of file
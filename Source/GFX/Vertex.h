@@ -31,4 +31,25 @@ namespace gfx {
 
 		static const std::vector<VkVertexInputAttributeDescription> Attributes;
 	};
+
+	//Per-instance data for SpriteBatch, the quad corners are generated from gl_VertexIndex
+	struct SpriteInstance {
+		vec2 pos;
+		vec2 size;
+		vec4 rect; //uv min in xy, uv max in zw
+		u32 tint; //RGBA8
+
+		static const VkVertexInputBindingDescription Binding;
+
+		static const std::vector<VkVertexInputAttributeDescription> Attributes;
+	};
+
+	//Per-instance data for a tilemap chunk, x | y << 8 | tile << 16 with x and y inside the chunk
+	struct TileInstance {
+		u32 packed;
+
+		static const VkVertexInputBindingDescription Binding;
+
+		static const std::vector<VkVertexInputAttributeDescription> Attributes;
+	};
 }
\ No newline at end of file
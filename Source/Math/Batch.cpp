@@ -0,0 +1,237 @@
+#include "Batch.h"
+
+#if defined(MATH_SIMD_SSE)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace math::batch {
+
+	namespace scalar {
+
+		//The same work one vec or mat at a time, like code without the batch functions would do it
+		static void Transform2(const f32* m, const f32* x, const f32* y, f32* outX, f32* outY, usize count) {
+			const mat3 matrix{ vec3{ m[0], m[1], m[2] }, vec3{ m[3], m[4], m[5] }, vec3{ m[6], m[7], m[8] } };
+			for (usize i = 0; i < count; i++) {
+				const vec3 p = matrix * vec3{ x[i], y[i], 1.f };
+				outX[i] = p.x;
+				outY[i] = p.y;
+			}
+		}
+
+		static void Transform3(const f32* m, const f32* x, const f32* y, const f32* z, f32* outX, f32* outY, f32* outZ, usize count) {
+			const mat4 matrix{
+				vec4{ m[0], m[1], m[2], m[3] }, vec4{ m[4], m[5], m[6], m[7] },
+				vec4{ m[8], m[9], m[10], m[11] }, vec4{ m[12], m[13], m[14], m[15] }
+			};
+			for (usize i = 0; i < count; i++) {
+				const vec4 p = matrix * vec4{ x[i], y[i], z[i], 1.f };
+				outX[i] = p.x;
+				outY[i] = p.y;
+				outZ[i] = p.z;
+			}
+		}
+
+		static void MinMax(const f32* values, usize count, f32& min, f32& max) {
+			f32 low = MAX_FLOAT, high = -MAX_FLOAT;
+			for (usize i = 0; i < count; i++) {
+				low = Min(low, values[i]);
+				high = Max(high, values[i]);
+			}
+			min = low;
+			max = high;
+		}
+
+		static void Lerp(const f32* a, const f32* b, f32 t, f32* out, usize count) {
+			for (usize i = 0; i < count; i++) {
+				out[i] = a[i] + (b[i] - a[i]) * t;
+			}
+		}
+
+		static void Normalize2(const f32* x, const f32* y, f32* outX, f32* outY, usize count) {
+			for (usize i = 0; i < count; i++) {
+				const vec2 v = Normalize(vec2{ x[i], y[i] });
+				outX[i] = v.x;
+				outY[i] = v.y;
+			}
+		}
+
+		static void Normalize3(const f32* x, const f32* y, const f32* z, f32* outX, f32* outY, f32* outZ, usize count) {
+			for (usize i = 0; i < count; i++) {
+				const vec3 v = Normalize(vec3{ x[i], y[i], z[i] });
+				outX[i] = v.x;
+				outY[i] = v.y;
+				outZ[i] = v.z;
+			}
+		}
+
+		static void Dot2(const f32* ax, const f32* ay, const f32* bx, const f32* by, f32* out, usize count) {
+			for (usize i = 0; i < count; i++) {
+				out[i] = math::Dot(vec2{ ax[i], ay[i] }, vec2{ bx[i], by[i] });
+			}
+		}
+
+		static void Dot3(const f32* ax, const f32* ay, const f32* az, const f32* bx, const f32* by, const f32* bz, f32* out, usize count) {
+			for (usize i = 0; i < count; i++) {
+				out[i] = math::Dot(vec3{ ax[i], ay[i], az[i] }, vec3{ bx[i], by[i], bz[i] });
+			}
+		}
+
+		static constexpr detail::Kernels KERNELS{ Transform2, Transform3, MinMax, Lerp, Normalize2, Normalize3, Dot2, Dot3 };
+	}
+
+	static Level Detect() {
+#if defined(MATH_SIMD_SSE)
+		u32 info[4]{};
+		auto cpuid = [&info](u32 leaf, u32 subleaf) {
+#if defined(_MSC_VER)
+			__cpuidex(reinterpret_cast<int*>(info), static_cast<int>(leaf), static_cast<int>(subleaf));
+#else
+			__cpuid_count(leaf, subleaf, info[0], info[1], info[2], info[3]);
+#endif
+		};
+
+		cpuid(0, 0);
+		const u32 maxLeaf = info[0];
+
+		cpuid(1, 0);
+		const b8 osxsave = info[2] & (1u << 27);
+		const b8 fma = info[2] & (1u << 12);
+		if (!osxsave || maxLeaf < 7) {
+			return Level::SSE2;
+		}
+
+		//The OS also has to save the wider registers on context switches
+#if defined(_MSC_VER)
+		const u64 xcr0 = _xgetbv(0);
+#else
+		u32 xcr0Low, xcr0High;
+		__asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+		const u64 xcr0 = (static_cast<u64>(xcr0High) << 32) | xcr0Low;
+#endif
+
+		cpuid(7, 0);
+		const b8 avx2 = info[1] & (1u << 5);
+		const b8 avx512 = info[1] & (1u << 16);
+		if (avx512 && fma && (xcr0 & 0xE6) == 0xE6) {
+			return Level::AVX512;
+		}
+		if (avx2 && fma && (xcr0 & 0x6) == 0x6) {
+			return Level::AVX2;
+		}
+		return Level::SSE2;
+#else
+		return Level::Scalar;
+#endif
+	}
+
+	static const detail::Kernels& KernelsFor(Level level) {
+		switch (level) {
+#if defined(MATH_SIMD_SSE)
+		case Level::SSE2:
+			return detail::SSE2_KERNELS;
+		case Level::AVX2:
+			return detail::AVX2_KERNELS;
+		case Level::AVX512:
+			return detail::AVX512_KERNELS;
+#endif
+		default:
+			return scalar::KERNELS;
+		}
+	}
+
+	static const Level supported = Detect();
+	static Level current = supported;
+	static const detail::Kernels* kernels = &KernelsFor(supported);
+
+	Level Supported() {
+		return supported;
+	}
+
+	Level Current() {
+		return current;
+	}
+
+	const char* LevelName(Level level) {
+		switch (level) {
+		case Level::SSE2:
+			return "SSE2";
+		case Level::AVX2:
+			return "AVX2";
+		case Level::AVX512:
+			return "AVX-512";
+		default:
+			return "scalar";
+		}
+	}
+
+	void SetLevel(Level level) {
+		current = static_cast<Level>(Min(static_cast<u32>(level), static_cast<u32>(supported)));
+		kernels = &KernelsFor(current);
+	}
+
+	void Transform(const mat3& m, std::span<const f32> x, std::span<const f32> y, std::span<f32> outX, std::span<f32> outY) {
+		ASSERT(y.size() == x.size() && outX.size() == x.size() && outY.size() == x.size(), "Batch spans differ in size!");
+		const f32 columns[9]{ m[0].x, m[0].y, m[0].z, m[1].x, m[1].y, m[1].z, m[2].x, m[2].y, m[2].z };
+		kernels->transform2(columns, x.data(), y.data(), outX.data(), outY.data(), x.size());
+	}
+
+	void Transform(const mat4& m,
+		std::span<const f32> x, std::span<const f32> y, std::span<const f32> z,
+		std::span<f32> outX, std::span<f32> outY, std::span<f32> outZ) {
+		ASSERT(y.size() == x.size() && z.size() == x.size() && outX.size() == x.size() && outY.size() == x.size() && outZ.size() == x.size(),
+			"Batch spans differ in size!");
+		f32 columns[16];
+		for (u32 c = 0; c < 4; c++) {
+			for (u32 r = 0; r < 4; r++) {
+				columns[c * 4 + r] = m[c][r];
+			}
+		}
+		kernels->transform3(columns, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), x.size());
+	}
+
+	void Bounds(std::span<const f32> x, std::span<const f32> y, vec2& min, vec2& max) {
+		ASSERT(y.size() == x.size(), "Batch spans differ in size!");
+		kernels->minMax(x.data(), x.size(), min.x, max.x);
+		kernels->minMax(y.data(), y.size(), min.y, max.y);
+	}
+
+	void Bounds(std::span<const f32> x, std::span<const f32> y, std::span<const f32> z, vec3& min, vec3& max) {
+		ASSERT(y.size() == x.size() && z.size() == x.size(), "Batch spans differ in size!");
+		kernels->minMax(x.data(), x.size(), min.x, max.x);
+		kernels->minMax(y.data(), y.size(), min.y, max.y);
+		kernels->minMax(z.data(), z.size(), min.z, max.z);
+	}
+
+	void Lerp(std::span<const f32> a, std::span<const f32> b, f32 t, std::span<f32> out) {
+		ASSERT(b.size() == a.size() && out.size() == a.size(), "Batch spans differ in size!");
+		kernels->lerp(a.data(), b.data(), t, out.data(), a.size());
+	}
+
+	void Normalize(std::span<const f32> x, std::span<const f32> y, std::span<f32> outX, std::span<f32> outY) {
+		ASSERT(y.size() == x.size() && outX.size() == x.size() && outY.size() == x.size(), "Batch spans differ in size!");
+		kernels->normalize2(x.data(), y.data(), outX.data(), outY.data(), x.size());
+	}
+
+	void Normalize(std::span<const f32> x, std::span<const f32> y, std::span<const f32> z,
+		std::span<f32> outX, std::span<f32> outY, std::span<f32> outZ) {
+		ASSERT(y.size() == x.size() && z.size() == x.size() && outX.size() == x.size() && outY.size() == x.size() && outZ.size() == x.size(),
+			"Batch spans differ in size!");
+		kernels->normalize3(x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), x.size());
+	}
+
+	void Dot(std::span<const f32> ax, std::span<const f32> ay, std::span<const f32> bx, std::span<const f32> by, std::span<f32> out) {
+		ASSERT(ay.size() == ax.size() && bx.size() == ax.size() && by.size() == ax.size() && out.size() == ax.size(), "Batch spans differ in size!");
+		kernels->dot2(ax.data(), ay.data(), bx.data(), by.data(), out.data(), ax.size());
+	}
+
+	void Dot(std::span<const f32> ax, std::span<const f32> ay, std::span<const f32> az,
+		std::span<const f32> bx, std::span<const f32> by, std::span<const f32> bz, std::span<f32> out) {
+		ASSERT(ay.size() == ax.size() && az.size() == ax.size() && bx.size() == ax.size() && by.size() == ax.size() && bz.size() == ax.size()
+			&& out.size() == ax.size(), "Batch spans differ in size!");
+		kernels->dot3(ax.data(), ay.data(), az.data(), bx.data(), by.data(), bz.data(), out.data(), ax.size());
+	}
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Math.h"
+
+//Kernels over structure of arrays streams, one span of floats per component, for transforming thousands of
+//points at once. The instruction set is picked at runtime from what the CPU supports. Every span passed to
+//one call must have the same size and outputs may be the same spans as the inputs
+namespace math::batch {
+
+	enum class Level : u32 {
+		Scalar, //The per element path through vec and mat, as a reference
+		SSE2,
+		AVX2,
+		AVX512
+	};
+
+	//Best level the CPU and OS support
+	Level Supported();
+	Level Current();
+	const char* LevelName(Level level);
+
+	//Clamped to Supported(), meant for startup and benchmarks, not while other threads run kernels
+	void SetLevel(Level level);
+
+	//Points with an implied z of 1 for mat3 or w of 1 for mat4, there is no perspective divide
+	void Transform(const mat3& m, std::span<const f32> x, std::span<const f32> y, std::span<f32> outX, std::span<f32> outY);
+	void Transform(const mat4& m,
+		std::span<const f32> x, std::span<const f32> y, std::span<const f32> z,
+		std::span<f32> outX, std::span<f32> outY, std::span<f32> outZ);
+
+	//Bounding box of all the points, empty spans give min = MAX_FLOAT and max = -MAX_FLOAT
+	void Bounds(std::span<const f32> x, std::span<const f32> y, vec2& min, vec2& max);
+	void Bounds(std::span<const f32> x, std::span<const f32> y, std::span<const f32> z, vec3& min, vec3& max);
+
+	void Lerp(std::span<const f32> a, std::span<const f32> b, f32 t, std::span<f32> out);
+
+	//Zero length vectors come out as NaN, same as Normalize()
+	void Normalize(std::span<const f32> x, std::span<const f32> y, std::span<f32> outX, std::span<f32> outY);
+	void Normalize(std::span<const f32> x, std::span<const f32> y, std::span<const f32> z,
+		std::span<f32> outX, std::span<f32> outY, std::span<f32> outZ);
+
+	void Dot(std::span<const f32> ax, std::span<const f32> ay, std::span<const f32> bx, std::span<const f32> by, std::span<f32> out);
+	void Dot(std::span<const f32> ax, std::span<const f32> ay, std::span<const f32> az,
+		std::span<const f32> bx, std::span<const f32> by, std::span<const f32> bz, std::span<f32> out);
+
+	namespace detail {
+
+		//One per level, matrices are column major with 9 or 16 floats
+		struct Kernels {
+			void (*transform2)(const f32* m, const f32* x, const f32* y, f32* outX, f32* outY, usize count);
+			void (*transform3)(const f32* m, const f32* x, const f32* y, const f32* z, f32* outX, f32* outY, f32* outZ, usize count);
+			void (*minMax)(const f32* values, usize count, f32& min, f32& max);
+			void (*lerp)(const f32* a, const f32* b, f32 t, f32* out, usize count);
+			void (*normalize2)(const f32* x, const f32* y, f32* outX, f32* outY, usize count);
+			void (*normalize3)(const f32* x, const f32* y, const f32* z, f32* outX, f32* outY, f32* outZ, usize count);
+			void (*dot2)(const f32* ax, const f32* ay, const f32* bx, const f32* by, f32* out, usize count);
+			void (*dot3)(const f32* ax, const f32* ay, const f32* az, const f32* bx, const f32* by, const f32* bz, f32* out, usize count);
+		};
+
+		//Only defined when building for x86
+		extern const Kernels SSE2_KERNELS;
+		extern const Kernels AVX2_KERNELS;
+		extern const Kernels AVX512_KERNELS;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "Batch.h"
+
+#if defined(MATH_SIMD_SSE)
+//MSVC takes AVX intrinsics anywhere, GCC and Clang only in functions built for it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace math::batch::avx2 {
+
+	struct Pack {
+		using Reg = __m256;
+		static constexpr usize WIDTH = 8;
+
+		static inline Reg Load(const f32* p) { return _mm256_loadu_ps(p); }
+		static inline void Store(f32* p, Reg r) { _mm256_storeu_ps(p, r); }
+		static inline Reg Set(f32 s) { return _mm256_set1_ps(s); }
+		static inline Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+		static inline Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+		static inline Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+		static inline Reg Div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+		static inline Reg MulAdd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+		static inline Reg Sqrt(Reg r) { return _mm256_sqrt_ps(r); }
+		static inline Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+		static inline Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+
+		static inline f32 ReduceMin(Reg r) {
+			__m128 half = _mm_min_ps(_mm256_castps256_ps128(r), _mm256_extractf128_ps(r, 1));
+			half = _mm_min_ps(half, _mm_movehl_ps(half, half));
+			return _mm_cvtss_f32(_mm_min_ss(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 1, 1, 1))));
+		}
+
+		static inline f32 ReduceMax(Reg r) {
+			__m128 half = _mm_max_ps(_mm256_castps256_ps128(r), _mm256_extractf128_ps(r, 1));
+			half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+			return _mm_cvtss_f32(_mm_max_ss(half, _mm_shuffle_ps(half, half, _MM_SHUFFLE(1, 1, 1, 1))));
+		}
+	};
+
+#include "BatchKernels.h"
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+namespace math::batch::detail {
+	const Kernels AVX2_KERNELS = avx2::KERNELS;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "Batch.h"
+
+#if defined(MATH_SIMD_SSE)
+//MSVC takes AVX-512 intrinsics anywhere, GCC and Clang only in functions built for it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+namespace math::batch::avx512 {
+
+	struct Pack {
+		using Reg = __m512;
+		static constexpr usize WIDTH = 16;
+
+		static inline Reg Load(const f32* p) { return _mm512_loadu_ps(p); }
+		static inline void Store(f32* p, Reg r) { _mm512_storeu_ps(p, r); }
+		static inline Reg Set(f32 s) { return _mm512_set1_ps(s); }
+		static inline Reg Add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+		static inline Reg Sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+		static inline Reg Mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+		static inline Reg Div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+		static inline Reg MulAdd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+		static inline Reg Sqrt(Reg r) { return _mm512_sqrt_ps(r); }
+		static inline Reg Min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+		static inline Reg Max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+		static inline f32 ReduceMin(Reg r) { return _mm512_reduce_min_ps(r); }
+		static inline f32 ReduceMax(Reg r) { return _mm512_reduce_max_ps(r); }
+	};
+
+#include "BatchKernels.h"
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+namespace math::batch::detail {
+	const Kernels AVX512_KERNELS = avx512::KERNELS;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+//No include guard, this is included inside a namespace once per instruction set by the Batch*.cpp files after
+//they define Pack: Pack::Reg holds Pack::WIDTH floats and Pack has Load, Store, Set, Add, Sub, Mul, Div,
+//MulAdd (a * b + c), Sqrt, Min, Max, ReduceMin and ReduceMax. Everything here gets compiled for that
+//instruction set, so nothing can live outside of the namespace or the linker could mix them up
+
+static void Transform2(const f32* m, const f32* x, const f32* y, f32* outX, f32* outY, usize count) {
+	const Pack::Reg m00 = Pack::Set(m[0]), m01 = Pack::Set(m[1]);
+	const Pack::Reg m10 = Pack::Set(m[3]), m11 = Pack::Set(m[4]);
+	const Pack::Reg m20 = Pack::Set(m[6]), m21 = Pack::Set(m[7]);
+
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		const Pack::Reg px = Pack::Load(x + i);
+		const Pack::Reg py = Pack::Load(y + i);
+		Pack::Store(outX + i, Pack::MulAdd(m00, px, Pack::MulAdd(m10, py, m20)));
+		Pack::Store(outY + i, Pack::MulAdd(m01, px, Pack::MulAdd(m11, py, m21)));
+	}
+
+	for (; i < count; i++) {
+		const f32 px = x[i], py = y[i];
+		outX[i] = m[0] * px + m[3] * py + m[6];
+		outY[i] = m[1] * px + m[4] * py + m[7];
+	}
+}
+
+static void Transform3(const f32* m, const f32* x, const f32* y, const f32* z, f32* outX, f32* outY, f32* outZ, usize count) {
+	const Pack::Reg m00 = Pack::Set(m[0]), m01 = Pack::Set(m[1]), m02 = Pack::Set(m[2]);
+	const Pack::Reg m10 = Pack::Set(m[4]), m11 = Pack::Set(m[5]), m12 = Pack::Set(m[6]);
+	const Pack::Reg m20 = Pack::Set(m[8]), m21 = Pack::Set(m[9]), m22 = Pack::Set(m[10]);
+	const Pack::Reg m30 = Pack::Set(m[12]), m31 = Pack::Set(m[13]), m32 = Pack::Set(m[14]);
+
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		const Pack::Reg px = Pack::Load(x + i);
+		const Pack::Reg py = Pack::Load(y + i);
+		const Pack::Reg pz = Pack::Load(z + i);
+		Pack::Store(outX + i, Pack::MulAdd(m00, px, Pack::MulAdd(m10, py, Pack::MulAdd(m20, pz, m30))));
+		Pack::Store(outY + i, Pack::MulAdd(m01, px, Pack::MulAdd(m11, py, Pack::MulAdd(m21, pz, m31))));
+		Pack::Store(outZ + i, Pack::MulAdd(m02, px, Pack::MulAdd(m12, py, Pack::MulAdd(m22, pz, m32))));
+	}
+
+	for (; i < count; i++) {
+		const f32 px = x[i], py = y[i], pz = z[i];
+		outX[i] = m[0] * px + m[4] * py + m[8] * pz + m[12];
+		outY[i] = m[1] * px + m[5] * py + m[9] * pz + m[13];
+		outZ[i] = m[2] * px + m[6] * py + m[10] * pz + m[14];
+	}
+}
+
+static void MinMax(const f32* values, usize count, f32& min, f32& max) {
+	Pack::Reg low = Pack::Set(FLT_MAX);
+	Pack::Reg high = Pack::Set(-FLT_MAX);
+
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		const Pack::Reg v = Pack::Load(values + i);
+		low = Pack::Min(low, v);
+		high = Pack::Max(high, v);
+	}
+
+	min = Pack::ReduceMin(low);
+	max = Pack::ReduceMax(high);
+	for (; i < count; i++) {
+		min = values[i] < min ? values[i] : min;
+		max = values[i] > max ? values[i] : max;
+	}
+}
+
+static void Lerp(const f32* a, const f32* b, f32 t, f32* out, usize count) {
+	const Pack::Reg pt = Pack::Set(t);
+
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		const Pack::Reg pa = Pack::Load(a + i);
+		Pack::Store(out + i, Pack::MulAdd(Pack::Sub(Pack::Load(b + i), pa), pt, pa));
+	}
+
+	for (; i < count; i++) {
+		out[i] = a[i] + (b[i] - a[i]) * t;
+	}
+}
+
+static void Normalize2(const f32* x, const f32* y, f32* outX, f32* outY, usize count) {
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		const Pack::Reg px = Pack::Load(x + i);
+		const Pack::Reg py = Pack::Load(y + i);
+		const Pack::Reg length = Pack::Sqrt(Pack::MulAdd(px, px, Pack::Mul(py, py)));
+		Pack::Store(outX + i, Pack::Div(px, length));
+		Pack::Store(outY + i, Pack::Div(py, length));
+	}
+
+	for (; i < count; i++) {
+		const f32 length = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+		outX[i] = x[i] / length;
+		outY[i] = y[i] / length;
+	}
+}
+
+static void Normalize3(const f32* x, const f32* y, const f32* z, f32* outX, f32* outY, f32* outZ, usize count) {
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		const Pack::Reg px = Pack::Load(x + i);
+		const Pack::Reg py = Pack::Load(y + i);
+		const Pack::Reg pz = Pack::Load(z + i);
+		const Pack::Reg length = Pack::Sqrt(Pack::MulAdd(px, px, Pack::MulAdd(py, py, Pack::Mul(pz, pz))));
+		Pack::Store(outX + i, Pack::Div(px, length));
+		Pack::Store(outY + i, Pack::Div(py, length));
+		Pack::Store(outZ + i, Pack::Div(pz, length));
+	}
+
+	for (; i < count; i++) {
+		const f32 length = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+		outX[i] = x[i] / length;
+		outY[i] = y[i] / length;
+		outZ[i] = z[i] / length;
+	}
+}
+
+static void Dot2(const f32* ax, const f32* ay, const f32* bx, const f32* by, f32* out, usize count) {
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		Pack::Store(out + i, Pack::MulAdd(Pack::Load(ax + i), Pack::Load(bx + i), Pack::Mul(Pack::Load(ay + i), Pack::Load(by + i))));
+	}
+
+	for (; i < count; i++) {
+		out[i] = ax[i] * bx[i] + ay[i] * by[i];
+	}
+}
+
+static void Dot3(const f32* ax, const f32* ay, const f32* az, const f32* bx, const f32* by, const f32* bz, f32* out, usize count) {
+	usize i = 0;
+	for (; i + Pack::WIDTH <= count; i += Pack::WIDTH) {
+		const Pack::Reg xy = Pack::MulAdd(Pack::Load(ax + i), Pack::Load(bx + i), Pack::Mul(Pack::Load(ay + i), Pack::Load(by + i)));
+		Pack::Store(out + i, Pack::MulAdd(Pack::Load(az + i), Pack::Load(bz + i), xy));
+	}
+
+	for (; i < count; i++) {
+		out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+	}
+}
+
+static constexpr detail::Kernels KERNELS{ Transform2, Transform3, MinMax, Lerp, Normalize2, Normalize3, Dot2, Dot3 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "Batch.h"
+
+#if defined(MATH_SIMD_SSE)
+namespace math::batch::sse2 {
+
+	struct Pack {
+		using Reg = __m128;
+		static constexpr usize WIDTH = 4;
+
+		static inline Reg Load(const f32* p) { return _mm_loadu_ps(p); }
+		static inline void Store(f32* p, Reg r) { _mm_storeu_ps(p, r); }
+		static inline Reg Set(f32 s) { return _mm_set1_ps(s); }
+		static inline Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+		static inline Reg Sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+		static inline Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+		static inline Reg Div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+		static inline Reg MulAdd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static inline Reg Sqrt(Reg r) { return _mm_sqrt_ps(r); }
+		static inline Reg Min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+		static inline Reg Max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+
+		static inline f32 ReduceMin(Reg r) {
+			r = _mm_min_ps(r, _mm_movehl_ps(r, r));
+			return _mm_cvtss_f32(_mm_min_ss(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1))));
+		}
+
+		static inline f32 ReduceMax(Reg r) {
+			r = _mm_max_ps(r, _mm_movehl_ps(r, r));
+			return _mm_cvtss_f32(_mm_max_ss(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1))));
+		}
+	};
+
+#include "BatchKernels.h"
+}
+
+namespace math::batch::detail {
+	const Kernels SSE2_KERNELS = sse2::KERNELS;
+}
+#endif
\ No newline at end of file
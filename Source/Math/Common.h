@@ -23,8 +23,17 @@ namespace math {
 #endif
 	>;
 
+	//Specialized in Fixed.h, so vec and mat take fixed as well
 	template<typename T>
-	concept Numeric = Integral<T> || Floating<T>;
+	struct IsFixed {
+		static constexpr bool Value = false;
+	};
+
+	template<typename T>
+	concept FixedPoint = IsFixed<T>::Value;
+
+	template<typename T>
+	concept Numeric = Integral<T> || Floating<T> || FixedPoint<T>;
 
 	template<typename T>
 	concept Signed = Integral<T> && static_cast<T>(-1) < static_cast<T>(0);
@@ -0,0 +1,241 @@
+#pragma once
+
+#include "Math.h"
+
+//Fixed point numbers in an i32 with F fraction bits. Everything is integer math, so the same inputs give bit
+//identical results on every machine and compiler, which f32 can't promise. Overflow isn't checked, fixed16
+//holds +-32768 and products have to stay in that range as well (LengthSquared() of a vec past ~181 overflows)
+namespace math {
+
+	template<u32 F>
+	struct fixed {
+		static_assert(F > 0 && F < 31, "fixed needs both integer and fraction bits!");
+
+		static constexpr u32 FRACTION_BITS = F;
+		static constexpr i32 ONE = 1 << F;
+		static constexpr i32 HALF = 1 << (F - 1);
+		static constexpr i32 FRACTION_MASK = ONE - 1;
+
+		constexpr fixed() = default;
+
+		//Whole numbers are exact, so like int to float this is implicit
+		template<Integral I>
+		constexpr fixed(I i) : raw(static_cast<i32>(i) * ONE) { }
+
+		//Rounds to the nearest step, explicit since it's the one place floats get in
+		template<Floating T>
+		constexpr explicit fixed(T t) : raw(static_cast<i32>(t * ONE + (t < T(0) ? T(-0.5) : T(0.5)))) { }
+
+		static constexpr inline fixed FromRaw(i32 raw) {
+			fixed ret;
+			ret.raw = raw;
+			return ret;
+		}
+
+		template<Floating T>
+		constexpr explicit operator T() const {
+			return static_cast<T>(raw) / static_cast<T>(ONE);
+		}
+
+		//Floors, see RoundToInt() for the nearest
+		template<Integral I>
+		constexpr explicit operator I() const {
+			return static_cast<I>(raw >> F);
+		}
+
+		constexpr inline void operator+=(fixed other) { raw += other.raw; }
+		constexpr inline void operator-=(fixed other) { raw -= other.raw; }
+		constexpr inline void operator*=(fixed other) { *this = *this * other; }
+		constexpr inline void operator/=(fixed other) { *this = *this / other; }
+
+		constexpr inline fixed operator-() const { return FromRaw(-raw); }
+		constexpr inline fixed operator+() const { return *this; }
+
+		friend constexpr inline fixed operator+(fixed a, fixed b) { return FromRaw(a.raw + b.raw); }
+		friend constexpr inline fixed operator-(fixed a, fixed b) { return FromRaw(a.raw - b.raw); }
+
+		//Through 64 bits and rounded to the nearest step
+		friend constexpr inline fixed operator*(fixed a, fixed b) {
+			return FromRaw(static_cast<i32>((static_cast<i64>(a.raw) * b.raw + HALF) >> F));
+		}
+
+		//Rounds toward zero like integer division
+		friend constexpr inline fixed operator/(fixed a, fixed b) {
+			ASSERT(b.raw != 0, "fixed divide by zero!");
+			return FromRaw(static_cast<i32>(static_cast<i64>(a.raw) * ONE / b.raw));
+		}
+
+		friend constexpr inline fixed operator%(fixed a, fixed b) {
+			return FromRaw(a.raw % b.raw);
+		}
+
+		//By whole numbers there's no shift and no widening, the template keeps floats from converting to an int here
+		template<Integral I>
+		friend constexpr inline fixed operator*(fixed a, I i) { return FromRaw(a.raw * static_cast<i32>(i)); }
+
+		template<Integral I>
+		friend constexpr inline fixed operator*(I i, fixed a) { return FromRaw(a.raw * static_cast<i32>(i)); }
+
+		template<Integral I>
+		friend constexpr inline fixed operator/(fixed a, I i) { return FromRaw(a.raw / static_cast<i32>(i)); }
+
+		friend constexpr inline bool operator==(fixed a, fixed b) { return a.raw == b.raw; }
+		friend constexpr inline bool operator!=(fixed a, fixed b) { return a.raw != b.raw; }
+		friend constexpr inline bool operator<(fixed a, fixed b) { return a.raw < b.raw; }
+		friend constexpr inline bool operator<=(fixed a, fixed b) { return a.raw <= b.raw; }
+		friend constexpr inline bool operator>(fixed a, fixed b) { return a.raw > b.raw; }
+		friend constexpr inline bool operator>=(fixed a, fixed b) { return a.raw >= b.raw; }
+
+		i32 raw;
+	};
+
+	template<u32 F>
+	struct IsFixed<fixed<F>> {
+		static constexpr bool Value = true;
+	};
+
+	typedef fixed<16> fixed16; //1/65536 steps, +-32768
+	typedef fixed<8> fixed8; //1/256 steps, +-8388608
+
+	static_assert(sizeof(fixed16) == sizeof(i32) && std::is_trivial_v<fixed16>);
+
+	template<u32 F>
+	constexpr inline fixed<F> Abs(fixed<F> t) {
+		return fixed<F>::FromRaw(t.raw < 0 ? -t.raw : t.raw);
+	}
+
+	template<u32 F>
+	constexpr inline fixed<F> Floor(fixed<F> t) {
+		return fixed<F>::FromRaw(t.raw & ~fixed<F>::FRACTION_MASK);
+	}
+
+	template<u32 F>
+	constexpr inline fixed<F> Ceil(fixed<F> t) {
+		return fixed<F>::FromRaw((t.raw + fixed<F>::FRACTION_MASK) & ~fixed<F>::FRACTION_MASK);
+	}
+
+	//Halves round up, toward +infinity
+	template<u32 F>
+	constexpr inline fixed<F> Round(fixed<F> t) {
+		return fixed<F>::FromRaw((t.raw + fixed<F>::HALF) & ~fixed<F>::FRACTION_MASK);
+	}
+
+	template<u32 F>
+	constexpr inline fixed<F> Fract(fixed<F> t) {
+		return fixed<F>::FromRaw(t.raw & fixed<F>::FRACTION_MASK);
+	}
+
+	//The nearest step below, the result is exact for every input
+	template<u32 F>
+	inline fixed<F> Sqrt(fixed<F> t) {
+		ASSERT(t.raw >= 0, "Sqrt of a negative fixed!");
+		const u64 n = static_cast<u64>(t.raw) << F;
+		//IEEE sqrt is correctly rounded everywhere and n fits in a double, the loops only fix the last step
+		u64 r = static_cast<u64>(std::sqrt(static_cast<f64>(n)));
+		while (r * r > n) {
+			r--;
+		}
+		while ((r + 1) * (r + 1) <= n) {
+			r++;
+		}
+		return fixed<F>::FromRaw(static_cast<i32>(r));
+	}
+
+	template<u32 F>
+	constexpr inline fixed<F> Lerp(fixed<F> a, fixed<F> b, fixed<F> t) {
+		return a + (b - a) * t;
+	}
+
+	//Snapping to whole numbers, for pixel positions
+
+	template<u32 F>
+	constexpr inline i32 FloorToInt(fixed<F> t) {
+		return t.raw >> F;
+	}
+
+	template<u32 F>
+	constexpr inline i32 CeilToInt(fixed<F> t) {
+		return (t.raw + fixed<F>::FRACTION_MASK) >> F;
+	}
+
+	template<u32 F>
+	constexpr inline i32 RoundToInt(fixed<F> t) {
+		return (t.raw + fixed<F>::HALF) >> F;
+	}
+
+	template<Floating T>
+	inline i32 FloorToInt(T t) {
+		return static_cast<i32>(std::floor(t));
+	}
+
+	template<Floating T>
+	inline i32 CeilToInt(T t) {
+		return static_cast<i32>(std::ceil(t));
+	}
+
+	template<Floating T>
+	inline i32 RoundToInt(T t) {
+		return static_cast<i32>(std::floor(t + T(0.5)));
+	}
+
+	//Snaps to the nearest multiple of step, like a grid of step pixels
+	template<u32 F>
+	constexpr inline fixed<F> Snap(fixed<F> t, fixed<F> step) {
+		const i32 half = step.raw / 2;
+		const i32 offset = t.raw + half;
+		//Floored division, so negative values snap the same way as positive ones
+		const i32 steps = offset / step.raw - (offset % step.raw < 0 ? 1 : 0);
+		return fixed<F>::FromRaw(steps * step.raw);
+	}
+
+	template<usize L, Numeric T>
+	constexpr inline vec<L, i32> FloorToInt(const vec<L, T>& v) {
+		vec<L, i32> ret;
+		for (usize i = 0; i < L; i++) {
+			ret[i] = FloorToInt(v[i]);
+		}
+
+		return ret;
+	}
+
+	template<usize L, Numeric T>
+	constexpr inline vec<L, i32> CeilToInt(const vec<L, T>& v) {
+		vec<L, i32> ret;
+		for (usize i = 0; i < L; i++) {
+			ret[i] = CeilToInt(v[i]);
+		}
+
+		return ret;
+	}
+
+	template<usize L, Numeric T>
+	constexpr inline vec<L, i32> RoundToInt(const vec<L, T>& v) {
+		vec<L, i32> ret;
+		for (usize i = 0; i < L; i++) {
+			ret[i] = RoundToInt(v[i]);
+		}
+
+		return ret;
+	}
+
+	template<usize L, u32 F>
+	constexpr inline vec<L, fixed<F>> Snap(const vec<L, fixed<F>>& v, fixed<F> step) {
+		vec<L, fixed<F>> ret;
+		for (usize i = 0; i < L; i++) {
+			ret[i] = Snap(v[i], step);
+		}
+
+		return ret;
+	}
+
+	template<usize L, u32 F>
+	constexpr inline vec<L, fixed<F>> Lerp(const vec<L, fixed<F>>& a, const vec<L, fixed<F>>& b, fixed<F> t) {
+		return a + (b - a) * t;
+	}
+
+	typedef vec<2, fixed16> xvec2;
+	typedef vec<3, fixed16> xvec3;
+	typedef vec<4, fixed16> xvec4;
+	typedef mat<2, 2, fixed16> xmat2;
+	typedef mat<3, 3, fixed16> xmat3;
+}
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "MathBenchmark.h"
+#include "Batch.h"
+#include "Fixed.h"
+#include "Util\Math.h"
+#include "Util\Time.h"
+#include "Util\Log.h"
+#include "State.h"
+
+namespace math {
+
+	//Runs f over every input MATH_BENCHMARK_ROUNDS times, returns ns per call
+	template<typename Fn>
+	static f64 Measure(u32 count, Fn&& f) {
+		const f64 start = global.time->CurrentTime();
+		for (u32 round = 0; round < MATH_BENCHMARK_ROUNDS; round++) {
+			for (u32 i = 0; i < count; i++) {
+				f(i);
+			}
+		}
+		return (global.time->CurrentTime() - start) * 1000000.0 / (static_cast<f64>(count) * MATH_BENCHMARK_ROUNDS);
+	}
+
+	static void RunBatchBenchmark(u32 count, const mat4& matrix) {
+		std::mt19937 rng{ 4321 };
+		std::uniform_real_distribution<f32> value(-100.f, 100.f);
+
+		std::vector<f32> x(count), y(count), z(count), outX(count), outY(count), outZ(count), dots(count);
+		for (u32 i = 0; i < count; i++) {
+			x[i] = value(rng);
+			y[i] = value(rng);
+			z[i] = value(rng);
+		}
+		const mat3 matrix2{ vec3{ matrix[0].x, matrix[0].y, 0.f }, vec3{ matrix[1].x, matrix[1].y, 0.f }, vec3{ matrix[3].x, matrix[3].y, 1.f } };
+
+		//Measure() runs per point, so each call covers the whole stream and the time is split over the points
+		auto measure = [count](auto&& f) {
+			return Measure(1, [&](u32) { f(); }) / count;
+		};
+
+		LOGNG(util::Logger::General, "Batch math benchmark ($ points, ns per point):", count);
+		const batch::Level supported = batch::Supported();
+		vec3 min, max;
+		for (u32 level = 0; level <= static_cast<u32>(supported); level++) {
+			batch::SetLevel(static_cast<batch::Level>(level));
+
+			const f64 transform2 = measure([&] { batch::Transform(matrix2, x, y, outX, outY); });
+			const f64 transform3 = measure([&] { batch::Transform(matrix, x, y, z, outX, outY, outZ); });
+			const f64 bounds = measure([&] { batch::Bounds(x, y, z, min, max); });
+			const f64 lerp = measure([&] { batch::Lerp(x, y, 0.25f, outX); });
+			const f64 normalize = measure([&] { batch::Normalize(x, y, z, outX, outY, outZ); });
+			const f64 dot = measure([&] { batch::Dot(x, y, z, outX, outY, outZ, dots); });
+
+			LOGNG(util::Logger::General, "    $: mat3 $, mat4 $, bounds $, lerp $, normalize $, dot $",
+				batch::LevelName(static_cast<batch::Level>(level)), transform2, transform3, bounds, lerp, normalize, dot);
+		}
+		batch::SetLevel(supported);
+	}
+
+	template<typename T>
+	struct SimBody {
+		vec<2, T> position, velocity;
+	};
+
+	//One tick at 100 TPS of a platformer body bouncing around a 1024 pixel wide room, input bits are
+	//left, right and jump. The constants are built from whole numbers so both types start from the same values
+	template<typename T>
+	static void SimTick(std::span<SimBody<T>> bodies, std::span<const u8> inputs) {
+		const T dt = T(1) / T(100);
+		const T accel = T(12);
+		const T gravity = T(9);
+		const T jump = T(400);
+		const T drag = T(15) / T(16);
+		const T bounce = T(1) / T(2);
+		const T width = T(1024);
+
+		for (usize i = 0; i < bodies.size(); i++) {
+			SimBody<T>& body = bodies[i];
+			const u8 input = inputs[i];
+			if (input & 1) {
+				body.velocity.x -= accel;
+			}
+			if (input & 2) {
+				body.velocity.x += accel;
+			}
+			if ((input & 4) && body.position.y == T(0)) {
+				body.velocity.y = jump;
+			}
+
+			body.velocity.y -= gravity;
+			body.velocity.x *= drag;
+			body.position += body.velocity * dt;
+
+			if (body.position.y < T(0)) {
+				body.position.y = T(0);
+				body.velocity.y = -body.velocity.y * bounce;
+			}
+			if (body.position.x < T(0)) {
+				body.position.x = -body.position.x;
+				body.velocity.x = -body.velocity.x;
+			}
+			else if (body.position.x > width) {
+				body.position.x = width + width - body.position.x;
+				body.velocity.x = -body.velocity.x;
+			}
+		}
+	}
+
+	template<typename T>
+	static std::vector<SimBody<T>> SimStart(u32 count) {
+		std::vector<SimBody<T>> bodies(count);
+		for (u32 i = 0; i < count; i++) {
+			bodies[i].position = vec<2, T>(T((i * 37) % 1024), T((i * 13) % 64));
+			bodies[i].velocity = vec<2, T>(T(0), T(0));
+		}
+		return bodies;
+	}
+
+	//FNV-1a over the bits of every component
+	template<typename T>
+	static u64 SimHash(std::span<const SimBody<T>> bodies) {
+		u64 hash = 14695981039346656037ull;
+		for (const SimBody<T>& body : bodies) {
+			for (const T t : { body.position.x, body.position.y, body.velocity.x, body.velocity.y }) {
+				u32 bits;
+				if constexpr (FixedPoint<T>) {
+					bits = static_cast<u32>(t.raw);
+				}
+				else {
+					std::memcpy(&bits, &t, sizeof(bits));
+				}
+				hash = (hash ^ bits) * 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+	//The same input for a body every time it's asked for, from a xorshift so it's identical everywhere
+	static std::vector<u8> SimInputs(u32 count) {
+		std::vector<u8> inputs(static_cast<usize>(count) * FIXED_INPUT_TICKS);
+		u32 state = 2463534242u;
+		for (u8& input : inputs) {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			input = static_cast<u8>(state >> 29);
+		}
+		return inputs;
+	}
+
+	template<typename T>
+	static void SimRun(std::span<SimBody<T>> bodies, std::span<const u8> inputs, u32 from, u32 to) {
+		const usize count = bodies.size();
+		for (u32 tick = from; tick < to; tick++) {
+			SimTick(bodies, inputs.subspan((tick % FIXED_INPUT_TICKS) * count, count));
+		}
+	}
+
+	//Replays the sim from the start and from a snapshot halfway through, both have to land on
+	//FIXED_REPLAY_HASH, which was recorded on another machine
+	static void RunReplayCheck() {
+		const std::vector<u8> inputs = SimInputs(FIXED_REPLAY_BODIES);
+
+		std::vector<SimBody<fixed16>> bodies = SimStart<fixed16>(FIXED_REPLAY_BODIES);
+		SimRun<fixed16>(bodies, inputs, 0, FIXED_REPLAY_TICKS / 2);
+		const std::vector<SimBody<fixed16>> snapshot = bodies;
+		SimRun<fixed16>(bodies, inputs, FIXED_REPLAY_TICKS / 2, FIXED_REPLAY_TICKS);
+		const u64 hash = SimHash<fixed16>(bodies);
+
+		std::vector<SimBody<fixed16>> replay = snapshot;
+		SimRun<fixed16>(replay, inputs, FIXED_REPLAY_TICKS / 2, FIXED_REPLAY_TICKS);
+		const u64 replayHash = SimHash<fixed16>(replay);
+
+		std::vector<SimBody<f32>> floats = SimStart<f32>(FIXED_REPLAY_BODIES);
+		SimRun<f32>(floats, inputs, 0, FIXED_REPLAY_TICKS);
+
+		if (hash == FIXED_REPLAY_HASH && replayHash == FIXED_REPLAY_HASH) {
+			LOGNG(util::Logger::General, "    Replay of $ ticks matches the recorded hash $ (f32 gives $)",
+				FIXED_REPLAY_TICKS, hash, SimHash<f32>(floats));
+		}
+		else {
+			WARNNG(util::Logger::General, "    Replay isn't deterministic! Hash $, from the snapshot $, recorded $",
+				hash, replayHash, FIXED_REPLAY_HASH);
+		}
+	}
+
+	static void RunFixedBenchmark(u32 count) {
+		const std::vector<u8> inputs = SimInputs(count);
+		std::vector<SimBody<fixed16>> bodies = SimStart<fixed16>(count);
+		std::vector<SimBody<f32>> floats = SimStart<f32>(count);
+
+		u32 tick = 0;
+		const f64 fixedTick = Measure(1, [&](u32) { SimRun<fixed16>(bodies, inputs, tick, tick + 1); tick++; }) / count;
+		tick = 0;
+		const f64 floatTick = Measure(1, [&](u32) { SimRun<f32>(floats, inputs, tick, tick + 1); tick++; }) / count;
+
+		std::vector<fixed16> fixedValues(count), fixedResults(count);
+		std::vector<f32> floatValues(count), floatResults(count);
+		for (u32 i = 0; i < count; i++) {
+			fixedValues[i] = fixed16::FromRaw(static_cast<i32>(i * 2654435761u >> 12) + fixed16::ONE);
+			floatValues[i] = static_cast<f32>(fixedValues[i]);
+		}
+		const fixed16 fixedScale = fixed16(3) / fixed16(7);
+		const f32 floatScale = 3.f / 7.f;
+		const f64 fixedMul = Measure(count, [&](u32 i) { fixedResults[i] = fixedValues[i] * fixedScale; });
+		const f64 floatMul = Measure(count, [&](u32 i) { floatResults[i] = floatValues[i] * floatScale; });
+		const f64 fixedDiv = Measure(count, [&](u32 i) { fixedResults[i] = fixedScale / fixedValues[i]; });
+		const f64 floatDiv = Measure(count, [&](u32 i) { floatResults[i] = floatScale / floatValues[i]; });
+		const f64 fixedSqrt = Measure(count, [&](u32 i) { fixedResults[i] = Sqrt(fixedValues[i]); });
+		const f64 floatSqrt = Measure(count, [&](u32 i) { floatResults[i] = Sqrt(floatValues[i]); });
+
+		LOGNG(util::Logger::General, "Fixed point benchmark ($ bodies, checksum $):", count,
+			SimHash<fixed16>(bodies) ^ SimHash<f32>(floats) ^ static_cast<u64>(fixedResults[count - 1].raw) ^ static_cast<u64>(floatResults[count - 1]));
+		LOGNG(util::Logger::General, "    Body tick: $ns fixed16, $ns f32", fixedTick, floatTick);
+		LOGNG(util::Logger::General, "    mul: $ns, $ns f32, div: $ns, $ns f32, Sqrt: $ns, $ns f32",
+			fixedMul, floatMul, fixedDiv, floatDiv, fixedSqrt, floatSqrt);
+		RunReplayCheck();
+	}
+
+	void RunMathBenchmark(u32 count) {
+		std::mt19937 rng{ 1234 };
+		std::uniform_real_distribution<f32> value(-4.f, 4.f);
+
+		std::vector<mat4> a(count), b(count), results(count);
+		std::vector<vec4> vectors(count), vectorResults(count);
+		std::vector<vec3> eyes(count);
+		for (u32 i = 0; i < count; i++) {
+			for (u32 c = 0; c < 4; c++) {
+				a[i][c] = vec4{ value(rng), value(rng), value(rng), value(rng) };
+				b[i][c] = vec4{ value(rng), value(rng), value(rng), value(rng) };
+			}
+			vectors[i] = vec4{ value(rng), value(rng), value(rng), 1.f };
+			eyes[i] = vec3{ value(rng), value(rng), value(rng) };
+		}
+
+		//Every result is written out so nothing gets optimized away, the sum is logged for the same reason
+		const f64 mul = Measure(count, [&](u32 i) { results[i] = a[i] * b[i]; });
+		const f64 scalarMul = Measure(count, [&](u32 i) { results[i] = detail::Multiply(a[i], b[i]); });
+		const f64 mulVec = Measure(count, [&](u32 i) { vectorResults[i] = a[i] * vectors[i]; });
+		const f64 scalarMulVec = Measure(count, [&](u32 i) { vectorResults[i] = detail::Multiply(a[i], vectors[i]); });
+		const f64 inverse = Measure(count, [&](u32 i) { results[i] = Inverse(a[i]); });
+		const f64 scalarInverse = Measure(count, [&](u32 i) { results[i] = detail::Inverse(a[i]); });
+		const f64 lookAt = Measure(count, [&](u32 i) { results[i] = LookAt(eyes[i], vec3{ 0.f }); });
+		const f64 persp = Measure(count, [&](u32 i) { results[i] = Persp(Radians(30.f + eyes[i].x), 16.f / 9.f, 0.1f, 100.f); });
+
+		f32 sum = 0.f;
+		for (u32 i = 0; i < count; i++) {
+			sum += results[i][3][3] + vectorResults[i].w;
+		}
+
+#if defined(MATH_SIMD_AVX)
+		const char* path = "AVX";
+#elif defined(MATH_SIMD_SSE)
+		const char* path = "SSE";
+#elif defined(MATH_SIMD_NEON)
+		const char* path = "NEON";
+#else
+		const char* path = "scalar";
+#endif
+
+		LOGNG(util::Logger::General, "Math benchmark ($, $ matrices, checksum $):", path, count, sum);
+		LOGNG(util::Logger::General, "    mat4 * mat4: $ns, $ns scalar", mul, scalarMul);
+		LOGNG(util::Logger::General, "    mat4 * vec4: $ns, $ns scalar", mulVec, scalarMulVec);
+		LOGNG(util::Logger::General, "    Inverse: $ns, $ns scalar", inverse, scalarInverse);
+		LOGNG(util::Logger::General, "    LookAt: $ns, Persp: $ns", lookAt, persp);
+
+		RunBatchBenchmark(count * BATCH_POINTS_PER_MATRIX, a[0]);
+		RunFixedBenchmark(count * BATCH_POINTS_PER_MATRIX);
+	}
+}
\ No newline at end of file
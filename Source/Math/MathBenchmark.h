@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Util\Types.h"
+
+namespace math {
+
+	constexpr u32 MATH_BENCHMARK_ROUNDS = 64;
+	constexpr u32 BATCH_POINTS_PER_MATRIX = 16;
+	constexpr u32 FIXED_INPUT_TICKS = 64;
+	constexpr u32 FIXED_REPLAY_BODIES = 256;
+	constexpr u32 FIXED_REPLAY_TICKS = 1000;
+	constexpr u64 FIXED_REPLAY_HASH = 8695859771617791205ull;
+
+	//Runs once on startup when mathBenchmark under [Debug] in the config is set (the number of matrices).
+	//Times mat4 * mat4, mat4 * vec4 and Inverse() through the SIMD path against the scalar one in
+	//detail, and LookAt() and Persp() on their own, then logs ns per operation for each. After that
+	//every batch kernel runs over BATCH_POINTS_PER_MATRIX points per matrix at each level the CPU
+	//supports, starting with the per element path, and logs ns per point. Last the same platformer tick runs
+	//in fixed16 and f32, and a replay of it in fixed16 has to match FIXED_REPLAY_HASH bit for bit
+	void RunMathBenchmark(u32 count);
+}
\ No newline at end of file
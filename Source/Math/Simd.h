@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Util\Types.h"
+
+//MATH_SIMD is defined when f32 vec4 and mat4 operations have a vector path. SSE2 is always there on x64,
+//AVX is only used when the compiler targets it (/arch:AVX) and NEON only on AArch64 where it's always there.
+//Define MATH_DISABLE_SIMD to build everything with the scalar code
+#ifndef MATH_DISABLE_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SIMD
+#define MATH_SIMD_SSE
+#include <immintrin.h>
+#if defined(__AVX__)
+#define MATH_SIMD_AVX
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MATH_SIMD
+#define MATH_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+//Kernels behind the f32 vec4 and mat4 operators. Pointers are to 4 floats for a vec4 or 16 for a column
+//major mat4 and don't have to be aligned. Every input is read before out is written, so out may alias them
+namespace math::simd {
+
+#if defined(MATH_SIMD_SSE)
+	inline void Add4(const f32* a, const f32* b, f32* out) {
+		_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+	}
+
+	inline void Sub4(const f32* a, const f32* b, f32* out) {
+		_mm_storeu_ps(out, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+	}
+
+	inline void Mul4(const f32* a, const f32* b, f32* out) {
+		_mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+	}
+
+	inline void Div4(const f32* a, const f32* b, f32* out) {
+		_mm_storeu_ps(out, _mm_div_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+	}
+
+	inline void Scale4(const f32* a, f32 s, f32* out) {
+		_mm_storeu_ps(out, _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(s)));
+	}
+
+	//Sum of the columns of m weighted by v
+	inline __m128 MulColumns(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v) {
+		__m128 ret = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+		ret = _mm_add_ps(ret, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+		ret = _mm_add_ps(ret, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+		return _mm_add_ps(ret, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+
+	inline void MulMat4Vec4(const f32* m, const f32* v, f32* out) {
+		_mm_storeu_ps(out, MulColumns(
+			_mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12), _mm_loadu_ps(v)));
+	}
+
+	inline void MulMat4(const f32* a, const f32* b, f32* out) {
+#if defined(MATH_SIMD_AVX)
+		//Two columns of the result at a time, each 128 bit lane broadcasting from its own column of b
+		const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a));
+		const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+		const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+		const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+		const __m256 b01 = _mm256_loadu_ps(b);
+		const __m256 b23 = _mm256_loadu_ps(b + 8);
+
+		__m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(0, 0, 0, 0)));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(a1, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(1, 1, 1, 1))));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(a2, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(2, 2, 2, 2))));
+		r01 = _mm256_add_ps(r01, _mm256_mul_ps(a3, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(3, 3, 3, 3))));
+
+		__m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(0, 0, 0, 0)));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(a1, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(1, 1, 1, 1))));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(a2, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(2, 2, 2, 2))));
+		r23 = _mm256_add_ps(r23, _mm256_mul_ps(a3, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(3, 3, 3, 3))));
+
+		_mm256_storeu_ps(out, r01);
+		_mm256_storeu_ps(out + 8, r23);
+#else
+		const __m128 a0 = _mm_loadu_ps(a);
+		const __m128 a1 = _mm_loadu_ps(a + 4);
+		const __m128 a2 = _mm_loadu_ps(a + 8);
+		const __m128 a3 = _mm_loadu_ps(a + 12);
+		const __m128 r0 = MulColumns(a0, a1, a2, a3, _mm_loadu_ps(b));
+		const __m128 r1 = MulColumns(a0, a1, a2, a3, _mm_loadu_ps(b + 4));
+		const __m128 r2 = MulColumns(a0, a1, a2, a3, _mm_loadu_ps(b + 8));
+		const __m128 r3 = MulColumns(a0, a1, a2, a3, _mm_loadu_ps(b + 12));
+		_mm_storeu_ps(out, r0);
+		_mm_storeu_ps(out + 4, r1);
+		_mm_storeu_ps(out + 8, r2);
+		_mm_storeu_ps(out + 12, r3);
+#endif
+	}
+
+	//Each register holds a 2x2 block as | x y |
+	//                                   | z w |
+	inline __m128 Mat2Mul(__m128 a, __m128 b) {
+		return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	//adj(a) * b
+	inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+		return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	//a * adj(b)
+	inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+		return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	//Block inverse through the 2x2 sub matrices | A B |, returns false and leaves out alone if m is singular.
+	//                                           | C D |
+	//Works on the transpose just as well, so the columns are treated as rows
+	inline b8 InverseMat4(const f32* m, f32* out) {
+		const __m128 c0 = _mm_loadu_ps(m);
+		const __m128 c1 = _mm_loadu_ps(m + 4);
+		const __m128 c2 = _mm_loadu_ps(m + 8);
+		const __m128 c3 = _mm_loadu_ps(m + 12);
+
+		const __m128 A = _mm_movelh_ps(c0, c1);
+		const __m128 B = _mm_movehl_ps(c1, c0);
+		const __m128 C = _mm_movelh_ps(c2, c3);
+		const __m128 D = _mm_movehl_ps(c3, c2);
+
+		//|A| |B| |C| |D|
+		const __m128 dets = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+			_mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+		const __m128 detA = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 detB = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 detC = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 detD = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(3, 3, 3, 3));
+
+		const __m128 DC = Mat2AdjMul(D, C);
+		const __m128 AB = Mat2AdjMul(A, B);
+		__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, DC));
+		__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, AB));
+		__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, AB));
+		__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, DC));
+
+		//|M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+		__m128 trace = _mm_mul_ps(AB, _mm_shuffle_ps(DC, DC, _MM_SHUFFLE(3, 1, 2, 0)));
+		trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+		trace = _mm_add_ss(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 1, 1, 1)));
+		const f32 det = _mm_cvtss_f32(_mm_sub_ss(_mm_add_ss(_mm_mul_ss(detA, detD), _mm_mul_ss(detB, detC)), trace));
+		if (det == 0.f) {
+			return false;
+		}
+
+		const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), _mm_set1_ps(det));
+		X = _mm_mul_ps(X, invDet);
+		Y = _mm_mul_ps(Y, invDet);
+		Z = _mm_mul_ps(Z, invDet);
+		W = _mm_mul_ps(W, invDet);
+
+		_mm_storeu_ps(out, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(out + 4, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2)));
+		_mm_storeu_ps(out + 8, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3)));
+		_mm_storeu_ps(out + 12, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2)));
+		return true;
+	}
+#define MATH_SIMD_INVERSE
+#elif defined(MATH_SIMD_NEON)
+	inline void Add4(const f32* a, const f32* b, f32* out) {
+		vst1q_f32(out, vaddq_f32(vld1q_f32(a), vld1q_f32(b)));
+	}
+
+	inline void Sub4(const f32* a, const f32* b, f32* out) {
+		vst1q_f32(out, vsubq_f32(vld1q_f32(a), vld1q_f32(b)));
+	}
+
+	inline void Mul4(const f32* a, const f32* b, f32* out) {
+		vst1q_f32(out, vmulq_f32(vld1q_f32(a), vld1q_f32(b)));
+	}
+
+	inline void Div4(const f32* a, const f32* b, f32* out) {
+		vst1q_f32(out, vdivq_f32(vld1q_f32(a), vld1q_f32(b)));
+	}
+
+	inline void Scale4(const f32* a, f32 s, f32* out) {
+		vst1q_f32(out, vmulq_n_f32(vld1q_f32(a), s));
+	}
+
+	inline float32x4_t MulColumns(float32x4_t c0, float32x4_t c1, float32x4_t c2, float32x4_t c3, float32x4_t v) {
+		float32x4_t ret = vmulq_laneq_f32(c0, v, 0);
+		ret = vfmaq_laneq_f32(ret, c1, v, 1);
+		ret = vfmaq_laneq_f32(ret, c2, v, 2);
+		return vfmaq_laneq_f32(ret, c3, v, 3);
+	}
+
+	inline void MulMat4Vec4(const f32* m, const f32* v, f32* out) {
+		vst1q_f32(out, MulColumns(vld1q_f32(m), vld1q_f32(m + 4), vld1q_f32(m + 8), vld1q_f32(m + 12), vld1q_f32(v)));
+	}
+
+	inline void MulMat4(const f32* a, const f32* b, f32* out) {
+		const float32x4_t a0 = vld1q_f32(a);
+		const float32x4_t a1 = vld1q_f32(a + 4);
+		const float32x4_t a2 = vld1q_f32(a + 8);
+		const float32x4_t a3 = vld1q_f32(a + 12);
+		const float32x4_t r0 = MulColumns(a0, a1, a2, a3, vld1q_f32(b));
+		const float32x4_t r1 = MulColumns(a0, a1, a2, a3, vld1q_f32(b + 4));
+		const float32x4_t r2 = MulColumns(a0, a1, a2, a3, vld1q_f32(b + 8));
+		const float32x4_t r3 = MulColumns(a0, a1, a2, a3, vld1q_f32(b + 12));
+		vst1q_f32(out, r0);
+		vst1q_f32(out + 4, r1);
+		vst1q_f32(out + 8, r2);
+		vst1q_f32(out + 12, r3);
+	}
+#endif
+}
\ No newline at end of file
@@ -101,10 +101,10 @@ namespace math {
 	};
 
 	template<Numeric T>
-	const mat<2, 2, T> mat<2, 2, T>::Zero = mat<2, 2, T>(0.f);
+	const mat<2, 2, T> mat<2, 2, T>::Zero = mat<2, 2, T>((T)0);
 
 	template<Numeric T>
-	const mat<2, 2, T> mat<2, 2, T>::Identity = mat<2, 2, T>(1.f);
+	const mat<2, 2, T> mat<2, 2, T>::Identity = mat<2, 2, T>((T)1);
 
 	template<Numeric T>
 	constexpr inline mat<2, 2, T> Transpose(const mat<2, 2, T>& m) {
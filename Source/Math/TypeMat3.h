@@ -109,10 +109,10 @@ namespace math {
 	};
 
 	template<Numeric T>
-	const mat<3, 3, T> mat<3, 3, T>::Zero = mat<3, 3, T>(0.f);
+	const mat<3, 3, T> mat<3, 3, T>::Zero = mat<3, 3, T>((T)0);
 
 	template<Numeric T>
-	const mat<3, 3, T> mat<3, 3, T>::Identity = mat<3, 3, T>(1.f);
+	const mat<3, 3, T> mat<3, 3, T>::Identity = mat<3, 3, T>((T)1);
 
 	template<Numeric T>
 	constexpr inline mat<3, 3, T> Transpose(const mat<3, 3, T>& m) {
@@ -152,14 +152,18 @@ namespace math {
 
 	template<Numeric T>
 	constexpr inline T Determinant(const mat<4, 4, T>& m) {
-		return m[0][0] * m[1][1] * m[2][2] * m[3][3]
-			+ m[1][0] * m[2][1] * m[3][2] * m[0][3]
-			+ m[2][0] * m[3][1] * m[0][2] * m[1][3]
-			+ m[3][0] * m[0][1] * m[1][2] * m[2][3]
-			- m[0][3] * m[1][2] * m[2][1] * m[3][0]
-			- m[1][3] * m[2][2] * m[3][1] * m[0][0]
-			- m[2][3] * m[3][2] * m[0][1] * m[1][0]
-			- m[3][3] * m[0][2] * m[1][1] * m[2][0];
+		//Expanded along the first column, using the 2x2 determinants of the last two columns
+		const T s0 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+		const T s1 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+		const T s2 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+		const T s3 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+		const T s4 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+		const T s5 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+		return m[0][0] * (m[1][1] * s0 - m[1][2] * s1 + m[1][3] * s2)
+			- m[0][1] * (m[1][0] * s0 - m[1][2] * s3 + m[1][3] * s4)
+			+ m[0][2] * (m[1][0] * s1 - m[1][1] * s3 + m[1][3] * s5)
+			- m[0][3] * (m[1][0] * s2 - m[1][1] * s4 + m[1][2] * s5);
 	}
 
 	template<Numeric T>
@@ -203,6 +207,51 @@ namespace math {
 			);
 	}
 
+	//Scalar versions of the operations with a SIMD path, used for constant evaluation and other types
+	namespace detail {
+
+		template<Numeric T>
+		constexpr inline mat<4, 4, T> Multiply(const mat<4, 4, T>& a, const mat<4, 4, T>& b) {
+			return mat<4, 4, T>(
+				a[0][0] * b[0][0] + a[1][0] * b[0][1] + a[2][0] * b[0][2] + a[3][0] * b[0][3],
+				a[0][1] * b[0][0] + a[1][1] * b[0][1] + a[2][1] * b[0][2] + a[3][1] * b[0][3],
+				a[0][2] * b[0][0] + a[1][2] * b[0][1] + a[2][2] * b[0][2] + a[3][2] * b[0][3],
+				a[0][3] * b[0][0] + a[1][3] * b[0][1] + a[2][3] * b[0][2] + a[3][3] * b[0][3],
+				a[0][0] * b[1][0] + a[1][0] * b[1][1] + a[2][0] * b[1][2] + a[3][0] * b[1][3],
+				a[0][1] * b[1][0] + a[1][1] * b[1][1] + a[2][1] * b[1][2] + a[3][1] * b[1][3],
+				a[0][2] * b[1][0] + a[1][2] * b[1][1] + a[2][2] * b[1][2] + a[3][2] * b[1][3],
+				a[0][3] * b[1][0] + a[1][3] * b[1][1] + a[2][3] * b[1][2] + a[3][3] * b[1][3],
+				a[0][0] * b[2][0] + a[1][0] * b[2][1] + a[2][0] * b[2][2] + a[3][0] * b[2][3],
+				a[0][1] * b[2][0] + a[1][1] * b[2][1] + a[2][1] * b[2][2] + a[3][1] * b[2][3],
+				a[0][2] * b[2][0] + a[1][2] * b[2][1] + a[2][2] * b[2][2] + a[3][2] * b[2][3],
+				a[0][3] * b[2][0] + a[1][3] * b[2][1] + a[2][3] * b[2][2] + a[3][3] * b[2][3],
+				a[0][0] * b[3][0] + a[1][0] * b[3][1] + a[2][0] * b[3][2] + a[3][0] * b[3][3],
+				a[0][1] * b[3][0] + a[1][1] * b[3][1] + a[2][1] * b[3][2] + a[3][1] * b[3][3],
+				a[0][2] * b[3][0] + a[1][2] * b[3][1] + a[2][2] * b[3][2] + a[3][2] * b[3][3],
+				a[0][3] * b[3][0] + a[1][3] * b[3][1] + a[2][3] * b[3][2] + a[3][3] * b[3][3]
+				);
+		}
+
+		template<Numeric T>
+		constexpr inline vec<4, T> Multiply(const mat<4, 4, T>& m, const vec<4, T>& v) {
+			return vec<4, T>(
+				m[0][0] * v[0] + m[1][0] * v[1] + m[2][0] * v[2] + m[3][0] * v[3],
+				m[0][1] * v[0] + m[1][1] * v[1] + m[2][1] * v[2] + m[3][1] * v[3],
+				m[0][2] * v[0] + m[1][2] * v[1] + m[2][2] * v[2] + m[3][2] * v[3],
+				m[0][3] * v[0] + m[1][3] * v[1] + m[2][3] * v[2] + m[3][3] * v[3]
+				);
+		}
+
+		template<Numeric T>
+		constexpr inline mat<4, 4, T> Inverse(const mat<4, 4, T>& m) {
+			const T det = Determinant(m);
+			if (det == (T)0) {
+				return mat<4, 4, T>::Zero;
+			}
+			return Adjugate(m) / det;
+		}
+	}
+
 	typedef mat<4, 4, f32>  mat4;
 	typedef mat<4, 4, f64> dmat4;
 	typedef mat<4, 4, i32> imat4;
@@ -232,24 +281,16 @@ constexpr inline math::mat<4, 4, T> operator/(const math::mat<4, 4, T>& m, T s)
 
 template<math::Numeric T>
 constexpr inline math::mat<4, 4, T> operator*(const math::mat<4, 4, T>& a, const math::mat<4, 4, T>& b) {
-	return math::mat<4, 4, T>(
-		a[0][0] * b[0][0] + a[1][0] * b[0][1] + a[2][0] * b[0][2] + a[3][0] * b[0][3],
-		a[0][1] * b[0][0] + a[1][1] * b[0][1] + a[2][1] * b[0][2] + a[3][1] * b[0][3],
-		a[0][2] * b[0][0] + a[1][2] * b[0][1] + a[2][2] * b[0][2] + a[3][2] * b[0][3],
-		a[0][3] * b[0][0] + a[1][3] * b[0][1] + a[2][3] * b[0][2] + a[3][3] * b[0][3],
-		a[0][0] * b[1][0] + a[1][0] * b[1][1] + a[2][0] * b[1][2] + a[3][0] * b[1][3],
-		a[0][1] * b[1][0] + a[1][1] * b[1][1] + a[2][1] * b[1][2] + a[3][1] * b[1][3],
-		a[0][2] * b[1][0] + a[1][2] * b[1][1] + a[2][2] * b[1][2] + a[3][2] * b[1][3],
-		a[0][3] * b[1][0] + a[1][3] * b[1][1] + a[2][3] * b[1][2] + a[3][3] * b[1][3],
-		a[0][0] * b[2][0] + a[1][0] * b[2][1] + a[2][0] * b[2][2] + a[3][0] * b[2][3],
-		a[0][1] * b[2][0] + a[1][1] * b[2][1] + a[2][1] * b[2][2] + a[3][1] * b[2][3],
-		a[0][2] * b[2][0] + a[1][2] * b[2][1] + a[2][2] * b[2][2] + a[3][2] * b[2][3],
-		a[0][3] * b[2][0] + a[1][3] * b[2][1] + a[2][3] * b[2][2] + a[3][3] * b[2][3],
-		a[0][0] * b[3][0] + a[1][0] * b[3][1] + a[2][0] * b[3][2] + a[3][0] * b[3][3],
-		a[0][1] * b[3][0] + a[1][1] * b[3][1] + a[2][1] * b[3][2] + a[3][1] * b[3][3],
-		a[0][2] * b[3][0] + a[1][2] * b[3][1] + a[2][2] * b[3][2] + a[3][2] * b[3][3],
-		a[0][3] * b[0][0] + a[1][3] * b[3][1] + a[2][3] * b[3][2] + a[3][3] * b[3][3]
-		);
+#ifdef MATH_SIMD
+	if constexpr (std::is_same_v<T, f32>) {
+		if (!std::is_constant_evaluated()) {
+			math::mat<4, 4, T> ret;
+			math::simd::MulMat4(&a[0][0], &b[0][0], &ret[0][0]);
+			return ret;
+		}
+	}
+#endif
+	return math::detail::Multiply(a, b);
 }
 
 template<math::Numeric T>
@@ -286,10 +327,30 @@ constexpr inline math::mat<2, 4, T> operator*(const math::mat<4, 4, T>& a, const
 
 template<math::Numeric T>
 constexpr inline math::vec<4, T> operator*(const math::mat<4, 4, T>& m, const math::vec<4, T>& v) {
-	return math::vec<4, T>(
-		m[0][0] * v[0] + m[1][0] * v[1] + m[2][0] * v[2] + m[3][0] * v[3],
-		m[0][1] * v[0] + m[1][1] * v[1] + m[2][1] * v[2] + m[3][1] * v[3],
-		m[0][2] * v[0] + m[1][2] * v[1] + m[2][2] * v[2] + m[3][2] * v[3],
-		m[0][3] * v[0] + m[1][3] * v[1] + m[2][3] * v[2] + m[3][3] * v[3]
-		);
+#ifdef MATH_SIMD
+	if constexpr (std::is_same_v<T, f32>) {
+		if (!std::is_constant_evaluated()) {
+			math::vec<4, T> ret;
+			math::simd::MulMat4Vec4(&m[0][0], &v.x, &ret.x);
+			return ret;
+		}
+	}
+#endif
+	return math::detail::Multiply(m, v);
+}
+
+namespace math {
+
+	template<Numeric T>
+	constexpr inline mat<4, 4, T> Inverse(const mat<4, 4, T>& m) {
+#ifdef MATH_SIMD_INVERSE
+		if constexpr (std::is_same_v<T, f32>) {
+			if (!std::is_constant_evaluated()) {
+				mat<4, 4, T> ret;
+				return simd::InverseMat4(&m[0][0], &ret[0][0]) ? ret : mat<4, 4, T>::Zero;
+			}
+		}
+#endif
+		return detail::Inverse(m);
+	}
 }
\ No newline at end of file
@@ -26,11 +26,7 @@ namespace math {
 				}, ...);
 		}
 
-		constexpr vec(const vec<L, T>& other) {
-			for (usize i = 0; i < L; i++) {
-				e[i] = other[i];
-			}
-		}
+		constexpr vec(const vec<L, T>& other) = default;
 
 		template<typename U>
 		constexpr explicit vec(const vec<L, U>& other) {
@@ -100,9 +96,16 @@ namespace math {
 		}
 
 		constexpr void operator/=(T s) {
-			const typename types::IntToFloat<T>::Type invT = 1.0 / s;
-			for (usize i = 0; i < L; i++) {
-				e[i] *= invT;
+			if constexpr (FixedPoint<T>) {
+				for (usize i = 0; i < L; i++) {
+					e[i] /= s;
+				}
+			}
+			else {
+				const typename types::IntToFloat<T>::Type invT = 1.0 / s;
+				for (usize i = 0; i < L; i++) {
+					e[i] *= invT;
+				}
 			}
 		}
 
@@ -212,7 +215,10 @@ namespace math {
 
 	template<usize L, Numeric T>
 	constexpr inline vec<L, T> Normalize(const vec<L, T>& v) {
-		return v / Length(v);
+		//Through the member operator, the free ones for each size are only declared after this
+		vec<L, T> ret = v;
+		ret /= Length(v);
+		return ret;
 	}
 }
 
@@ -268,12 +274,8 @@ constexpr inline math::vec<L, T> operator*(const math::vec<L, T>& v, T s) {
 
 template<usize L, typename T>
 constexpr inline math::vec<L, T> operator/(const math::vec<L, T>& v, T s) {
-	const typename types::IntToFloat<T>::Type invS = 1.0 / s;
-	math::vec<L, T> ret;
-	for (usize i = 0; i < L; i++) {
-		ret[i] = v[i] * invS;
-	}
-
+	math::vec<L, T> ret = v;
+	ret /= s;
 	return ret;
 }
 
@@ -22,8 +22,7 @@ namespace math {
 		constexpr vec() = default;
 		constexpr explicit vec(T s) : x(s), y(s) { }
 		constexpr vec(T x, T y) : x(x), y(y) { }
-		constexpr vec(const vec<2, T>& other)
-			: x(other.x), y(other.y) { }
+		constexpr vec(const vec<2, T>& other) = default;
 
 		template<Numeric U>
 		constexpr explicit vec(const vec<2, U>& other)
@@ -123,9 +122,16 @@ namespace math {
 		}
 
 		constexpr inline void operator/=(T s) {
-			const typename types::IntToFloat<T>::Type invS = 1.0 / s;
-			x *= invS;
-			y *= invS;
+			if constexpr (FixedPoint<T>) {
+				//A fixed point reciprocal would throw away most of the fraction bits
+				x /= s;
+				y /= s;
+			}
+			else {
+				const typename types::IntToFloat<T>::Type invS = 1.0 / s;
+				x *= invS;
+				y *= invS;
+			}
 		}
 
 		constexpr inline vec<2, T> operator-() const { return vec<2, T>(-x, -y); }
@@ -254,6 +260,11 @@ constexpr math::vec<2, T> operator*(const math::vec<2, T>& v, T s) {
 
 template<math::Numeric T>
 constexpr math::vec<2, T> operator/(const math::vec<2, T>& v, T s) {
-	const typename types::IntToFloat<T>::Type invS = 1.0 / s;
-	return math::vec<2, T>(v.x * invS, v.y * invS);
+	if constexpr (math::FixedPoint<T>) {
+		return math::vec<2, T>(v.x / s, v.y / s);
+	}
+	else {
+		const typename types::IntToFloat<T>::Type invS = 1.0 / s;
+		return math::vec<2, T>(v.x * invS, v.y * invS);
+	}
 }
\ No newline at end of file
@@ -178,10 +178,17 @@ namespace math {
 		}
 
 		constexpr inline void operator/=(T s) {
-			const typename types::IntToFloat<T>::Type invS = 1.0 / s;
-			x *= invS;
-			y *= invS;
-			z *= invS;
+			if constexpr (FixedPoint<T>) {
+				x /= s;
+				y /= s;
+				z /= s;
+			}
+			else {
+				const typename types::IntToFloat<T>::Type invS = 1.0 / s;
+				x *= invS;
+				y *= invS;
+				z *= invS;
+			}
 		}
 
 		constexpr inline vec<3, T> operator-() const {
@@ -415,6 +422,11 @@ constexpr inline math::vec<3, T> operator*(const math::vec<3, T>& v, T s) {
 
 template<math::Numeric T>
 constexpr inline math::vec<3, T> operator/(const math::vec<3, T>& v, T s) {
-	const typename types::IntToFloat<T>::Type invS = 1.0 / s;
-	return math::vec<3, T>(v.x * invS, v.y * invS, v.z * invS);
+	if constexpr (math::FixedPoint<T>) {
+		return math::vec<3, T>(v.x / s, v.y / s, v.z / s);
+	}
+	else {
+		const typename types::IntToFloat<T>::Type invS = 1.0 / s;
+		return math::vec<3, T>(v.x * invS, v.y * invS, v.z * invS);
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "TypeVec.h"
+#include "Simd.h"
 #ifdef MATH_ENABLE_SWIZZLE
 #include "Swizzle.h"
 #endif
@@ -20,8 +21,7 @@ namespace math {
 		constexpr vec(T x, T y, T z, T w)
 			: x(x), y(y), z(z), w(w) { }
 
-		constexpr vec(const vec<4, T>& other)
-			: x(other.x), y(other.y), z(other.z), w(other.w) { }
+		constexpr vec(const vec<4, T>& other) = default;
 
 		template<Numeric U>
 		constexpr explicit vec(const vec<4, U>& other)
@@ -232,11 +232,19 @@ namespace math {
 		}
 
 		inline void operator/=(T s) {
-			const typename types::IntToFloat<T>::Type invS = 1.0 / s;
-			x *= invS;
-			y *= invS;
-			z *= invS;
-			w *= invS;
+			if constexpr (FixedPoint<T>) {
+				x /= s;
+				y /= s;
+				z /= s;
+				w /= s;
+			}
+			else {
+				const typename types::IntToFloat<T>::Type invS = 1.0 / s;
+				x *= invS;
+				y *= invS;
+				z *= invS;
+				w *= invS;
+			}
 		}
 
 #ifdef MATH_ENABLE_SWIZZLE
@@ -668,30 +676,79 @@ namespace math {
 		return vec<4, T>(Ceil(v.x), Ceil(v.y), Ceil(v.z), Ceil(v.w));
 	}
 
+	//Scales by the reciprocal in one vector multiply, without SIMD it's the generic divide
+	inline vec<4, f32> Normalize(const vec<4, f32>& v) {
+		vec<4, f32> ret = v;
+#ifdef MATH_SIMD
+		simd::Scale4(&v.x, 1.f / Length(v), &ret.x);
+#else
+		ret /= Length(v);
+#endif
+		return ret;
+	}
+
 	typedef vec<4, f32>  vec4;
 	typedef vec<4, f64> dvec4;
 	typedef vec<4, i32> ivec4;
 	typedef vec<4, u32> uvec4;
 	typedef vec<4, b8>  bvec4;
+
+	static_assert(sizeof(vec4) == 4 * sizeof(f32), "The SIMD path expects vec4 to be tightly packed!");
 }
 
 template<math::Numeric T>
 constexpr inline math::vec<4, T> operator+(const math::vec<4, T>& a, const math::vec<4, T>& b) {
+#ifdef MATH_SIMD
+	if constexpr (std::is_same_v<T, f32>) {
+		if (!std::is_constant_evaluated()) {
+			math::vec<4, T> ret;
+			math::simd::Add4(&a.x, &b.x, &ret.x);
+			return ret;
+		}
+	}
+#endif
 	return math::vec<4, T>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
 }
 
 template<math::Numeric T>
 constexpr inline math::vec<4, T> operator-(const math::vec<4, T>& a, const math::vec<4, T>& b) {
+#ifdef MATH_SIMD
+	if constexpr (std::is_same_v<T, f32>) {
+		if (!std::is_constant_evaluated()) {
+			math::vec<4, T> ret;
+			math::simd::Sub4(&a.x, &b.x, &ret.x);
+			return ret;
+		}
+	}
+#endif
 	return math::vec<4, T>(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
 }
 
 template<math::Numeric T>
 constexpr inline math::vec<4, T> operator*(const math::vec<4, T>& a, const math::vec<4, T>& b) {
+#ifdef MATH_SIMD
+	if constexpr (std::is_same_v<T, f32>) {
+		if (!std::is_constant_evaluated()) {
+			math::vec<4, T> ret;
+			math::simd::Mul4(&a.x, &b.x, &ret.x);
+			return ret;
+		}
+	}
+#endif
 	return math::vec<4, T>(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
 }
 
 template<math::Numeric T>
 constexpr inline math::vec<4, T> operator/(const math::vec<4, T>& a, const math::vec<4, T>& b) {
+#ifdef MATH_SIMD
+	if constexpr (std::is_same_v<T, f32>) {
+		if (!std::is_constant_evaluated()) {
+			math::vec<4, T> ret;
+			math::simd::Div4(&a.x, &b.x, &ret.x);
+			return ret;
+		}
+	}
+#endif
 	return math::vec<4, T>(a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w);
 }
 
@@ -702,11 +759,25 @@ constexpr inline math::vec<4, T> operator%(const math::vec<4, T>& a, const math:
 
 template<math::Numeric T>
 constexpr inline math::vec<4, T> operator*(const math::vec<4, T>& v, T s) {
+#ifdef MATH_SIMD
+	if constexpr (std::is_same_v<T, f32>) {
+		if (!std::is_constant_evaluated()) {
+			math::vec<4, T> ret;
+			math::simd::Scale4(&v.x, s, &ret.x);
+			return ret;
+		}
+	}
+#endif
 	return math::vec<4, T>(v.x * s, v.y * s, v.z * s, v.w * s);
 }
 
 template<math::Numeric T>
 constexpr inline math::vec<4, T> operator/(const math::vec<4, T>& v, T s) {
-	const typename types::IntToFloat<T>::Type invS = 1.0 / s;
-	return math::vec<4, T>(v.x * invS, v.y * invS, v.z * invS, v.w * invS);
+	if constexpr (math::FixedPoint<T>) {
+		return math::vec<4, T>(v.x / s, v.y / s, v.z / s, v.w / s);
+	}
+	else {
+		const typename types::IntToFloat<T>::Type invS = 1.0 / s;
+		return math::vec<4, T>(v.x * invS, v.y * invS, v.z * invS, v.w * invS);
+	}
 }
\ No newline at end of file
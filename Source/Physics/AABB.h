@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Util\Types.h"
+#include "Util\Std.h"
+#include "Util\Math.h"
+#include "Math\Simd.h"
+
+namespace physics {
+
+	//Axis aligned box laid out as { min.x, min.y, max.x, max.y } so one box is one SSE register.
+	//Without SSE (NEON or MATH_DISABLE_SIMD) the tests fall back to plain compares.
+	//Overlap tests are strict, boxes that only share an edge don't overlap
+	struct alignas(16) AABB {
+		vec2 min;
+		vec2 max;
+
+		static inline AABB FromCenter(vec2 center, vec2 halfSize) {
+			return AABB{ center - halfSize, center + halfSize };
+		}
+
+		inline vec2 Center() const { return (min + max) * 0.5f; }
+		inline vec2 Size() const { return max - min; }
+
+		inline AABB Translated(vec2 offset) const {
+			return AABB{ min + offset, max + offset };
+		}
+
+		inline AABB Union(const AABB& other) const {
+			return AABB{
+				vec2{ math::Min(min.x, other.min.x), math::Min(min.y, other.min.y) },
+				vec2{ math::Max(max.x, other.max.x), math::Max(max.y, other.max.y) }
+			};
+		}
+
+		inline b8 Overlaps(const AABB& other) const {
+#if defined(MATH_SIMD_SSE)
+			const __m128 a = _mm_load_ps(&min.x);
+			const __m128 b = _mm_load_ps(&other.min.x);
+
+			//(a.min, b.min) < (b.max, a.max) on all four lanes
+			return _mm_movemask_ps(_mm_cmplt_ps(_mm_movelh_ps(a, b), _mm_movehl_ps(a, b))) == 0xF;
+#else
+			return min.x < other.max.x && other.min.x < max.x
+				&& min.y < other.max.y && other.min.y < max.y;
+#endif
+		}
+	};
+
+	static_assert(sizeof(AABB) == 4 * sizeof(f32), "AABB has to fit in one SSE register!");
+
+	//Boxes split into one array per edge so four of them can be tested against a box at once.
+	//Pad() appends empty boxes that never overlap anything so a test can start at any real box
+	struct AABBArrays {
+		std::vector<f32> minX, minY, maxX, maxY;
+
+		inline usize Size() const { return minX.size(); }
+
+		void Clear() {
+			minX.clear();
+			minY.clear();
+			maxX.clear();
+			maxY.clear();
+		}
+
+		void Push(const AABB& box) {
+			minX.push_back(box.min.x);
+			minY.push_back(box.min.y);
+			maxX.push_back(box.max.x);
+			maxY.push_back(box.max.y);
+		}
+
+		void Pad() {
+			for (u32 i = 0; i < 3; i++) {
+				Push(AABB{ vec2{ FLT_MAX }, vec2{ -FLT_MAX } });
+			}
+		}
+
+		inline AABB Get(usize i) const {
+			return AABB{ vec2{ minX[i], minY[i] }, vec2{ maxX[i], maxY[i] } };
+		}
+
+		//Bit i is set if box first + i overlaps box, there have to be at least four boxes from first
+		inline u32 Overlaps4(const AABB& box, usize first) const {
+#if defined(MATH_SIMD_SSE)
+			const __m128 overlapX = _mm_and_ps(
+				_mm_cmplt_ps(_mm_loadu_ps(&minX[first]), _mm_set1_ps(box.max.x)),
+				_mm_cmplt_ps(_mm_set1_ps(box.min.x), _mm_loadu_ps(&maxX[first])));
+			const __m128 overlapY = _mm_and_ps(
+				_mm_cmplt_ps(_mm_loadu_ps(&minY[first]), _mm_set1_ps(box.max.y)),
+				_mm_cmplt_ps(_mm_set1_ps(box.min.y), _mm_loadu_ps(&maxY[first])));
+
+			return static_cast<u32>(_mm_movemask_ps(_mm_and_ps(overlapX, overlapY)));
+#else
+			u32 mask = 0;
+			for (u32 i = 0; i < 4; i++) {
+				const usize j = first + i;
+				if (minX[j] < box.max.x && box.min.x < maxX[j] && minY[j] < box.max.y && box.min.y < maxY[j]) {
+					mask |= 1u << i;
+				}
+			}
+			return mask;
+#endif
+		}
+	};
+}
\ No newline at end of file
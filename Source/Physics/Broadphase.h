@@ -0,0 +1,45 @@
+#pragma once
+
+#include "AABB.h"
+
+namespace physics {
+
+	using BodyId = u32;
+
+	static constexpr BodyId NO_BODY = ~0u;
+
+	//Potentially colliding bodies, a < b
+	struct Pair {
+		BodyId a, b;
+
+		inline b8 operator==(const Pair& other) const = default;
+		inline b8 operator<(const Pair& other) const { return a != other.a ? a < other.a : b < other.b; }
+	};
+
+	//Keeps track of body bounds between ticks and finds the overlapping ones. Implementations are
+	//incremental, Update() is cheap for a body that barely moved
+	class Broadphase {
+	public:
+		struct Stats {
+			u64 tests = 0; //Box overlap tests
+			u64 pairs = 0;
+		};
+
+		virtual ~Broadphase() = default;
+
+		virtual void Insert(BodyId id, const AABB& box) = 0;
+		virtual void Remove(BodyId id) = 0;
+		virtual void Update(BodyId id, const AABB& box) = 0;
+
+		//Every overlapping pair exactly once, sorted so the result doesn't depend on the implementation
+		virtual void FindPairs(std::vector<Pair>& pairs) = 0;
+
+		//Every body overlapping box exactly once, in no particular order
+		virtual void Query(const AABB& box, std::vector<BodyId>& bodies) = 0;
+
+		inline const Stats& LastStats() const { return stats; }
+
+	protected:
+		Stats stats;
+	};
+}
\ No newline at end of file
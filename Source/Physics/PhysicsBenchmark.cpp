@@ -0,0 +1,192 @@
+#include "PhysicsBenchmark.h"
+#include "Util\Time.h"
+#include "Util\Log.h"
+#include "State.h"
+
+namespace physics {
+
+	static const char* BroadphaseName(BroadphaseType type) {
+		return type == BroadphaseType::SpatialHash ? "spatial hash" : "sweep and prune";
+	}
+
+	PhysicsBenchmark::PhysicsBenchmark(u32 count) {
+		tiles = std::make_unique<TileGrid>(LEVEL_SIZE, TILE_SIZE);
+
+		//Walls all around and rows of solid floors and one way platforms with gaps in between
+		tiles->Fill(uvec2{ 0, 0 }, uvec2{ LEVEL_SIZE.x, 1 }, TileGrid::Solid);
+		tiles->Fill(uvec2{ 0, LEVEL_SIZE.y - 1 }, LEVEL_SIZE, TileGrid::Solid);
+		tiles->Fill(uvec2{ 0, 0 }, uvec2{ 1, LEVEL_SIZE.y }, TileGrid::Solid);
+		tiles->Fill(uvec2{ LEVEL_SIZE.x - 1, 0 }, LEVEL_SIZE, TileGrid::Solid);
+
+		std::uniform_int_distribution<u32> length(4, 24), gap(2, 8);
+		for (u32 y = 8; y < LEVEL_SIZE.y - 1; y += 8) {
+			const u8 flags = (y / 8) % 2 == 0 ? TileGrid::Solid : TileGrid::Platform;
+			for (u32 x = 1 + gap(rng); x < LEVEL_SIZE.x - 1; x += gap(rng)) {
+				const u32 end = math::Min(x + length(rng), LEVEL_SIZE.x - 1);
+				tiles->Fill(uvec2{ x, y }, uvec2{ end, y + 1 }, flags);
+				x = end;
+			}
+		}
+		world.SetTiles(tiles.get());
+
+		const vec2 levelSize = static_cast<vec2>(LEVEL_SIZE) * TILE_SIZE;
+		std::uniform_real_distribution<f32> x(TILE_SIZE * 2.f, levelSize.x - TILE_SIZE * 2.f);
+		std::uniform_real_distribution<f32> y(TILE_SIZE * 2.f, levelSize.y - TILE_SIZE * 2.f);
+		std::uniform_real_distribution<f32> size(6.f, 14.f);
+
+		//One crate for every ten runners
+		for (u32 i = 0; i < count / 10; i++) {
+			Body crate{};
+			crate.type = Body::Static;
+			crate.box = AABB::FromCenter(vec2{ x(rng), y(rng) }, vec2{ TILE_SIZE * 0.5f });
+			if (!tiles->Overlaps(crate.box)) {
+				world.Create(crate);
+			}
+		}
+
+		//One bullet for every twenty runners
+		while (bullets.size() < count / 20) {
+			Body bullet{};
+			bullet.box = AABB::FromCenter(vec2{ x(rng), y(rng) }, vec2{ 1.f });
+			bullet.gravityScale = 0.f;
+			Fire(bullet);
+			if (!tiles->Overlaps(bullet.box)) {
+				bullets.push_back(world.Create(bullet));
+			}
+		}
+
+		while (runners.size() < count) {
+			Body runner{};
+			runner.box = AABB::FromCenter(vec2{ x(rng), y(rng) }, vec2{ size(rng), size(rng) } * 0.5f);
+			runner.velocity.x = rng() % 2 ? RUN_SPEED : -RUN_SPEED;
+			if (!tiles->Overlaps(runner.box)) {
+				runners.push_back(world.Create(runner));
+			}
+		}
+
+		MeasureSweeps();
+
+		lastReport = global.time->CurrentTime();
+
+		LOGNG(util::Logger::Physics, "Physics benchmark running with $ bodies ($ bullets) on a $x$ level.",
+			world.NumBodies(), bullets.size(), LEVEL_SIZE.x, LEVEL_SIZE.y);
+	}
+
+	void PhysicsBenchmark::MeasureSweeps() {
+		const vec2 levelSize = static_cast<vec2>(LEVEL_SIZE) * TILE_SIZE;
+		std::uniform_real_distribution<f32> position(0.f, levelSize.y);
+		std::uniform_real_distribution<f32> delta(-64.f, 64.f);
+		std::uniform_real_distribution<f32> size(2.f, 16.f);
+
+		std::vector<AABB> boxes, targets;
+		std::vector<vec2> deltas;
+		for (u32 i = 0; i < SWEEP_TEST_SIZE; i++) {
+			const vec2 center{ position(rng), position(rng) };
+			boxes.push_back(AABB::FromCenter(center, vec2{ size(rng), size(rng) }));
+			targets.push_back(AABB::FromCenter(center + vec2{ delta(rng), delta(rng) }, vec2{ size(rng), size(rng) }));
+			deltas.push_back(vec2{ delta(rng), delta(rng) });
+		}
+
+		f64 start = global.time->CurrentTime();
+		u32 scalarHits = 0;
+		for (u32 i = 0; i < SWEEP_TEST_SIZE; i++) {
+			scalarHits += Sweep(boxes[i], deltas[i], targets[i]).hit;
+		}
+		const f64 scalarTime = global.time->CurrentTime() - start;
+
+		SweepBatch batch;
+		for (u32 i = 0; i < SWEEP_TEST_SIZE; i++) {
+			batch.Add(boxes[i], deltas[i], targets[i]);
+		}
+
+		start = global.time->CurrentTime();
+		batch.Run();
+		const f64 batchTime = global.time->CurrentTime() - start;
+
+		u32 batchHits = 0;
+		for (u32 i = 0; i < SWEEP_TEST_SIZE; i++) {
+			batchHits += batch.Hit(i);
+		}
+		ASSERT(scalarHits == batchHits, "Batched sweeps disagree with the scalar ones!");
+
+		LOGNG(util::Logger::Physics, "Physics: $M scalar sweeps/s, $M batched sweeps/s ($ of $ hit)",
+			SWEEP_TEST_SIZE / (scalarTime * 1000.0), SWEEP_TEST_SIZE / (batchTime * 1000.0), batchHits, SWEEP_TEST_SIZE);
+	}
+
+	void PhysicsBenchmark::Fire(Body& bullet) {
+		std::uniform_real_distribution<f32> angle(0.f, math::TwoPi<f32>());
+		const f32 a = angle(rng);
+		bullet.velocity = vec2{ std::cos(a), std::sin(a) } * BULLET_SPEED;
+	}
+
+	void PhysicsBenchmark::Tick() {
+		std::uniform_real_distribution<f32> unit(0.f, 1.f);
+
+		//Runners turn around at walls and jump now and then when they're on the ground
+		for (BodyId id : runners) {
+			Body& body = world.Get(id);
+			if (body.velocity.x == 0.f) {
+				body.velocity.x = body.box.Center().x < LEVEL_SIZE.x * TILE_SIZE * 0.5f ? RUN_SPEED : -RUN_SPEED;
+			}
+			if (body.grounded && unit(rng) < 0.02f) {
+				body.velocity.y = -JUMP_SPEED;
+			}
+		}
+
+		//Bullets stop on the axis they hit something along, then get fired off somewhere else
+		for (BodyId id : bullets) {
+			Body& body = world.Get(id);
+			if (body.velocity.x == 0.f || body.velocity.y == 0.f) {
+				Fire(body);
+			}
+		}
+
+		world.Step(static_cast<f32>(util::Time::DELTA_TIME / 1000.0));
+
+		for (BodyId id : bullets) {
+			tunneled += tiles->Overlaps(world.Get(id).box);
+		}
+
+		const World::Stats& stats = world.LastStats();
+		current.time += stats.integrateTime + stats.broadphaseTime + stats.sweepTime + stats.resolveTime;
+		current.broadphaseTime += stats.broadphaseTime;
+		current.sweepTime += stats.sweepTime;
+		current.pairs += stats.broadphase.pairs;
+		current.tests += stats.broadphase.tests;
+		current.sweeps += stats.sweeps;
+		current.hits += stats.hits;
+		ticks++;
+
+		const f64 now = global.time->CurrentTime();
+		if (now - lastReport < 1000.0) {
+			return;
+		}
+
+		const BroadphaseType type = world.GetBroadphaseType();
+		Result& result = results[static_cast<u32>(type)];
+		result = Result{
+			current.time / ticks, current.broadphaseTime / ticks, current.sweepTime / ticks,
+			current.pairs / ticks, current.tests / ticks, current.sweeps / ticks, current.hits / ticks
+		};
+
+		LOGNG(util::Logger::Physics,
+			"Physics ($): $ bodies, $ pairs, $ box tests, $ sweeps ($ hit), $ms per tick ($ms broadphase, $ms sweeps)",
+			BroadphaseName(type), world.NumBodies(), result.pairs, result.tests, result.sweeps, result.hits,
+			result.time, result.broadphaseTime, result.sweepTime);
+
+		if (tunneled) {
+			LOGNG(util::Logger::Physics, "Physics: bullets ended up inside a wall $ times!", tunneled);
+		}
+
+		if (type == BroadphaseType::SweepAndPrune) {
+			LOGNG(util::Logger::Physics, "Physics: $ bodies/ms with a spatial hash, $ with sweep and prune",
+				world.NumBodies() / results[0].time, world.NumBodies() / results[1].time);
+		}
+
+		world.SetBroadphase(type == BroadphaseType::SpatialHash ? BroadphaseType::SweepAndPrune : BroadphaseType::SpatialHash);
+
+		lastReport = now;
+		ticks = 0;
+		current = Result{};
+	}
+}
\ No newline at end of file
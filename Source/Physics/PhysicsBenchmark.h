@@ -0,0 +1,52 @@
+#pragma once
+
+#include "World.h"
+
+namespace physics {
+
+	//Stress scene for the physics, enabled with physicsBenchmark under [Debug] in the config (the
+	//number of bodies). Bodies run and jump around a level of walls, floors and one way platforms
+	//plus a scattering of static crates, while bullets moving more than a tile per tick ricochet
+	//through all of it and are counted if they ever end up inside a wall. The broadphase is
+	//switched every second and the step time, pairs, box tests and sweeps are logged for each,
+	//once both have run it logs bodies per ms for each broadphase side by side. On startup
+	//it also measures scalar against batched sweeps
+	class PhysicsBenchmark {
+	public:
+		static constexpr f32 TILE_SIZE = 16.f;
+		static constexpr uvec2 LEVEL_SIZE{ 256, 128 };
+		static constexpr f32 RUN_SPEED = 60.f;
+		static constexpr f32 JUMP_SPEED = 300.f;
+		static constexpr f32 BULLET_SPEED = 3000.f;
+		static constexpr u32 SWEEP_TEST_SIZE = 1 << 16;
+
+		PhysicsBenchmark(u32 count);
+
+		void Tick();
+
+	private:
+		struct Result {
+			f64 time = 0.0; //ms per tick
+			f64 broadphaseTime = 0.0;
+			f64 sweepTime = 0.0;
+			u64 pairs = 0, tests = 0;
+			u64 sweeps = 0, hits = 0;
+		};
+
+		void MeasureSweeps();
+		void Fire(Body& bullet);
+
+		std::unique_ptr<TileGrid> tiles;
+		World world;
+		std::vector<BodyId> runners;
+		std::vector<BodyId> bullets;
+		u64 tunneled = 0;
+
+		std::mt19937 rng{ 1234 };
+
+		f64 lastReport;
+		u64 ticks = 0;
+		Result current;
+		std::array<Result, 2> results{};
+	};
+}
\ No newline at end of file
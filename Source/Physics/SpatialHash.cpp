@@ -0,0 +1,141 @@
+#include "SpatialHash.h"
+
+namespace physics {
+
+	SpatialHash::SpatialHash(f32 cellSize)
+		: cellSize(cellSize), invCellSize(1.f / cellSize) {
+
+	}
+
+	void SpatialHash::Insert(BodyId id, const AABB& box) {
+		if (id >= proxies.size()) {
+			proxies.resize(id + 1);
+		}
+
+		Proxy& proxy = proxies[id];
+		ASSERT(!proxy.active, "Body is already in the broadphase!");
+
+		proxy.box = box;
+		proxy.cellMin = CellOf(box.min);
+		proxy.cellMax = CellOf(box.max);
+		proxy.active = true;
+		AddToCells(id, proxy.cellMin, proxy.cellMax);
+	}
+
+	void SpatialHash::Remove(BodyId id) {
+		Proxy& proxy = proxies[id];
+		ASSERT(proxy.active, "Body isn't in the broadphase!");
+
+		RemoveFromCells(id, proxy.cellMin, proxy.cellMax);
+		proxy.active = false;
+	}
+
+	void SpatialHash::Update(BodyId id, const AABB& box) {
+		Proxy& proxy = proxies[id];
+		proxy.box = box;
+
+		const ivec2 cellMin = CellOf(box.min);
+		const ivec2 cellMax = CellOf(box.max);
+		if (cellMin == proxy.cellMin && cellMax == proxy.cellMax) {
+			return;
+		}
+
+		RemoveFromCells(id, proxy.cellMin, proxy.cellMax);
+		AddToCells(id, cellMin, cellMax);
+		proxy.cellMin = cellMin;
+		proxy.cellMax = cellMax;
+	}
+
+	void SpatialHash::AddToCells(BodyId id, ivec2 cellMin, ivec2 cellMax) {
+		for (i32 y = cellMin.y; y <= cellMax.y; y++) {
+			for (i32 x = cellMin.x; x <= cellMax.x; x++) {
+				cells[Key(x, y)].push_back(id);
+			}
+		}
+	}
+
+	void SpatialHash::RemoveFromCells(BodyId id, ivec2 cellMin, ivec2 cellMax) {
+		for (i32 y = cellMin.y; y <= cellMax.y; y++) {
+			for (i32 x = cellMin.x; x <= cellMax.x; x++) {
+				auto it = cells.find(Key(x, y));
+				std::vector<BodyId>& bodies = it->second;
+				*std::find(bodies.begin(), bodies.end(), id) = bodies.back();
+				bodies.pop_back();
+
+				//FindPairs walks every cell, so empty ones can't be left to pile up
+				if (bodies.empty()) {
+					cells.erase(it);
+				}
+			}
+		}
+	}
+
+	void SpatialHash::FindPairs(std::vector<Pair>& pairs) {
+		pairs.clear();
+		stats = Stats{};
+
+		for (auto& [key, bodies] : cells) {
+			if (bodies.size() < 2) {
+				continue;
+			}
+
+			const ivec2 cell{ static_cast<i32>(key >> 32), static_cast<i32>(key & 0xFFFFFFFF) };
+
+			scratch.Clear();
+			for (BodyId id : bodies) {
+				scratch.Push(proxies[id].box);
+			}
+			scratch.Pad();
+
+			for (usize i = 0; i + 1 < bodies.size(); i++) {
+				const AABB box = scratch.Get(i);
+				for (usize j = i + 1; j < bodies.size(); j += 4) {
+					u32 mask = scratch.Overlaps4(box, j);
+					stats.tests += math::Min<usize>(4, bodies.size() - j);
+
+					while (mask) {
+						const usize other = j + std::countr_zero(mask);
+						mask &= mask - 1;
+
+						//Only the cell holding the intersection's min corner reports the pair
+						const vec2 corner{ math::Max(box.min.x, scratch.minX[other]), math::Max(box.min.y, scratch.minY[other]) };
+						if (CellOf(corner) == cell) {
+							const BodyId a = bodies[i], b = bodies[other];
+							pairs.push_back(a < b ? Pair{ a, b } : Pair{ b, a });
+						}
+					}
+				}
+			}
+		}
+
+		std::sort(pairs.begin(), pairs.end());
+		stats.pairs = pairs.size();
+	}
+
+	void SpatialHash::Query(const AABB& box, std::vector<BodyId>& bodies) {
+		const ivec2 cellMin = CellOf(box.min);
+		const ivec2 cellMax = CellOf(box.max);
+
+		for (i32 y = cellMin.y; y <= cellMax.y; y++) {
+			for (i32 x = cellMin.x; x <= cellMax.x; x++) {
+				auto it = cells.find(Key(x, y));
+				if (it == cells.end()) {
+					continue;
+				}
+
+				for (BodyId id : it->second) {
+					const AABB& other = proxies[id].box;
+					stats.tests++;
+					if (!box.Overlaps(other)) {
+						continue;
+					}
+
+					const vec2 corner{ math::Max(box.min.x, other.min.x), math::Max(box.min.y, other.min.y) };
+					if (CellOf(corner) == ivec2{ x, y }) {
+						bodies.push_back(id);
+					}
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
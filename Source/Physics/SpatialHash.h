@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Broadphase.h"
+
+namespace physics {
+
+	//Uniform grid of square cells hashed by cell coordinate, every body is listed in each cell its
+	//box touches. Moving within the same cells only rewrites the stored box, cell lists are only
+	//touched when the covered cells change. A pair that shares several cells is only reported by
+	//the cell holding the min corner of their intersection, so no pair set is needed
+	class SpatialHash : public Broadphase {
+	public:
+		SpatialHash(f32 cellSize);
+
+		void Insert(BodyId id, const AABB& box) override;
+		void Remove(BodyId id) override;
+		void Update(BodyId id, const AABB& box) override;
+
+		void FindPairs(std::vector<Pair>& pairs) override;
+		void Query(const AABB& box, std::vector<BodyId>& bodies) override;
+
+		inline usize NumCells() const { return cells.size(); }
+
+	private:
+		struct Proxy {
+			AABB box;
+			ivec2 cellMin, cellMax;
+			b8 active = false;
+		};
+
+		inline ivec2 CellOf(vec2 position) const {
+			return ivec2{ static_cast<i32>(std::floor(position.x * invCellSize)), static_cast<i32>(std::floor(position.y * invCellSize)) };
+		}
+
+		static inline u64 Key(i32 x, i32 y) {
+			return (static_cast<u64>(static_cast<u32>(x)) << 32) | static_cast<u32>(y);
+		}
+
+		void AddToCells(BodyId id, ivec2 cellMin, ivec2 cellMax);
+		void RemoveFromCells(BodyId id, ivec2 cellMin, ivec2 cellMax);
+
+		f32 cellSize, invCellSize;
+		std::vector<Proxy> proxies;
+		std::unordered_map<u64, std::vector<BodyId>> cells;
+
+		AABBArrays scratch;
+	};
+}
\ No newline at end of file
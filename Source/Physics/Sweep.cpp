@@ -0,0 +1,153 @@
+#include "Sweep.h"
+
+namespace physics {
+
+	SweepHit Sweep(const AABB& box, vec2 delta, const AABB& target) {
+		const vec2 size = box.Size();
+		const vec2 point = box.min;
+		const vec2 min = target.min - size;
+		const vec2 max = target.max;
+
+		f32 entry[2], exit[2];
+		for (u32 axis = 0; axis < 2; axis++) {
+			if (delta[axis] == 0.f) {
+				//Never enters or leaves the slab
+				if (point[axis] <= min[axis] || point[axis] >= max[axis]) {
+					return SweepHit{};
+				}
+				entry[axis] = -FLT_MAX;
+				exit[axis] = FLT_MAX;
+			}
+			else {
+				const f32 t1 = (min[axis] - point[axis]) / delta[axis];
+				const f32 t2 = (max[axis] - point[axis]) / delta[axis];
+				entry[axis] = math::Min(t1, t2);
+				exit[axis] = math::Max(t1, t2);
+			}
+		}
+
+		const f32 enter = math::Max(entry[0], entry[1]);
+		const f32 leave = math::Min(exit[0], exit[1]);
+		if (enter >= leave || enter < 0.f || enter >= 1.f) {
+			return SweepHit{};
+		}
+
+		SweepHit hit{};
+		hit.time = enter;
+		hit.hit = true;
+		if (entry[0] > entry[1]) {
+			hit.normal = vec2{ delta.x > 0.f ? -1.f : 1.f, 0.f };
+		}
+		else {
+			hit.normal = vec2{ 0.f, delta.y > 0.f ? -1.f : 1.f };
+		}
+		return hit;
+	}
+
+	void SweepBatch::Clear() {
+		for (std::vector<f32>* values : { &pointX, &pointY, &deltaX, &deltaY, &minX, &minY, &maxX, &maxY }) {
+			values->clear();
+		}
+		size = 0;
+	}
+
+	void SweepBatch::Add(const AABB& box, vec2 delta, const AABB& target) {
+		const vec2 boxSize = box.Size();
+		pointX.push_back(box.min.x);
+		pointY.push_back(box.min.y);
+		deltaX.push_back(delta.x);
+		deltaY.push_back(delta.y);
+		minX.push_back(target.min.x - boxSize.x);
+		minY.push_back(target.min.y - boxSize.y);
+		maxX.push_back(target.max.x);
+		maxY.push_back(target.max.y);
+		size++;
+	}
+
+	//One axis of the slab test for four sweeps, lanes that don't move on the axis get an infinite
+	//range when they're inside the slab and an empty one when they're not
+#if defined(MATH_SIMD_SSE)
+	static inline void Slab(__m128 point, __m128 delta, __m128 min, __m128 max, __m128& entry, __m128& exit) {
+		const __m128 infinity = _mm_set1_ps(FLT_MAX);
+		const __m128 still = _mm_cmpeq_ps(delta, _mm_setzero_ps());
+		const __m128 inside = _mm_and_ps(_mm_cmpgt_ps(point, min), _mm_cmplt_ps(point, max));
+
+		//Still lanes divide by one instead of zero and get overwritten below
+		const __m128 invDelta = _mm_div_ps(_mm_set1_ps(1.f), _mm_or_ps(_mm_andnot_ps(still, delta), _mm_and_ps(still, _mm_set1_ps(1.f))));
+		const __m128 t1 = _mm_mul_ps(_mm_sub_ps(min, point), invDelta);
+		const __m128 t2 = _mm_mul_ps(_mm_sub_ps(max, point), invDelta);
+
+		const __m128 stillEntry = _mm_or_ps(_mm_and_ps(inside, _mm_set1_ps(-FLT_MAX)), _mm_andnot_ps(inside, infinity));
+		entry = _mm_or_ps(_mm_andnot_ps(still, _mm_min_ps(t1, t2)), _mm_and_ps(still, stillEntry));
+		exit = _mm_or_ps(_mm_andnot_ps(still, _mm_max_ps(t1, t2)), _mm_and_ps(still, infinity));
+	}
+#else
+	static inline void Slab(f32 point, f32 delta, f32 min, f32 max, f32& entry, f32& exit) {
+		if (delta == 0.f) {
+			entry = point > min && point < max ? -FLT_MAX : FLT_MAX;
+			exit = FLT_MAX;
+			return;
+		}
+
+		const f32 t1 = (min - point) / delta;
+		const f32 t2 = (max - point) / delta;
+		entry = math::Min(t1, t2);
+		exit = math::Max(t1, t2);
+	}
+#endif
+
+	void SweepBatch::Run() {
+		//Pad to a multiple of four with sweeps that never hit
+		const usize padded = (size + 3) & ~static_cast<usize>(3);
+		for (usize i = size; i < padded; i++) {
+			pointX.push_back(0.f);
+			pointY.push_back(0.f);
+			deltaX.push_back(0.f);
+			deltaY.push_back(0.f);
+			minX.push_back(1.f);
+			minY.push_back(1.f);
+			maxX.push_back(2.f);
+			maxY.push_back(2.f);
+		}
+
+		times.resize(padded);
+		axes.resize(padded);
+
+#if defined(MATH_SIMD_SSE)
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.f);
+		for (usize i = 0; i < padded; i += 4) {
+			__m128 entryX, exitX, entryY, exitY;
+			Slab(_mm_loadu_ps(&pointX[i]), _mm_loadu_ps(&deltaX[i]), _mm_loadu_ps(&minX[i]), _mm_loadu_ps(&maxX[i]), entryX, exitX);
+			Slab(_mm_loadu_ps(&pointY[i]), _mm_loadu_ps(&deltaY[i]), _mm_loadu_ps(&minY[i]), _mm_loadu_ps(&maxY[i]), entryY, exitY);
+
+			const __m128 enter = _mm_max_ps(entryX, entryY);
+			const __m128 leave = _mm_min_ps(exitX, exitY);
+			const __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(enter, leave), _mm_cmpge_ps(enter, zero)), _mm_cmplt_ps(enter, one));
+
+			_mm_storeu_ps(&times[i], _mm_or_ps(_mm_and_ps(hit, enter), _mm_andnot_ps(hit, one)));
+
+			const u32 alongX = static_cast<u32>(_mm_movemask_ps(_mm_cmpgt_ps(entryX, entryY)));
+			for (u32 lane = 0; lane < 4; lane++) {
+				axes[i + lane] = (alongX >> lane) & 1 ? 0 : 1;
+			}
+		}
+#else
+		for (usize i = 0; i < padded; i++) {
+			f32 entryX, exitX, entryY, exitY;
+			Slab(pointX[i], deltaX[i], minX[i], maxX[i], entryX, exitX);
+			Slab(pointY[i], deltaY[i], minY[i], maxY[i], entryY, exitY);
+
+			const f32 enter = math::Max(entryX, entryY);
+			const f32 leave = math::Min(exitX, exitY);
+			times[i] = enter < leave && enter >= 0.f && enter < 1.f ? enter : 1.f;
+			axes[i] = entryX > entryY ? 0 : 1;
+		}
+#endif
+
+		//Drop the padding so more sweeps can be added
+		for (std::vector<f32>* values : { &pointX, &pointY, &deltaX, &deltaY, &minX, &minY, &maxX, &maxY }) {
+			values->resize(size);
+		}
+	}
+}
\ No newline at end of file
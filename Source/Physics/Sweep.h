@@ -0,0 +1,46 @@
+#pragma once
+
+#include "AABB.h"
+
+namespace physics {
+
+	//First contact of a box moving by delta against another box
+	struct SweepHit {
+		f32 time = 1.f; //Fraction of delta, 1 if nothing was hit
+		vec2 normal{ 0.f }; //Points away from the target
+		b8 hit = false;
+	};
+
+	//Slab test against the target grown by the moving box's size. Boxes that already overlap or
+	//only touch while moving apart don't hit, touching while moving into each other hits at 0
+	SweepHit Sweep(const AABB& box, vec2 delta, const AABB& target);
+
+	//Many independent sweeps in one array per value so four of them run per SSE instruction.
+	//Two moving boxes are swept with delta = deltaA - deltaB
+	class SweepBatch {
+	public:
+		void Clear();
+		void Add(const AABB& box, vec2 delta, const AABB& target);
+
+		//Fills the time and normal of every sweep added since the last Clear()
+		void Run();
+
+		inline usize Size() const { return size; }
+		inline f32 Time(usize i) const { return times[i]; }
+		inline b8 Hit(usize i) const { return times[i] < 1.f; }
+
+		//Only valid for hits
+		inline vec2 Normal(usize i) const {
+			return axes[i] == 0 ? vec2{ deltaX[i] > 0.f ? -1.f : 1.f, 0.f } : vec2{ 0.f, deltaY[i] > 0.f ? -1.f : 1.f };
+		}
+
+	private:
+		//The moving box is reduced to its min corner, the target grown by its size
+		std::vector<f32> pointX, pointY, deltaX, deltaY;
+		std::vector<f32> minX, minY, maxX, maxY;
+
+		std::vector<f32> times;
+		std::vector<u8> axes;
+		usize size = 0;
+	};
+}
\ No newline at end of file
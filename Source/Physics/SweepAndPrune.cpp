@@ -0,0 +1,102 @@
+#include "SweepAndPrune.h"
+
+namespace physics {
+
+	void SweepAndPrune::Insert(BodyId id, const AABB& box) {
+		if (id >= boxes.size()) {
+			boxes.resize(id + 1);
+			active.resize(id + 1, false);
+		}
+
+		ASSERT(!active[id], "Body is already in the broadphase!");
+		boxes[id] = box;
+		active[id] = true;
+
+		//Appended at the end, the next sort moves it into place
+		order.push_back(id);
+		sortedValid = false;
+	}
+
+	void SweepAndPrune::Remove(BodyId id) {
+		ASSERT(active[id], "Body isn't in the broadphase!");
+		active[id] = false;
+		order.erase(std::find(order.begin(), order.end(), id));
+		sortedValid = false;
+	}
+
+	void SweepAndPrune::Update(BodyId id, const AABB& box) {
+		boxes[id] = box;
+		sortedValid = false;
+	}
+
+	void SweepAndPrune::Sort() {
+		for (usize i = 1; i < order.size(); i++) {
+			const BodyId id = order[i];
+			const f32 minX = boxes[id].min.x;
+
+			usize j = i;
+			while (j > 0 && boxes[order[j - 1]].min.x > minX) {
+				order[j] = order[j - 1];
+				j--;
+			}
+			order[j] = id;
+		}
+
+		sorted.Clear();
+		for (BodyId id : order) {
+			sorted.Push(boxes[id]);
+		}
+		sorted.Pad();
+		sortedValid = true;
+	}
+
+	void SweepAndPrune::FindPairs(std::vector<Pair>& pairs) {
+		pairs.clear();
+		stats = Stats{};
+
+		Sort();
+
+		const usize count = order.size();
+		for (usize i = 0; i + 1 < count; i++) {
+			const AABB box = sorted.Get(i);
+
+			//Boxes past the first one starting after this one ends can't overlap it
+			for (usize j = i + 1; j < count && sorted.minX[j] < box.max.x; j += 4) {
+				u32 mask = sorted.Overlaps4(box, j);
+				stats.tests += math::Min<usize>(4, count - j);
+
+				while (mask) {
+					const BodyId a = order[i], b = order[j + std::countr_zero(mask)];
+					mask &= mask - 1;
+					pairs.push_back(a < b ? Pair{ a, b } : Pair{ b, a });
+				}
+			}
+		}
+
+		std::sort(pairs.begin(), pairs.end());
+		stats.pairs = pairs.size();
+	}
+
+	void SweepAndPrune::Query(const AABB& box, std::vector<BodyId>& bodies) {
+		//The order is only known to be right if nothing changed since the last sort
+		if (!sortedValid) {
+			for (BodyId id : order) {
+				stats.tests++;
+				if (box.Overlaps(boxes[id])) {
+					bodies.push_back(id);
+				}
+			}
+			return;
+		}
+
+		for (usize i = 0; i < order.size() && sorted.minX[i] < box.max.x; i += 4) {
+			u32 mask = sorted.Overlaps4(box, i);
+			stats.tests += math::Min<usize>(4, order.size() - i);
+
+			while (mask) {
+				bodies.push_back(order[i + std::countr_zero(mask)]);
+				mask &= mask - 1;
+			}
+		}
+	}
+}
\ No newline at end of file
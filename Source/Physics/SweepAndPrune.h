@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Broadphase.h"
+
+namespace physics {
+
+	//Keeps the bodies sorted by min x, re-sorted with an insertion sort every FindPairs() which is
+	//close to linear since bodies barely move between ticks. Each box is then only tested against
+	//the following boxes that start before it ends on x, four at a time
+	class SweepAndPrune : public Broadphase {
+	public:
+		void Insert(BodyId id, const AABB& box) override;
+		void Remove(BodyId id) override;
+		void Update(BodyId id, const AABB& box) override;
+
+		void FindPairs(std::vector<Pair>& pairs) override;
+		void Query(const AABB& box, std::vector<BodyId>& bodies) override;
+
+	private:
+		void Sort();
+
+		std::vector<AABB> boxes; //By body id
+		std::vector<b8> active;
+		std::vector<BodyId> order; //Sorted by boxes[id].min.x
+
+		AABBArrays sorted; //Boxes in order as of the last sort
+		b8 sortedValid = false;
+	};
+}
\ No newline at end of file
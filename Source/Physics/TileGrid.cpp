@@ -0,0 +1,178 @@
+#include "TileGrid.h"
+
+namespace physics {
+
+	TileGrid::TileGrid(uvec2 size, f32 tileSize)
+		: size(size), tileSize(tileSize), invTileSize(1.f / tileSize), tiles(static_cast<usize>(size.x) * size.y, Empty) {
+
+	}
+
+	u8 TileGrid::Get(ivec2 tile) const {
+		if (tile.x < 0 || tile.y < 0 || tile.x >= static_cast<i32>(size.x) || tile.y >= static_cast<i32>(size.y)) {
+			return Empty;
+		}
+
+		return tiles[static_cast<usize>(tile.y) * size.x + tile.x];
+	}
+
+	void TileGrid::Set(uvec2 tile, u8 flags) {
+		ASSERT(tile.x < size.x && tile.y < size.y, "Tile out of range!");
+		tiles[static_cast<usize>(tile.y) * size.x + tile.x] = flags;
+	}
+
+	void TileGrid::Fill(uvec2 min, uvec2 max, u8 flags) {
+		for (u32 y = min.y; y < max.y; y++) {
+			for (u32 x = min.x; x < max.x; x++) {
+				Set(uvec2{ x, y }, flags);
+			}
+		}
+	}
+
+	TileGrid::Hit TileGrid::Move(AABB& box, vec2 delta) const {
+		Hit hit{};
+		const vec2 boxSize = box.Size();
+
+		//Blocked boxes are snapped exactly onto the tile edge so rounding can't push them into it
+		if (delta.x > 0.f) {
+			const i32 rowMin = TileOf(box.min.y), rowMax = LastTileOf(box.max.y);
+			const i32 from = LastTileOf(box.max.x) + 1, to = LastTileOf(box.max.x + delta.x);
+			for (i32 column = from; column <= to && !hit.x; column++) {
+				for (i32 row = rowMin; row <= rowMax && !hit.x; row++) {
+					if (Get(ivec2{ column, row }) & Solid) {
+						box.max.x = column * tileSize;
+						box.min.x = box.max.x - boxSize.x;
+						hit.x = true;
+					}
+				}
+			}
+		}
+		else if (delta.x < 0.f) {
+			const i32 rowMin = TileOf(box.min.y), rowMax = LastTileOf(box.max.y);
+			const i32 from = TileOf(box.min.x) - 1, to = TileOf(box.min.x + delta.x);
+			for (i32 column = from; column >= to && !hit.x; column--) {
+				for (i32 row = rowMin; row <= rowMax && !hit.x; row++) {
+					if (Get(ivec2{ column, row }) & Solid) {
+						box.min.x = (column + 1) * tileSize;
+						box.max.x = box.min.x + boxSize.x;
+						hit.x = true;
+					}
+				}
+			}
+		}
+
+		if (!hit.x) {
+			box.min.x += delta.x;
+			box.max.x += delta.x;
+		}
+
+		if (delta.y > 0.f) {
+			//Platforms only stop boxes that were completely above them
+			const i32 columnMin = TileOf(box.min.x), columnMax = LastTileOf(box.max.x);
+			const i32 from = LastTileOf(box.max.y) + 1, to = LastTileOf(box.max.y + delta.y);
+			for (i32 row = from; row <= to && !hit.y; row++) {
+				for (i32 column = columnMin; column <= columnMax && !hit.y; column++) {
+					if (Get(ivec2{ column, row }) & (Solid | Platform)) {
+						box.max.y = row * tileSize;
+						box.min.y = box.max.y - boxSize.y;
+						hit.y = true;
+						hit.grounded = true;
+					}
+				}
+			}
+		}
+		else if (delta.y < 0.f) {
+			const i32 columnMin = TileOf(box.min.x), columnMax = LastTileOf(box.max.x);
+			const i32 from = TileOf(box.min.y) - 1, to = TileOf(box.min.y + delta.y);
+			for (i32 row = from; row >= to && !hit.y; row--) {
+				for (i32 column = columnMin; column <= columnMax && !hit.y; column++) {
+					if (Get(ivec2{ column, row }) & Solid) {
+						box.min.y = (row + 1) * tileSize;
+						box.max.y = box.min.y + boxSize.y;
+						hit.y = true;
+					}
+				}
+			}
+		}
+
+		if (!hit.y) {
+			box.min.y += delta.y;
+			box.max.y += delta.y;
+		}
+
+		return hit;
+	}
+
+	SweepHit TileGrid::Sweep(const AABB& box, vec2 delta) const {
+		const AABB bounds = box.Union(box.Translated(delta));
+
+		SweepHit first{};
+		for (i32 row = TileOf(bounds.min.y); row <= LastTileOf(bounds.max.y); row++) {
+			for (i32 column = TileOf(bounds.min.x); column <= LastTileOf(bounds.max.x); column++) {
+				const u8 flags = Get(ivec2{ column, row });
+				if (!(flags & (Solid | Platform))) {
+					continue;
+				}
+
+				const f32 top = row * tileSize;
+				if (!(flags & Solid) && (delta.y <= 0.f || box.max.y > top)) {
+					continue;
+				}
+
+				const AABB tile{ vec2{ column * tileSize, top }, vec2{ (column + 1) * tileSize, top + tileSize } };
+				const SweepHit hit = physics::Sweep(box, delta, tile);
+				if (hit.hit && hit.time < first.time && (flags & Solid || hit.normal.y < 0.f)) {
+					first = hit;
+				}
+			}
+		}
+
+		return first;
+	}
+
+	TileGrid::Hit TileGrid::Slide(AABB& box, vec2 delta) const {
+		Hit result{};
+
+		for (u32 i = 0; i < MAX_SLIDES && (delta.x != 0.f || delta.y != 0.f); i++) {
+			const SweepHit hit = Sweep(box, delta);
+			box = box.Translated(delta * hit.time);
+			if (!hit.hit) {
+				break;
+			}
+
+			//Snapped onto the tile edge so rounding can't leave it inside, then the rest of the
+			//movement continues along the edge
+			const vec2 boxSize = box.Size();
+			if (hit.normal.x != 0.f) {
+				const f32 edge = std::round((hit.normal.x < 0.f ? box.max.x : box.min.x) * invTileSize) * tileSize;
+				box.min.x = hit.normal.x < 0.f ? edge - boxSize.x : edge;
+				box.max.x = box.min.x + boxSize.x;
+				delta.x = 0.f;
+				result.x = true;
+			}
+			else {
+				const f32 edge = std::round((hit.normal.y < 0.f ? box.max.y : box.min.y) * invTileSize) * tileSize;
+				box.min.y = hit.normal.y < 0.f ? edge - boxSize.y : edge;
+				box.max.y = box.min.y + boxSize.y;
+				delta.y = 0.f;
+				result.y = true;
+				result.grounded |= hit.normal.y < 0.f;
+			}
+
+			delta = delta * (1.f - hit.time);
+		}
+
+		return result;
+	}
+
+	b8 TileGrid::Overlaps(const AABB& box) const {
+		for (i32 row = TileOf(box.min.y); row <= LastTileOf(box.max.y); row++) {
+			for (i32 column = TileOf(box.min.x); column <= LastTileOf(box.max.x); column++) {
+				if (Get(ivec2{ column, row }) & Solid) {
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
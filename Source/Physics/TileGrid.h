@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Sweep.h"
+
+namespace physics {
+
+	//Collision layer for a tile map, one flag byte per tile. Y points down like the tilemap rows,
+	//anything outside the grid is empty
+	class TileGrid {
+	public:
+		static constexpr u32 MAX_SLIDES = 3;
+
+		enum Flags : u8 {
+			Empty = 0,
+			Solid = 1 << 0,
+			Platform = 1 << 1 //Only blocks from above
+		};
+
+		struct Hit {
+			b8 x = false;
+			b8 y = false;
+			b8 grounded = false;
+		};
+
+		TileGrid(uvec2 size, f32 tileSize);
+
+		u8 Get(ivec2 tile) const;
+		void Set(uvec2 tile, u8 flags);
+
+		//Fills every tile in [min, max)
+		void Fill(uvec2 min, uvec2 max, u8 flags);
+
+		//Moves the box by delta along x and then y, stopping flush against the first blocking tile on each axis
+		Hit Move(AABB& box, vec2 delta) const;
+
+		//First blocking tile along delta, platforms only block boxes landing on them from above
+		SweepHit Sweep(const AABB& box, vec2 delta) const;
+
+		//Moves the box along delta, stopping flush at the first blocking tile and sliding the rest of the
+		//way along it. Unlike Move() diagonal movement can't clip the corner of a tile
+		Hit Slide(AABB& box, vec2 delta) const;
+
+		b8 Overlaps(const AABB& box) const;
+
+		inline uvec2 Size() const { return size; }
+		inline f32 TileSize() const { return tileSize; }
+
+	private:
+		inline i32 TileOf(f32 position) const { return static_cast<i32>(std::floor(position * invTileSize)); }
+
+		//Last tile a box edge at position covers, an edge lying on a tile border doesn't reach into the next tile
+		inline i32 LastTileOf(f32 position) const { return static_cast<i32>(std::ceil(position * invTileSize)) - 1; }
+
+		uvec2 size;
+		f32 tileSize, invTileSize;
+		std::vector<u8> tiles;
+	};
+}
\ No newline at end of file
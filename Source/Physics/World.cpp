@@ -0,0 +1,281 @@
+#include "World.h"
+#include "SpatialHash.h"
+#include "SweepAndPrune.h"
+#include "Util\Time.h"
+#include "Util\Profiler.h"
+#include "State.h"
+
+namespace physics {
+
+	World::World(BroadphaseType type, f32 cellSize) {
+		SetBroadphase(type, cellSize);
+	}
+
+	BodyId World::Create(const Body& body) {
+		BodyId id;
+		if (!freeIds.empty()) {
+			id = freeIds.back();
+			freeIds.pop_back();
+			bodies[id] = body;
+			alive[id] = true;
+		}
+		else {
+			id = static_cast<BodyId>(bodies.size());
+			bodies.push_back(body);
+			alive.push_back(true);
+		}
+
+		broadphase->Insert(id, body.box);
+		numBodies++;
+		return id;
+	}
+
+	void World::Destroy(BodyId id) {
+		ASSERT(alive[id], "Destroying a dead body!");
+
+		broadphase->Remove(id);
+		alive[id] = false;
+		freeIds.push_back(id);
+		numBodies--;
+	}
+
+	void World::SetBox(BodyId id, const AABB& box) {
+		bodies[id].box = box;
+		broadphase->Update(id, box);
+	}
+
+	void World::SetBroadphase(BroadphaseType type, f32 cellSize) {
+		switch (type) {
+		case BroadphaseType::SpatialHash:
+			broadphase = std::make_unique<SpatialHash>(cellSize);
+			break;
+		case BroadphaseType::SweepAndPrune:
+			broadphase = std::make_unique<SweepAndPrune>();
+			break;
+		}
+		broadphaseType = type;
+
+		for (BodyId id = 0; id < bodies.size(); id++) {
+			if (alive[id]) {
+				broadphase->Insert(id, bodies[id].box);
+			}
+		}
+	}
+
+	void World::Step(f32 dt) {
+		PROFILE_FUNCTION();
+		stats = Stats{};
+		stats.bodies = numBodies;
+
+		starts.resize(bodies.size());
+		deltas.assign(bodies.size(), vec2{ 0.f });
+
+		f64 start = global.time->CurrentTime();
+		for (BodyId id = 0; id < bodies.size(); id++) {
+			Body& body = bodies[id];
+			starts[id] = body.box;
+			if (!alive[id] || body.type == Body::Static) {
+				continue;
+			}
+
+			if (body.type == Body::Dynamic) {
+				body.velocity += gravity * (body.gravityScale * dt);
+			}
+
+			const vec2 delta = body.velocity * dt;
+			if (delta.x == 0.f && delta.y == 0.f) {
+				continue;
+			}
+
+			if (tiles && body.type == Body::Dynamic) {
+				const TileGrid::Hit hit = tiles->Slide(body.box, delta);
+				if (hit.x) {
+					body.velocity.x = 0.f;
+				}
+				if (hit.y) {
+					body.velocity.y = 0.f;
+				}
+				body.grounded = hit.grounded;
+			}
+			else {
+				body.box = body.box.Translated(delta);
+				body.grounded = false;
+			}
+			deltas[id] = body.box.min - starts[id].min;
+
+			//The whole swept area, so bodies passed through during the step still end up as a pair
+			broadphase->Update(id, starts[id].Union(body.box));
+			stats.moved++;
+		}
+		stats.integrateTime = global.time->CurrentTime() - start;
+
+		start = global.time->CurrentTime();
+		broadphase->FindPairs(pairs);
+		stats.broadphase = broadphase->LastStats();
+		stats.broadphaseTime = global.time->CurrentTime() - start;
+
+		start = global.time->CurrentTime();
+		SweepBodies();
+		stats.sweepTime = global.time->CurrentTime() - start;
+
+		start = global.time->CurrentTime();
+		for (const Pair& pair : pairs) {
+			Resolve(bodies[pair.a], bodies[pair.b]);
+		}
+
+		for (BodyId id = 0; id < bodies.size(); id++) {
+			if (deltas[id].x != 0.f || deltas[id].y != 0.f) {
+				broadphase->Update(id, bodies[id].box);
+			}
+		}
+		for (const Pair& pair : pairs) {
+			for (BodyId id : { pair.a, pair.b }) {
+				if (bodies[id].type == Body::Dynamic) {
+					broadphase->Update(id, bodies[id].box);
+				}
+			}
+		}
+		stats.resolveTime = global.time->CurrentTime() - start;
+	}
+
+	void World::SweepBodies() {
+		sweeps.Clear();
+		sweepPairs.clear();
+
+		//Every candidate pair is swept from where both bodies started, in the frame of the second one
+		for (const Pair& pair : pairs) {
+			const Body& a = bodies[pair.a];
+			const Body& b = bodies[pair.b];
+			if (a.type == Body::Sensor || b.type == Body::Sensor || (a.type != Body::Dynamic && b.type != Body::Dynamic)) {
+				continue;
+			}
+
+			const vec2 delta = deltas[pair.a] - deltas[pair.b];
+			if (delta.x == 0.f && delta.y == 0.f) {
+				continue;
+			}
+
+			sweeps.Add(starts[pair.a], delta, starts[pair.b]);
+			sweepPairs.push_back(pair);
+		}
+
+		sweeps.Run();
+		stats.sweeps = static_cast<u32>(sweeps.Size());
+		if (sweeps.Size() == 0) {
+			return;
+		}
+
+		contacts.assign(bodies.size(), Contact{});
+		for (usize i = 0; i < sweeps.Size(); i++) {
+			if (!sweeps.Hit(i)) {
+				continue;
+			}
+
+			const Pair& pair = sweepPairs[i];
+			const vec2 normal = sweeps.Normal(i);
+			const f32 time = sweeps.Time(i);
+
+			Contact& a = contacts[pair.a];
+			if (time < a.time) {
+				a = Contact{ time, normal, normal.y < 0.f && bodies[pair.b].type == Body::Static };
+			}
+
+			Contact& b = contacts[pair.b];
+			if (time < b.time) {
+				b = Contact{ time, -normal, normal.y > 0.f && bodies[pair.a].type == Body::Static };
+			}
+			stats.hits++;
+		}
+
+		//Each body is moved back to its first contact and slides the rest of the step along it
+		for (const Pair& pair : sweepPairs) {
+			for (BodyId id : { pair.a, pair.b }) {
+				Contact& contact = contacts[id];
+				Body& body = bodies[id];
+				if (contact.time >= 1.f || body.type != Body::Dynamic) {
+					continue;
+				}
+
+				const vec2 delta = deltas[id];
+				vec2 rest = delta * (1.f - contact.time);
+				if (contact.normal.x != 0.f) {
+					rest.x = 0.f;
+					if (body.velocity.x * contact.normal.x < 0.f) body.velocity.x = 0.f;
+				}
+				else {
+					rest.y = 0.f;
+					if (body.velocity.y * contact.normal.y < 0.f) body.velocity.y = 0.f;
+				}
+				body.grounded |= contact.grounded;
+
+				body.box = starts[id];
+				Push(body, delta * contact.time);
+				Push(body, rest);
+
+				//Only handled once per step
+				contact.time = 1.f;
+			}
+		}
+	}
+
+	void World::Resolve(Body& a, Body& b) {
+		if (a.type == Body::Sensor || b.type == Body::Sensor || (a.type == Body::Static && b.type == Body::Static)) {
+			return;
+		}
+
+		//Boxes may already have been separated by an earlier pair this step
+		if (!a.box.Overlaps(b.box)) {
+			return;
+		}
+
+		//Push apart along the axis of least penetration, all the way out of a static body or half way each between dynamic ones
+		const vec2 overlap{
+			math::Min(a.box.max.x, b.box.max.x) - math::Max(a.box.min.x, b.box.min.x),
+			math::Min(a.box.max.y, b.box.max.y) - math::Max(a.box.min.y, b.box.min.y)
+		};
+		const vec2 direction{
+			a.box.Center().x < b.box.Center().x ? -1.f : 1.f,
+			a.box.Center().y < b.box.Center().y ? -1.f : 1.f
+		};
+
+		const f32 shareA = b.type == Body::Static ? 1.f : (a.type == Body::Static ? 0.f : 0.5f);
+		const b8 alongX = overlap.x < overlap.y;
+		const vec2 push = alongX ? vec2{ overlap.x * direction.x, 0.f } : vec2{ 0.f, overlap.y * direction.y };
+
+		Push(a, push * shareA);
+		Push(b, push * (shareA - 1.f));
+
+		if (alongX) {
+			if (a.type == Body::Dynamic) a.velocity.x = 0.f;
+			if (b.type == Body::Dynamic) b.velocity.x = 0.f;
+		}
+		else {
+			if (a.type == Body::Dynamic) {
+				a.velocity.y = 0.f;
+				a.grounded |= direction.y < 0.f && b.type == Body::Static;
+			}
+			if (b.type == Body::Dynamic) {
+				b.velocity.y = 0.f;
+				b.grounded |= direction.y > 0.f && a.type == Body::Static;
+			}
+		}
+	}
+
+	void World::Push(Body& body, vec2 delta) {
+		if (body.type != Body::Dynamic || (delta.x == 0.f && delta.y == 0.f)) {
+			return;
+		}
+
+		//Through the tiles, a body pushed into a floor would fall through it on the next step
+		if (tiles) {
+			tiles->Slide(body.box, delta);
+		}
+		else {
+			body.box = body.box.Translated(delta);
+		}
+	}
+
+	void World::Query(const AABB& box, std::vector<BodyId>& result) {
+		broadphase->Query(box, result);
+	}
+}
\ No newline at end of file
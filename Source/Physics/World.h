@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Broadphase.h"
+#include "TileGrid.h"
+
+namespace physics {
+
+	enum class BroadphaseType : u32 {
+		SpatialHash,
+		SweepAndPrune
+	};
+
+	struct Body {
+		enum Type : u8 {
+			Static, //Never moves, other bodies are pushed out of it
+			Dynamic, //Moved by velocity and gravity, collides with tiles and bodies
+			Sensor //Moved by velocity only, reports pairs but is never pushed
+		};
+
+		AABB box;
+		vec2 velocity{ 0.f };
+		f32 gravityScale = 1.f;
+		Type type = Dynamic;
+		b8 grounded = false; //Standing on a tile or a static body after the last step
+		u32 userData = 0;
+	};
+
+	//Bodies are axis aligned boxes in pixels with y pointing down. Every Step() integrates velocity,
+	//sweeps dynamic bodies through the tile grid, updates the broadphase with the bounds each moved
+	//body swept over, sweeps every candidate pair in one batch to stop bodies at their first contact
+	//and finally pushes dynamic bodies out of the static and dynamic bodies they still overlap.
+	//Nothing moving less than a tile or body per step gets tunneled through
+	class World {
+	public:
+		static constexpr f32 DEFAULT_CELL_SIZE = 32.f;
+
+		struct Stats {
+			u32 bodies = 0;
+			u32 moved = 0;
+			u32 sweeps = 0;
+			u32 hits = 0;
+			Broadphase::Stats broadphase;
+			f64 integrateTime = 0.0; //In ms
+			f64 broadphaseTime = 0.0;
+			f64 sweepTime = 0.0;
+			f64 resolveTime = 0.0;
+		};
+
+		World(BroadphaseType type = BroadphaseType::SpatialHash, f32 cellSize = DEFAULT_CELL_SIZE);
+
+		World(const World& other) = delete;
+		World& operator=(const World& other) = delete;
+
+		BodyId Create(const Body& body);
+		void Destroy(BodyId id);
+
+		inline Body& Get(BodyId id) { return bodies[id]; }
+		inline const Body& Get(BodyId id) const { return bodies[id]; }
+
+		//Moves a body without collision, e.g. to place a static body or teleport
+		void SetBox(BodyId id, const AABB& box);
+
+		//Rebuilds the broadphase from the current bodies
+		void SetBroadphase(BroadphaseType type, f32 cellSize = DEFAULT_CELL_SIZE);
+		inline BroadphaseType GetBroadphaseType() const { return broadphaseType; }
+
+		//The grid has to outlive the world, nullptr disables tile collision
+		inline void SetTiles(const TileGrid* newTiles) { tiles = newTiles; }
+
+		inline void SetGravity(vec2 newGravity) { gravity = newGravity; }
+
+		//dt in seconds
+		void Step(f32 dt);
+
+		//Pairs whose swept bounds overlapped during the last step, before they were resolved
+		inline const std::vector<Pair>& Pairs() const { return pairs; }
+
+		void Query(const AABB& box, std::vector<BodyId>& result);
+
+		inline u32 NumBodies() const { return numBodies; }
+		inline const Stats& LastStats() const { return stats; }
+
+	private:
+		//Earliest contact of a body with another body during the step
+		struct Contact {
+			f32 time = 1.f;
+			vec2 normal{ 0.f };
+			b8 grounded = false;
+		};
+
+		void SweepBodies();
+		void Resolve(Body& a, Body& b);
+		void Push(Body& body, vec2 delta);
+
+		std::vector<Body> bodies;
+		std::vector<b8> alive;
+		std::vector<BodyId> freeIds;
+		u32 numBodies = 0;
+
+		std::unique_ptr<Broadphase> broadphase;
+		BroadphaseType broadphaseType;
+		const TileGrid* tiles = nullptr;
+		vec2 gravity{ 0.f, 600.f };
+
+		std::vector<Pair> pairs;
+		Stats stats;
+
+		//Per body, where it started the step and how far it moved through the tiles
+		std::vector<AABB> starts;
+		std::vector<vec2> deltas;
+		std::vector<Contact> contacts;
+
+		SweepBatch sweeps;
+		std::vector<Pair> sweepPairs;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "Allocator.h"
+#include "Util\Log.h"
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize align) {
+	return align > 1 ? (value + align - 1) / align * align : value;
+}
+
+static VkDeviceSize AlignDown(VkDeviceSize value, VkDeviceSize align) {
+	return align > 1 ? value / align * align : value;
+}
+
+static std::string FormatBytes(VkDeviceSize bytes) {
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	if (bytes >= 1024ull * 1024ull) {
+		ss << static_cast<f64>(bytes) / (1024.0 * 1024.0) << " MiB";
+	}
+	else {
+		ss << static_cast<f64>(bytes) / 1024.0 << " KiB";
+	}
+	return ss.str();
+}
+
+namespace platform {
+
+	MemoryAllocator::MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice)
+		: device(device) {
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProps);
+
+		VkPhysicalDeviceProperties props;
+		vkGetPhysicalDeviceProperties(physicalDevice, &props);
+		nonCoherentAtomSize = props.limits.nonCoherentAtomSize;
+		maxAllocations = props.limits.maxMemoryAllocationCount;
+	}
+
+	MemoryAllocator::~MemoryAllocator() {
+		for (auto& pool : pools) {
+			for (auto& block : pool.blocks) {
+				if (block->allocations > 0) {
+					WARNNG(util::Logger::Vulkan, "Leaked $ allocation(s) in memory type $!",
+						block->allocations, block->memoryType);
+				}
+
+				if (block->mapped) {
+					vkUnmapMemory(device, block->memory);
+				}
+				vkFreeMemory(device, block->memory, nullptr);
+			}
+		}
+	}
+
+	//Returns UINT32_MAX if none were found
+	uint32_t MemoryAllocator::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags props) const {
+		for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+			if (((1 << i) & typeBits) &&
+				(memProps.memoryTypes[i].propertyFlags & props) == props) {
+				return i;
+			}
+		}
+
+		return UINT32_MAX;
+	}
+
+	VkDeviceSize MemoryAllocator::BlockSize(uint32_t memoryType) const {
+		//Small heaps (integrated GPUs, BAR memory) shouldn't be eaten by a single block
+		VkDeviceSize heapSize = memProps.memoryHeaps[memProps.memoryTypes[memoryType].heapIndex].size;
+		return math::Min(DEFAULT_BLOCK_SIZE, AlignUp(heapSize / 8, 1024ull * 1024ull));
+	}
+
+	VkResult MemoryAllocator::Allocate(
+		const VkMemoryRequirements& memReqs,
+		VkMemoryPropertyFlags props,
+		b8 linear,
+		Allocation& allocation
+	) {
+		std::lock_guard lock(mutex);
+
+		uint32_t memoryType = FindMemoryType(memReqs.memoryTypeBits, props);
+		if (memoryType == UINT32_MAX) {
+			return VK_ERROR_FEATURE_NOT_PRESENT;
+		}
+
+		const VkDeviceSize blockSize = BlockSize(memoryType);
+
+		//Huge resources get their own memory so they don't waste most of a block
+		if (memReqs.size > blockSize / 2) {
+			return AllocateDedicated(memReqs, memoryType, allocation);
+		}
+
+		VkDeviceSize align = memReqs.alignment;
+		VkMemoryPropertyFlags typeFlags = memProps.memoryTypes[memoryType].propertyFlags;
+		if ((typeFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+			&& !(typeFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+			//Keeps flushes of one allocation from touching its neighbours
+			align = math::Max(align, nonCoherentAtomSize);
+		}
+
+		const VkDeviceSize size = AlignUp(memReqs.size, align);
+
+		Pool& pool = GetPool(memoryType, linear);
+		MemoryBlock* block = nullptr;
+		VkDeviceSize offset = 0;
+		for (auto& candidate : pool.blocks) {
+			if (candidate->size - candidate->used >= size
+				&& AllocateFromBlock(*candidate, size, align, offset)) {
+				block = candidate.get();
+				break;
+			}
+		}
+
+		if (!block) {
+			VkResult result = AllocateBlock(memoryType, blockSize, block);
+			if (result != VK_SUCCESS) {
+				//Device may be out of memory for a full block, but not for just this resource
+				return AllocateDedicated(memReqs, memoryType, allocation);
+			}
+
+			block->linear = linear;
+			pool.blocks.push_back(std::unique_ptr<MemoryBlock>(block));
+
+			[[maybe_unused]] b8 fits = AllocateFromBlock(*block, size, align, offset);
+			ASSERT(fits, "Fresh memory block is too small!");
+		}
+
+		allocation.memory = block->memory;
+		allocation.offset = offset;
+		allocation.size = size;
+		allocation.mapped = block->mapped ? block->mapped + offset : nullptr;
+		allocation.block = block;
+		allocation.memoryType = memoryType;
+
+		return VK_SUCCESS;
+	}
+
+	VkResult MemoryAllocator::AllocateDedicated(
+		const VkMemoryRequirements& memReqs,
+		uint32_t memoryType,
+		Allocation& allocation
+	) {
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memReqs.size;
+		allocInfo.memoryTypeIndex = memoryType;
+
+		VkResult result = vkAllocateMemory(device, &allocInfo, nullptr, &allocation.memory);
+		if (result != VK_SUCCESS) {
+			return result;
+		}
+
+		allocation.offset = 0;
+		allocation.size = memReqs.size;
+		allocation.mapped = nullptr;
+		allocation.block = nullptr;
+		allocation.memoryType = memoryType;
+
+		if (memProps.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+			result = vkMapMemory(device, allocation.memory, 0, VK_WHOLE_SIZE, 0, &allocation.mapped);
+			if (result != VK_SUCCESS) {
+				vkFreeMemory(device, allocation.memory, nullptr);
+				allocation.memory = VK_NULL_HANDLE;
+				return result;
+			}
+		}
+
+		dedicatedBytes[memoryType] += memReqs.size;
+		dedicatedCount[memoryType]++;
+		deviceAllocations++;
+
+		return VK_SUCCESS;
+	}
+
+	VkResult MemoryAllocator::AllocateBlock(uint32_t memoryType, VkDeviceSize size, MemoryBlock*& block) {
+		if (deviceAllocations >= maxAllocations) {
+			WARNNG(util::Logger::Vulkan, "Hit maxMemoryAllocationCount ($)!", maxAllocations);
+			return VK_ERROR_TOO_MANY_OBJECTS;
+		}
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory;
+		VkResult result = vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+		if (result != VK_SUCCESS) {
+			return result;
+		}
+
+		void* mapped = nullptr;
+		if (memProps.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+			//Blocks stay persistently mapped since a VkDeviceMemory can only be mapped once
+			result = vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+			if (result != VK_SUCCESS) {
+				vkFreeMemory(device, memory, nullptr);
+				return result;
+			}
+		}
+
+		block = new MemoryBlock();
+		block->memory = memory;
+		block->size = size;
+		block->mapped = reinterpret_cast<u8*>(mapped);
+		block->memoryType = memoryType;
+		block->freeRanges[0] = size;
+
+		deviceAllocations++;
+
+		return VK_SUCCESS;
+	}
+
+	//First fit, leaving any alignment padding behind as its own free range
+	b8 MemoryAllocator::AllocateFromBlock(MemoryBlock& block, VkDeviceSize size, VkDeviceSize align, VkDeviceSize& offset) {
+		for (auto iter = block.freeRanges.begin(); iter != block.freeRanges.end(); iter++) {
+			const auto [rangeOffset, rangeSize] = *iter;
+			const VkDeviceSize aligned = AlignUp(rangeOffset, align);
+			if (aligned + size > rangeOffset + rangeSize) {
+				continue;
+			}
+
+			block.freeRanges.erase(iter);
+
+			if (aligned > rangeOffset) {
+				block.freeRanges[rangeOffset] = aligned - rangeOffset;
+			}
+
+			const VkDeviceSize end = aligned + size;
+			if (end < rangeOffset + rangeSize) {
+				block.freeRanges[end] = rangeOffset + rangeSize - end;
+			}
+
+			block.used += size;
+			block.allocations++;
+			offset = aligned;
+			return true;
+		}
+
+		return false;
+	}
+
+	void MemoryAllocator::FreeToBlock(MemoryBlock& block, VkDeviceSize offset, VkDeviceSize size) {
+		auto [iter, inserted] = block.freeRanges.emplace(offset, size);
+		ASSERT(inserted, "Double free of device memory!");
+
+		//Coalesce with the next range
+		auto next = std::next(iter);
+		if (next != block.freeRanges.end() && iter->first + iter->second == next->first) {
+			iter->second += next->second;
+			block.freeRanges.erase(next);
+		}
+
+		//Coalesce with the previous range
+		if (iter != block.freeRanges.begin()) {
+			auto prev = std::prev(iter);
+			if (prev->first + prev->second == iter->first) {
+				prev->second += iter->second;
+				block.freeRanges.erase(iter);
+			}
+		}
+
+		block.used -= size;
+		block.allocations--;
+	}
+
+	void MemoryAllocator::Free(Allocation& allocation) {
+		if (!allocation) {
+			return;
+		}
+
+		std::lock_guard lock(mutex);
+
+		if (allocation.IsDedicated()) {
+			if (allocation.mapped) {
+				vkUnmapMemory(device, allocation.memory);
+			}
+			vkFreeMemory(device, allocation.memory, nullptr);
+
+			dedicatedBytes[allocation.memoryType] -= allocation.size;
+			dedicatedCount[allocation.memoryType]--;
+			deviceAllocations--;
+		}
+		else {
+			MemoryBlock* block = allocation.block;
+			FreeToBlock(*block, allocation.offset, allocation.size);
+
+			//Release empty blocks, but keep one around so alloc/free patterns don't thrash the driver
+			if (block->allocations == 0) {
+				Pool& pool = GetPool(block->memoryType, block->linear);
+				usize emptyBlocks = std::count_if(pool.blocks.begin(), pool.blocks.end(),
+					[](const auto& b) { return b->allocations == 0; });
+
+				if (emptyBlocks > 1) {
+					if (block->mapped) {
+						vkUnmapMemory(device, block->memory);
+					}
+					vkFreeMemory(device, block->memory, nullptr);
+					deviceAllocations--;
+
+					std::erase_if(pool.blocks, [block](const auto& b) { return b.get() == block; });
+				}
+			}
+		}
+
+		allocation = Allocation{};
+	}
+
+	VkMappedMemoryRange MemoryAllocator::MappedRange(
+		const Allocation& allocation,
+		VkDeviceSize size,
+		VkDeviceSize offset
+	) const {
+		const VkDeviceSize memorySize = allocation.IsDedicated()
+			? allocation.size : allocation.block->size;
+
+		VkDeviceSize begin = AlignDown(allocation.offset + offset, nonCoherentAtomSize);
+		VkDeviceSize end = (size == VK_WHOLE_SIZE)
+			? allocation.offset + allocation.size
+			: allocation.offset + offset + size;
+		end = math::Min(AlignUp(end, nonCoherentAtomSize), memorySize);
+
+		VkMappedMemoryRange range{};
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.memory = allocation.memory;
+		range.offset = begin;
+		range.size = (end == memorySize) ? VK_WHOLE_SIZE : end - begin;
+		return range;
+	}
+
+	MemoryAllocator::Stats MemoryAllocator::GetStats(uint32_t memoryType) const {
+		std::lock_guard lock(mutex);
+
+		Stats stats{};
+		for (b8 linear : { true, false }) {
+			const Pool& pool = pools[memoryType * 2 + (linear ? 0 : 1)];
+			for (const auto& block : pool.blocks) {
+				stats.blocks++;
+				stats.allocations += block->allocations;
+				stats.reserved += block->size;
+				stats.used += block->used;
+				stats.totalFree += block->size - block->used;
+				for (const auto& [offset, size] : block->freeRanges) {
+					stats.largestFree = math::Max(stats.largestFree, size);
+				}
+			}
+		}
+
+		stats.dedicated = dedicatedCount[memoryType];
+		stats.allocations += dedicatedCount[memoryType];
+		stats.reserved += dedicatedBytes[memoryType];
+		stats.used += dedicatedBytes[memoryType];
+
+		return stats;
+	}
+
+	MemoryAllocator::Stats MemoryAllocator::GetStats() const {
+		Stats total{};
+		for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+			Stats stats = GetStats(i);
+			total.blocks += stats.blocks;
+			total.dedicated += stats.dedicated;
+			total.allocations += stats.allocations;
+			total.reserved += stats.reserved;
+			total.used += stats.used;
+			total.totalFree += stats.totalFree;
+			total.largestFree = math::Max(total.largestFree, stats.largestFree);
+		}
+
+		return total;
+	}
+
+	void MemoryAllocator::LogStats() const {
+		std::stringstream msg;
+		msg << std::fixed << std::setprecision(1);
+
+		Stats total = GetStats();
+		msg << "Device memory: " << total.allocations << " allocation(s) in "
+			<< total.blocks << " block(s) + " << total.dedicated << " dedicated, "
+			<< FormatBytes(total.used) << " used of " << FormatBytes(total.reserved) << " reserved";
+
+		for (uint32_t i = 0; i < memProps.memoryTypeCount; i++) {
+			Stats stats = GetStats(i);
+			if (stats.reserved == 0) {
+				continue;
+			}
+
+			msg << "\n\tType " << i << " (heap " << memProps.memoryTypes[i].heapIndex << "): "
+				<< stats.allocations << " allocation(s), "
+				<< FormatBytes(stats.used) << " / " << FormatBytes(stats.reserved)
+				<< ", largest free " << FormatBytes(stats.largestFree)
+				<< ", fragmentation " << stats.Fragmentation() * 100.0 << "%";
+		}
+
+		LOGNFNG(util::Logger::Vulkan, msg.str());
+	}
+}
\ No newline at end of file
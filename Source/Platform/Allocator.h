@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Util\Types.h"
+#include "Util\Std.h"
+#include "Util\Vulkan.h"
+
+namespace platform {
+
+	class MemoryAllocator;
+	struct MemoryBlock;
+
+	//A range of device memory handed out by the MemoryAllocator
+	struct Allocation {
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr; //Only set for host visible memory
+
+		inline explicit operator bool() const { return memory != VK_NULL_HANDLE; }
+		inline b8 IsDedicated() const { return block == nullptr; }
+
+	private:
+		MemoryBlock* block = nullptr;
+		uint32_t memoryType = UINT32_MAX;
+
+		friend MemoryAllocator;
+	};
+
+	struct MemoryBlock {
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize size = 0;
+		VkDeviceSize used = 0;
+		u8* mapped = nullptr;
+		u32 allocations = 0;
+		uint32_t memoryType = UINT32_MAX;
+		b8 linear = true;
+
+		std::map<VkDeviceSize, VkDeviceSize> freeRanges; //Offset -> size
+	};
+
+	//Carves large blocks of device memory into sub-allocations so that every buffer and image
+	//doesn't need its own vkAllocateMemory. Linear (buffers) and optimal (images) resources are
+	//kept in separate pools so bufferImageGranularity never has to be considered.
+	class MemoryAllocator {
+	public:
+		static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024ull * 1024ull;
+
+		struct Stats {
+			u64 blocks = 0;
+			u64 dedicated = 0;
+			u64 allocations = 0;
+			VkDeviceSize reserved = 0;
+			VkDeviceSize used = 0;
+			VkDeviceSize totalFree = 0;
+			VkDeviceSize largestFree = 0;
+
+			//0 means all free memory is contiguous, 1 means it's completely scattered
+			inline f64 Fragmentation() const {
+				return totalFree == 0 ? 0.0
+					: 1.0 - static_cast<f64>(largestFree) / static_cast<f64>(totalFree);
+			}
+		};
+
+		MemoryAllocator(VkDevice device, VkPhysicalDevice physicalDevice);
+		~MemoryAllocator();
+
+		MemoryAllocator(const MemoryAllocator& other) = delete;
+		MemoryAllocator& operator=(const MemoryAllocator& other) = delete;
+
+		VkResult Allocate(
+			const VkMemoryRequirements& memReqs,
+			VkMemoryPropertyFlags memProps,
+			b8 linear,
+			Allocation& allocation
+		);
+
+		void Free(Allocation& allocation);
+
+		//Builds a range suitable for vkFlushMappedMemoryRanges, rounded to nonCoherentAtomSize
+		VkMappedMemoryRange MappedRange(
+			const Allocation& allocation,
+			VkDeviceSize size = VK_WHOLE_SIZE,
+			VkDeviceSize offset = 0
+		) const;
+
+		Stats GetStats() const;
+		Stats GetStats(uint32_t memoryType) const;
+		void LogStats() const;
+
+	private:
+		struct Pool {
+			std::vector<std::unique_ptr<MemoryBlock>> blocks;
+		};
+
+		uint32_t FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags memProps) const;
+		VkDeviceSize BlockSize(uint32_t memoryType) const;
+
+		VkResult AllocateDedicated(const VkMemoryRequirements& memReqs, uint32_t memoryType, Allocation& allocation);
+		VkResult AllocateBlock(uint32_t memoryType, VkDeviceSize size, MemoryBlock*& block);
+		static b8 AllocateFromBlock(MemoryBlock& block, VkDeviceSize size, VkDeviceSize align, VkDeviceSize& offset);
+		static void FreeToBlock(MemoryBlock& block, VkDeviceSize offset, VkDeviceSize size);
+
+		inline Pool& GetPool(uint32_t memoryType, b8 linear) {
+			return pools[memoryType * 2 + (linear ? 0 : 1)];
+		}
+
+		VkDevice device;
+		VkPhysicalDeviceMemoryProperties memProps;
+		VkDeviceSize nonCoherentAtomSize;
+		uint32_t maxAllocations;
+
+		std::array<Pool, VK_MAX_MEMORY_TYPES * 2> pools;
+		std::array<VkDeviceSize, VK_MAX_MEMORY_TYPES> dedicatedBytes{};
+		std::array<u64, VK_MAX_MEMORY_TYPES> dedicatedCount{};
+		u32 deviceAllocations = 0;
+
+		mutable std::mutex mutex;
+	};
+}
\ No newline at end of file
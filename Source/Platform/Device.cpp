@@ -3,17 +3,23 @@
 static std::vector<uint32_t> UniqueQueueFamilies(const platform::Device::QueueFamilyIndices& indices, uint32_t types) {
 	std::vector<uint32_t> families;
 
+	auto add = [&families](uint32_t family) {
+		if (std::find(families.begin(), families.end(), family) == families.end()) {
+			families.push_back(family);
+		}
+	};
+
 	if (types & vk::QueueFamilies::Graphics) {
-		families.push_back(*indices.graphicsFamily);
+		add(*indices.graphicsFamily);
+	}
+	if (types & vk::QueueFamilies::Present) {
+		add(*indices.presentFamily);
 	}
-	if ((types & vk::QueueFamilies::Present)
-		&& indices.graphicsFamily != indices.presentFamily) {
-		families.push_back(*indices.presentFamily);
+	if (types & vk::QueueFamilies::Compute) {
+		add(*indices.computeFamily);
 	}
-	if ((types & vk::QueueFamilies::Compute)
-		&& indices.graphicsFamily != indices.computeFamily
-		&& indices.presentFamily != indices.computeFamily) {
-		families.push_back(*indices.computeFamily);
+	if (types & vk::QueueFamilies::Transfer) {
+		add(*indices.transferFamily);
 	}
 
 	return families;
@@ -88,7 +94,7 @@ namespace platform {
 		auto indices = GetQueueFamilyIndices();
 		std::vector<VkDeviceQueueCreateInfo> queues{};
 		std::set<uint32_t> uniqueIndices = {
-			*indices.graphicsFamily, *indices.presentFamily, *indices.computeFamily
+			*indices.graphicsFamily, *indices.presentFamily, *indices.computeFamily, *indices.transferFamily
 		};
 
 		float priority = 1.f;
@@ -120,9 +126,12 @@ namespace platform {
 		VULKAN_CHECK(vkCreateDevice(physicalDevice, &createInfo, nullptr, &device),
 			"Failed to create device!");
 
+		allocator = std::make_unique<MemoryAllocator>(device, physicalDevice);
+
 		vkGetDeviceQueue(device, *indices.graphicsFamily, 0, &graphicsQueue);
 		vkGetDeviceQueue(device, *indices.presentFamily, 0, &presentQueue);
 		vkGetDeviceQueue(device, *indices.computeFamily, 0, &computeQueue);
+		vkGetDeviceQueue(device, *indices.transferFamily, 0, &transferQueue);
 
 		VkCommandPoolCreateInfo poolInfo{};
 		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -139,6 +148,8 @@ namespace platform {
 		vkDestroyCommandPool(device, graphicsPool, nullptr);
 		vkDestroyCommandPool(device, computePool, nullptr);
 
+		allocator.reset();
+
 		vkDestroyDevice(device, nullptr);
 
 		vkDestroySurfaceKHR(instance, surface, nullptr);
@@ -208,10 +219,23 @@ namespace platform {
 			}
 
 			if (indices.IsComplete()) {
-				return indices;
+				break;
+			}
+		}
+
+		//Prefer a transfer-only family, which usually maps to a dedicated DMA engine
+		for (uint32_t i = 0; i < queues.size(); i++) {
+			if ((queues[i].queueFlags & VK_QUEUE_TRANSFER_BIT)
+				&& !(queues[i].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+				indices.transferFamily = i;
+				break;
 			}
 		}
 
+		if (!indices.transferFamily) {
+			indices.transferFamily = indices.graphicsFamily;
+		}
+
 		return indices;
 	}
 
@@ -233,6 +257,10 @@ namespace platform {
 		return caps;
 	}
 
+	b8 Device::IsConcurrent(uint32_t families) const {
+		return UniqueQueueFamilies(GetQueueFamilyIndices(), families).size() > 1;
+	}
+
 	//Returns UINT32_MAX if none were found
 	uint32_t Device::FindMemoryType(const VkMemoryRequirements& memReqs, VkMemoryPropertyFlags memProps) const {
 		VkPhysicalDeviceMemoryProperties deviceMemProps;
@@ -254,7 +282,7 @@ namespace platform {
 		VkMemoryPropertyFlags memProps,
 		uint32_t families,
 		VkBuffer& buffer,
-		VkDeviceMemory& memory
+		Allocation& allocation
 	) const {
 		VkBufferCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -279,17 +307,14 @@ namespace platform {
 		VkMemoryRequirements memReqs;
 		vkGetBufferMemoryRequirements(device, buffer, &memReqs);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memReqs.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memReqs, memProps);
-
-		result = vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+		result = allocator->Allocate(memReqs, memProps, true, allocation);
 		if (result != VK_SUCCESS) {
+			vkDestroyBuffer(device, buffer, nullptr);
+			buffer = VK_NULL_HANDLE;
 			return result;
 		}
 
-		return vkBindBufferMemory(device, buffer, memory, 0);
+		return vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
 	}
 
 	VkResult Device::CreateImage(
@@ -301,10 +326,8 @@ namespace platform {
 		VkImageLayout initialLayout,
 		VkSampleCountFlagBits samples,
 		VkImageUsageFlags usage,
-		VkMemoryPropertyFlags memProps,
 		uint32_t families,
-		VkImage& image,
-		VkDeviceMemory& memory
+		VkImage& image
 	) const {
 		VkImageCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -329,7 +352,25 @@ namespace platform {
 			createInfo.pQueueFamilyIndices = uniqueIndices.data();
 		}
 		
-		VkResult result = vkCreateImage(device, &createInfo, nullptr, &image);
+		return vkCreateImage(device, &createInfo, nullptr, &image);
+	}
+
+	VkResult Device::CreateImage(
+		VkFormat format,
+		VkExtent3D extent,
+		VkImageType type,
+		uint32_t levels, uint32_t layers,
+		VkImageTiling tiling,
+		VkImageLayout initialLayout,
+		VkSampleCountFlagBits samples,
+		VkImageUsageFlags usage,
+		VkMemoryPropertyFlags memProps,
+		uint32_t families,
+		VkImage& image,
+		Allocation& allocation
+	) const {
+		VkResult result = CreateImage(format, extent, type, levels, layers, tiling,
+			initialLayout, samples, usage, families, image);
 		if (result != VK_SUCCESS) {
 			return result;
 		}
@@ -337,17 +378,24 @@ namespace platform {
 		VkMemoryRequirements memReqs;
 		vkGetImageMemoryRequirements(device, image, &memReqs);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memReqs.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memReqs, memProps);
-
-		result = vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+		result = allocator->Allocate(memReqs, memProps, tiling == VK_IMAGE_TILING_LINEAR, allocation);
 		if (result != VK_SUCCESS) {
+			vkDestroyImage(device, image, nullptr);
+			image = VK_NULL_HANDLE;
 			return result;
 		}
 
-		return vkBindImageMemory(device, image, memory, 0);
+		return vkBindImageMemory(device, image, allocation.memory, allocation.offset);
+	}
+
+	void Device::DestroyBuffer(VkBuffer buffer, Allocation& allocation) const {
+		vkDestroyBuffer(device, buffer, nullptr);
+		allocator->Free(allocation);
+	}
+
+	void Device::DestroyImage(VkImage image, Allocation& allocation) const {
+		vkDestroyImage(device, image, nullptr);
+		allocator->Free(allocation);
 	}
 
 	VkResult Device::CreateImageView(
@@ -2,6 +2,7 @@
 
 #include "Instance.h"
 #include "Window.h"
+#include "Allocator.h"
 
 namespace platform {
 
@@ -15,6 +16,7 @@ namespace platform {
 			std::optional<uint32_t> graphicsFamily;
 			std::optional<uint32_t> presentFamily;
 			std::optional<uint32_t> computeFamily;
+			std::optional<uint32_t> transferFamily; //Falls back to the graphics family
 
 			inline bool IsComplete() {
 				return graphicsFamily.has_value() && presentFamily.has_value() && computeFamily.has_value();
@@ -42,8 +44,11 @@ namespace platform {
 		inline VkQueue GraphicsQueue() const { return graphicsQueue; }
 		inline VkQueue PresentQueue() const { return presentQueue; }
 		inline VkQueue ComputeQueue() const { return computeQueue; }
+		inline VkQueue TransferQueue() const { return transferQueue; }
+		inline b8 HasTransferQueue() const { return transferQueue != graphicsQueue; }
 		inline VkCommandPool GraphicsPool() const { return graphicsPool; }
 		inline VkCommandPool ComputePool() const { return computePool; }
+		inline MemoryAllocator& Allocator() const { return *allocator; }
 
 		VkPhysicalDeviceProperties Properties() const;
 		VkPhysicalDeviceFeatures Features() const;
@@ -59,7 +64,21 @@ namespace platform {
 			VkMemoryPropertyFlags memProps,
 			uint32_t families,
 			VkBuffer& buffer,
-			VkDeviceMemory& memory
+			Allocation& allocation
+		) const;
+
+		//Only creates the image, binding memory is left to the caller (used for aliasing)
+		VkResult CreateImage(
+			VkFormat format,
+			VkExtent3D extent,
+			VkImageType type,
+			uint32_t levels, uint32_t layers,
+			VkImageTiling tiling,
+			VkImageLayout initialLayout,
+			VkSampleCountFlagBits samples,
+			VkImageUsageFlags usage,
+			uint32_t families,
+			VkImage& image
 		) const;
 
 		VkResult CreateImage(
@@ -74,9 +93,12 @@ namespace platform {
 			VkMemoryPropertyFlags memProps,
 			uint32_t families,
 			VkImage& image,
-			VkDeviceMemory& memory
+			Allocation& allocation
 		) const;
 
+		void DestroyBuffer(VkBuffer buffer, Allocation& allocation) const;
+		void DestroyImage(VkImage image, Allocation& allocation) const;
+
 		VkResult CreateImageView(
 			VkImage image,
 			VkFormat format,
@@ -134,6 +156,9 @@ namespace platform {
 			return GetSwapchainCapabilities(physicalDevice);
 		}
 
+		//Whether resources created for these families need concurrent sharing
+		b8 IsConcurrent(uint32_t families) const;
+
 		uint32_t FindMemoryType(const VkMemoryRequirements& memReqs, VkMemoryPropertyFlags memProps) const;
 
 	private:
@@ -148,10 +173,13 @@ namespace platform {
 		VkQueue graphicsQueue;
 		VkQueue presentQueue;
 		VkQueue computeQueue;
+		VkQueue transferQueue;
 
 		VkCommandPool graphicsPool;
 		VkCommandPool computePool;
 
+		std::unique_ptr<MemoryAllocator> allocator;
+
 		const Instance& instance;
 	};
 }
\ No newline at end of file
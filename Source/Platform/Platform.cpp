@@ -25,6 +25,9 @@ namespace platform {
 
 	void Platform::Shutdown() {
 		vkDeviceWaitIdle(*device);
+#ifdef GAME_IS_DEBUG
+		device->Allocator().LogStats();
+#endif
 
 		window->Close();
 	}
@@ -9,6 +9,8 @@ namespace util {
 	struct Logger;
 	struct Configuration;
 	class Time;
+	class JobSystem;
+	class Profiler;
 }
 
 namespace platform {
@@ -24,6 +26,8 @@ struct State {
 	util::Logger* log;
 	util::Configuration* config;
 	util::Time* time;
+	util::Profiler* profiler;
+	util::JobSystem* jobs;
 	platform::Platform* platform;
 	gfx::Renderer* renderer;
 
@@ -31,6 +35,7 @@ struct State {
 	util::BumpAllocator allocator;
 	util::BumpAllocator tickAllocator;
 	util::LongAllocator<vk::MAX_FRAMES_IN_FLIGHT> longAllocator;
+	util::ThreadAllocators* threadAllocators; //One frame and tick allocator per job system worker
 };
 
 extern State& global;
\ No newline at end of file
@@ -1,47 +1,295 @@
 #include "Arena.h"
+#include "Util\JobSystem.h"
+#include "Util\Log.h"
+#include "State.h"
 
 namespace util {
 
+	//Room on top of the high water mark when the chain is replaced, and what block sizes are rounded to
+	static constexpr usize HEADROOM_DIVISOR = 4;
+	static constexpr usize BLOCK_GRANULARITY = 4096;
+
 	BumpAllocator::BumpAllocator(usize size) {
-		mem = reinterpret_cast<u8*>(std::malloc(size));
-		current = mem;
-		max = mem + size;
+		minSize = size;
+		Resize(size);
 	}
 
 	BumpAllocator::~BumpAllocator() {
-		if (mem) {
-			std::free(mem);
-		}
+		FreeBlocks();
 	}
 
 	BumpAllocator& BumpAllocator::operator=(BumpAllocator&& other) noexcept {
-		if (mem) {
-			std::free(mem);
-		}
+		FreeBlocks();
 
+		first = other.first;
+		last = other.last;
 		mem = other.mem;
 		current = other.current;
 		max = other.max;
+		minSize = other.minSize;
+		usedBefore = other.usedBefore;
+		std::memcpy(history, other.history, sizeof(history));
+		clears = other.clears;
+		stats = other.stats;
 
+		other.first = nullptr;
+		other.last = nullptr;
 		other.mem = nullptr;
 
 		return *this;
 	}
 
 	void* BumpAllocator::Alloc(usize size, usize align) {
-		u8* aligned = (u8*)((usize)(current + align) & (~align));
+		ASSERT((align & (align - 1)) == 0, "Bump allocation alignment must be a power of two!");
+		const usize mask = align > 1 ? align - 1 : 0;
+		u8* aligned = (u8*)(((usize)current + mask) & ~mask);
 
-		ASSERT(aligned + size < max, "Bump allocation too large!");
+		if (aligned + size > max) {
+			Grow(size + mask);
+			aligned = (u8*)(((usize)current + mask) & ~mask);
+		}
 
-		current += size;
+		current = aligned + size;
 		return aligned;
 	}
 
+	b8 BumpAllocator::Extend(void* ptr, usize size, usize newSize) {
+		u8* end = reinterpret_cast<u8*>(ptr) + size;
+		if (end != current || reinterpret_cast<u8*>(ptr) + newSize > max) {
+			return false;
+		}
+
+		current = reinterpret_cast<u8*>(ptr) + newSize;
+		return true;
+	}
+
+	//Adds stats.used to the history and updates the rest of the stats from it, returns the size one block
+	//would need to hold the high water mark
+	static usize RecordUsage(usize (&history)[BumpAllocator::USAGE_HISTORY], u64& clears, usize minSize, BumpAllocator::Stats& stats) {
+		stats.peak = std::max(stats.peak, stats.used);
+		history[clears % BumpAllocator::USAGE_HISTORY] = stats.used;
+		clears++;
+
+		const usize count = static_cast<usize>(std::min<u64>(clears, BumpAllocator::USAGE_HISTORY));
+		usize highWater = 0, total = 0;
+		for (usize i = 0; i < count; i++) {
+			highWater = std::max(highWater, history[i]);
+			total += history[i];
+		}
+		stats.highWater = highWater;
+		stats.average = static_cast<f64>(total) / static_cast<f64>(count);
+
+		const usize target = highWater + highWater / HEADROOM_DIVISOR;
+		return std::max(minSize, (target + BLOCK_GRANULARITY - 1) / BLOCK_GRANULARITY * BLOCK_GRANULARITY);
+	}
+
 	void BumpAllocator::Clear() {
+		stats.used = usedBefore + static_cast<usize>(current - mem);
+		const usize target = RecordUsage(history, clears, minSize, stats);
+
+		//One block again if it had to grow, or a smaller one once a spike has left the history
+		if (first != last || target * 2 < stats.capacity) {
+			Resize(target);
+			stats.resizes++;
+		}
+#ifdef GAME_IS_DEBUG
+		else {
+			//Poisons what was handed out, so anything still reading it after the Clear() stands out
+			std::memset(mem, 0xFF, current - mem);
+		}
+#endif
+
+		usedBefore = 0;
+		current = mem;
+	}
+
+	void BumpAllocator::LogStats(const std::string& name) const {
+		LOGNG(util::Logger::General, "$: $ KiB used, peak $ KiB, high water $ KiB, average $ KiB, $ KiB in $ block(s), grew $ time(s), resized $ time(s)",
+			name, stats.used / 1024, stats.peak / 1024, stats.highWater / 1024, stats.average / 1024.0,
+			stats.capacity / 1024, stats.blocks, stats.grows, stats.resizes);
+	}
+
+	void BumpAllocator::Grow(usize size) {
+		//Doubles what's there, so a frame that keeps growing only chains a few blocks
+		const usize blockSize = std::max(size, stats.capacity);
+		Block* block = reinterpret_cast<Block*>(std::malloc(sizeof(Block) + blockSize));
+		ASSERT(block, "Out of memory for a bump allocator block!");
+		block->next = nullptr;
+		block->size = blockSize;
+
+		last->next = block;
+		last = block;
+		usedBefore += static_cast<usize>(current - mem);
+		mem = reinterpret_cast<u8*>(block + 1);
+		current = mem;
+		max = mem + blockSize;
+
+		stats.capacity += blockSize;
+		stats.blocks++;
+		stats.grows++;
+	}
+
+	void BumpAllocator::Resize(usize size) {
+		FreeBlocks();
+
+		first = reinterpret_cast<Block*>(std::malloc(sizeof(Block) + size));
+		ASSERT(first, "Out of memory for a bump allocator block!");
+		first->next = nullptr;
+		first->size = size;
+		last = first;
+
+		mem = reinterpret_cast<u8*>(first + 1);
 		current = mem;
+		max = mem + size;
+
+		stats.capacity = size;
+		stats.blocks = 1;
+	}
+
+	void BumpAllocator::FreeBlocks() {
+		Block* block = first;
+		while (block) {
+			Block* next = block->next;
+			std::free(block);
+			block = next;
+		}
+
+		first = nullptr;
+		last = nullptr;
+		mem = nullptr;
+	}
 
+	AtomicBumpAllocator::AtomicBumpAllocator(usize size) {
+		minSize = size;
+		Resize(size);
+	}
+
+	AtomicBumpAllocator::~AtomicBumpAllocator() {
+		FreeBlocks();
+	}
+
+	void* AtomicBumpAllocator::Alloc(usize size, usize align) {
+		ASSERT((align & (align - 1)) == 0, "Bump allocation alignment must be a power of two!");
+		const usize mask = align > 1 ? align - 1 : 0;
+
+		while (true) {
+			Block* block = current.load(std::memory_order_acquire);
+			const usize base = reinterpret_cast<usize>(block->Memory());
+			usize offset = block->offset.load(std::memory_order_relaxed);
+			while (true) {
+				const usize aligned = ((base + offset + mask) & ~mask) - base;
+				if (aligned + size > block->size) {
+					break;
+				}
+				if (block->offset.compare_exchange_weak(offset, aligned + size, std::memory_order_relaxed)) {
+					return block->Memory() + aligned;
+				}
+			}
+
+			//Full, whoever gets the lock first chains the next block and the rest retry in it
+			std::lock_guard lock(mutex);
+			if (current.load(std::memory_order_relaxed) == block) {
+				Block* next = NewBlock(std::max(size + mask, stats.capacity));
+				last->next = next;
+				last = next;
+				current.store(next, std::memory_order_release);
+				stats.grows++;
+			}
+		}
+	}
+
+	void AtomicBumpAllocator::Clear() {
+		stats.used = 0;
+		for (Block* block = first; block; block = block->next) {
+			stats.used += block->offset.load(std::memory_order_relaxed);
+		}
+		const usize target = RecordUsage(history, clears, minSize, stats);
+
+		if (first != last || target * 2 < stats.capacity) {
+			Resize(target);
+			stats.resizes++;
+		}
+		else {
 #ifdef GAME_IS_DEBUG
-		std::memset(mem, 0xFF, max - current);
+			std::memset(first->Memory(), 0xFF, first->offset.load(std::memory_order_relaxed));
 #endif
+			first->offset.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void AtomicBumpAllocator::LogStats(const std::string& name) const {
+		LOGNG(util::Logger::General, "$: $ KiB used, peak $ KiB, high water $ KiB, average $ KiB, $ KiB in $ block(s), grew $ time(s), resized $ time(s)",
+			name, stats.used / 1024, stats.peak / 1024, stats.highWater / 1024, stats.average / 1024.0,
+			stats.capacity / 1024, stats.blocks, stats.grows, stats.resizes);
+	}
+
+	AtomicBumpAllocator::Block* AtomicBumpAllocator::NewBlock(usize size) {
+		void* memory = std::malloc(sizeof(Block) + size);
+		ASSERT(memory, "Out of memory for a bump allocator block!");
+		Block* block = new (memory) Block{};
+		block->next = nullptr;
+		block->size = size;
+
+		stats.capacity += size;
+		stats.blocks++;
+		return block;
+	}
+
+	void AtomicBumpAllocator::Resize(usize size) {
+		FreeBlocks();
+		stats.capacity = 0;
+		stats.blocks = 0;
+
+		first = NewBlock(size);
+		last = first;
+		current.store(first, std::memory_order_release);
+	}
+
+	void AtomicBumpAllocator::FreeBlocks() {
+		Block* block = first;
+		while (block) {
+			Block* next = block->next;
+			block->~Block();
+			std::free(block);
+			block = next;
+		}
+
+		first = nullptr;
+		last = nullptr;
+		current.store(nullptr, std::memory_order_relaxed);
+	}
+
+	ThreadAllocators::ThreadAllocators(u32 numThreads, usize size) : shared(size) {
+		threads.reserve(numThreads);
+		for (u32 i = 0; i < numThreads; i++) {
+			threads.push_back(std::make_unique<PerThread>(size));
+		}
+	}
+
+	ThreadAllocators::PerThread& ThreadAllocators::Current() {
+		const u32 index = JobSystem::WorkerIndex();
+		ASSERT(index < threads.size(), "Thread allocators are only for job system workers!");
+		return *threads[index];
+	}
+
+	void ThreadAllocators::ClearFrame() {
+		for (auto& thread : threads) {
+			thread->frame.Clear();
+		}
+		shared.Clear();
+	}
+
+	void ThreadAllocators::ClearTick() {
+		for (auto& thread : threads) {
+			thread->tick.Clear();
+		}
+	}
+
+	void ThreadAllocators::LogStats() const {
+		for (u32 i = 0; i < threads.size(); i++) {
+			threads[i]->frame.LogStats("Thread " + std::to_string(i) + " frame");
+			threads[i]->tick.LogStats("Thread " + std::to_string(i) + " tick");
+		}
+		shared.LogStats("Shared frame");
 	}
 }
\ No newline at end of file
@@ -5,9 +5,26 @@
 
 namespace util {
 
+	//Hands out memory by bumping a pointer and frees everything at once on Clear(). When a block fills up
+	//another one is chained on, then the next Clear() replaces the chain with one block sized from the
+	//most used between two Clear()s over the last USAGE_HISTORY of them, so a spike doesn't stick around
 	class BumpAllocator {
 	public:
-		BumpAllocator(usize size = 65536);
+		static constexpr usize DEFAULT_SIZE = 65536;
+		static constexpr u32 USAGE_HISTORY = 120;
+
+		struct Stats {
+			usize used = 0; //Between the last two Clear()s
+			usize peak = 0; //Over the whole run
+			usize highWater = 0; //Over the history
+			f64 average = 0.0; //Over the history
+			usize capacity = 0;
+			u32 blocks = 0;
+			u64 grows = 0; //Blocks chained on because one was full
+			u64 resizes = 0; //Times the chain was replaced on Clear()
+		};
+
+		BumpAllocator(usize size = DEFAULT_SIZE);
 		~BumpAllocator();
 
 		BumpAllocator(const BumpAllocator& other) = delete;
@@ -19,8 +36,12 @@ namespace util {
 
 		BumpAllocator& operator=(BumpAllocator&& other) noexcept;
 
+		//align has to be a power of two, 0 and 1 both mean none
 		void* Alloc(usize size, usize align = 0);
 
+		//Grows the allocation in place when it's the last one made and still fits in its block
+		b8 Extend(void* ptr, usize size, usize newSize);
+
 		template<typename T>
 		T* AllocArray(u32 count) {
 			void* ptr = Alloc(sizeof(T) * count, alignof(T));
@@ -39,12 +60,122 @@ namespace util {
 			return new (AllocArray<T>(1)) T(std::forward<Args>(args)...);
 		}
 
-		void Clear(); //TODO: dynamically resize based on previous frame's usage
+		void Clear();
+
+		inline const Stats& GetStats() const { return stats; }
+		void LogStats(const std::string& name) const;
+
+	private:
+		//Sits in front of the memory of every block
+		struct Block {
+			Block* next;
+			usize size;
+		};
+
+		void Grow(usize size);
+		void Resize(usize size);
+		void FreeBlocks();
+
+		Block* first = nullptr;
+		Block* last = nullptr;
+		u8* mem = nullptr;
+		u8* current = nullptr;
+		u8* max = nullptr;
+		usize minSize = 0;
+		usize usedBefore = 0; //In the blocks before last
+		usize history[USAGE_HISTORY]{};
+		u64 clears = 0;
+		Stats stats;
+	};
+
+	//Bump allocator any number of threads can use at once. Allocating is a compare and swap on the offset
+	//into the current block, a thread only takes the lock to chain on the next block when it's full. It
+	//sizes itself like BumpAllocator and Clear() must not overlap with any Alloc()
+	class AtomicBumpAllocator {
+	public:
+		AtomicBumpAllocator(usize size = BumpAllocator::DEFAULT_SIZE);
+		~AtomicBumpAllocator();
+
+		AtomicBumpAllocator(const AtomicBumpAllocator& other) = delete;
+		AtomicBumpAllocator& operator=(const AtomicBumpAllocator& other) = delete;
+
+		//align has to be a power of two, 0 and 1 both mean none
+		void* Alloc(usize size, usize align = 0);
+
+		template<typename T>
+		T* AllocArray(u32 count) {
+			void* ptr = Alloc(sizeof(T) * count, alignof(T));
+			return reinterpret_cast<T*>(ptr);
+		}
+
+		template<typename T, typename... Args>
+		T* Alloc(Args&&... args) {
+			return new (AllocArray<T>(1)) T(std::forward<Args>(args)...);
+		}
+
+		void Clear();
+
+		inline const BumpAllocator::Stats& GetStats() const { return stats; }
+		void LogStats(const std::string& name) const;
+
+	private:
+		struct alignas(16) Block {
+			Block* next;
+			usize size;
+			std::atomic<usize> offset{ 0 };
+
+			inline u8* Memory() { return reinterpret_cast<u8*>(this + 1); }
+		};
+
+		Block* NewBlock(usize size);
+		void Resize(usize size);
+		void FreeBlocks();
+
+		std::atomic<Block*> current{ nullptr };
+		std::mutex mutex; //Held to chain on a block
+		Block* first = nullptr;
+		Block* last = nullptr;
+		usize minSize = 0;
+		usize history[BumpAllocator::USAGE_HISTORY]{};
+		u64 clears = 0;
+		BumpAllocator::Stats stats;
+	};
+
+	//A frame and a tick bump allocator for every job system worker, so jobs get scratch memory without
+	//locking or sharing one, plus an AtomicBumpAllocator for memory handed between threads in a frame.
+	//Frame() and Tick() pick the calling worker's, their stats are what each thread used per frame or tick
+	class ThreadAllocators {
+	public:
+		ThreadAllocators(u32 numThreads, usize size = BumpAllocator::DEFAULT_SIZE);
+
+		ThreadAllocators(const ThreadAllocators& other) = delete;
+		ThreadAllocators& operator=(const ThreadAllocators& other) = delete;
+
+		inline BumpAllocator& Frame() { return Current().frame; }
+		inline BumpAllocator& Tick() { return Current().tick; }
+		inline AtomicBumpAllocator& Shared() { return shared; }
+
+		//Only between frames or ticks, when no jobs are running
+		void ClearFrame();
+		void ClearTick();
+
+		inline u32 NumThreads() const { return static_cast<u32>(threads.size()); }
+		inline const BumpAllocator::Stats& FrameStats(u32 thread) const { return threads[thread]->frame.GetStats(); }
+		inline const BumpAllocator::Stats& TickStats(u32 thread) const { return threads[thread]->tick.GetStats(); }
+		void LogStats() const;
 
 	private:
-		u8* mem;
-		u8* current;
-		u8* max;
+		struct alignas(64) PerThread {
+			PerThread(usize size) : frame(size), tick(size) { }
+
+			BumpAllocator frame;
+			BumpAllocator tick;
+		};
+
+		PerThread& Current();
+
+		std::vector<std::unique_ptr<PerThread>> threads;
+		AtomicBumpAllocator shared;
 	};
 
 	template<usize L>
@@ -75,6 +206,10 @@ namespace util {
 			return allocators[current]->Alloc(size, align);
 		}
 
+		b8 Extend(void* ptr, usize size, usize newSize) {
+			return allocators[current]->Extend(ptr, size, newSize);
+		}
+
 		template<typename T>
 		T* AllocArray(u32 count) {
 			return allocators[current]->AllocArray<T>(count);
@@ -94,6 +229,29 @@ namespace util {
 			current = (current + 1) % L;
 			allocators[current]->Clear();
 		}
+
+		//Summed over all L allocators, except peak and highWater which are the largest of them
+		BumpAllocator::Stats GetStats() const {
+			BumpAllocator::Stats total;
+			for (u32 i = 0; i < L; i++) {
+				const BumpAllocator::Stats& stats = allocators[i]->GetStats();
+				total.used += stats.used;
+				total.peak = std::max(total.peak, stats.peak);
+				total.highWater = std::max(total.highWater, stats.highWater);
+				total.average += stats.average;
+				total.capacity += stats.capacity;
+				total.blocks += stats.blocks;
+				total.grows += stats.grows;
+				total.resizes += stats.resizes;
+			}
+			return total;
+		}
+
+		void LogStats(const std::string& name) const {
+			for (u32 i = 0; i < L; i++) {
+				allocators[i]->LogStats(name + "[" + std::to_string(i) + "]");
+			}
+		}
 		
 	private:
 		std::unique_ptr<BumpAllocator> allocators[L];
@@ -0,0 +1,102 @@
+#include "ArenaBenchmark.h"
+#include "ArenaContainers.h"
+#include "Util\Math.h"
+#include "Util\Time.h"
+#include "Util\Log.h"
+#include "State.h"
+
+namespace util {
+
+	struct BenchmarkDraw {
+		u32 sprite;
+		vec2 position;
+		f32 depth;
+	};
+
+	//Runs f once per frame, returns ns per element
+	template<typename Fn>
+	static f64 MeasureFrames(u32 count, Fn&& f) {
+		const f64 start = global.time->CurrentTime();
+		for (u32 frame = 0; frame < ARENA_BENCHMARK_FRAMES; frame++) {
+			f(frame);
+		}
+		return (global.time->CurrentTime() - start) * 1000000.0 / (static_cast<f64>(count) * ARENA_BENCHMARK_FRAMES);
+	}
+
+	void RunArenaBenchmark(u32 count) {
+		//Its own allocator, so the frame allocators' stats aren't thrown off
+		BumpAllocator allocator;
+		u64 checksum = 0;
+
+		//Draw lists grow as sprites are found, nothing is reserved on either side. The arena containers
+		//are scoped so they're gone before the Clear()
+		const f64 arenaDraws = MeasureFrames(count, [&](u32 frame) {
+			{
+				arena::Vector<BenchmarkDraw> draws{ allocator };
+				for (u32 i = 0; i < count; i++) {
+					draws.PushBack(BenchmarkDraw{ i ^ frame, vec2{ static_cast<f32>(i), 1.f }, static_cast<f32>(i & 15) });
+				}
+				checksum += draws.Size() + draws.Back().sprite;
+			}
+			allocator.Clear();
+		});
+		const f64 stdDraws = MeasureFrames(count, [&](u32 frame) {
+			std::vector<BenchmarkDraw> draws;
+			for (u32 i = 0; i < count; i++) {
+				draws.push_back(BenchmarkDraw{ i ^ frame, vec2{ static_cast<f32>(i), 1.f }, static_cast<f32>(i & 15) });
+			}
+			checksum += draws.size() + draws.back().sprite;
+		});
+
+		//Entity to visible index, then a lookup for every other entity
+		const f64 arenaMap = MeasureFrames(count, [&](u32 frame) {
+			{
+				arena::HashMap<u32, u32> visible{ allocator };
+				for (u32 i = 0; i < count; i++) {
+					visible[i * 7 + frame] = i;
+				}
+				for (u32 i = 0; i < count; i++) {
+					if (const u32* index = visible.Find(i * 14 + frame)) {
+						checksum += *index;
+					}
+				}
+			}
+			allocator.Clear();
+		});
+		const f64 stdMap = MeasureFrames(count, [&](u32 frame) {
+			std::unordered_map<u32, u32> visible;
+			for (u32 i = 0; i < count; i++) {
+				visible[i * 7 + frame] = i;
+			}
+			for (u32 i = 0; i < count; i++) {
+				if (auto it = visible.find(i * 14 + frame); it != visible.end()) {
+					checksum += it->second;
+				}
+			}
+		});
+
+		const f64 arenaText = MeasureFrames(count, [&](u32 frame) {
+			{
+				arena::StringBuilder text{ allocator };
+				for (u32 i = 0; i < count; i++) {
+					text << "sprite " << i << " at " << frame << ", " << (i & 15) << '\n';
+				}
+				checksum += text.Size();
+			}
+			allocator.Clear();
+		});
+		const f64 stdText = MeasureFrames(count, [&](u32 frame) {
+			std::string text;
+			for (u32 i = 0; i < count; i++) {
+				text += "sprite " + std::to_string(i) + " at " + std::to_string(frame) + ", " + std::to_string(i & 15) + '\n';
+			}
+			checksum += text.size();
+		});
+
+		LOGNG(util::Logger::General, "Arena benchmark ($ elements, $ frames, checksum $, ns per element arena/std):",
+			count, ARENA_BENCHMARK_FRAMES, checksum);
+		LOGNG(util::Logger::General, "    Vector: $ / $, HashMap: $ / $, StringBuilder: $ / $",
+			arenaDraws, stdDraws, arenaMap, stdMap, arenaText, stdText);
+		allocator.LogStats("Arena benchmark allocator");
+	}
+}
\ No newline at end of file
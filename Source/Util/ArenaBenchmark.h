@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Util\Types.h"
+
+namespace util {
+
+	constexpr u32 ARENA_BENCHMARK_FRAMES = 64;
+
+	//Runs once on startup when arenaBenchmark under [Debug] in the config is set (elements per frame).
+	//Each frame builds a draw list, fills and looks up a culling map and formats a line per element,
+	//once with arena containers on a bump allocator that's cleared after the frame and once with
+	//std::vector, std::unordered_map and std::string, then logs ns per element for each
+	void RunArenaBenchmark(u32 count);
+}
\ No newline at end of file
@@ -0,0 +1,417 @@
+#pragma once
+
+#include "Util\Types.h"
+#include "Util\Std.h"
+#include "Util\Arena.h"
+
+#include <charconv>
+
+//Containers whose memory comes from a bump allocator, for scratch data that lives until the allocator's
+//next Clear() and never touches the heap. Nothing is given back when they grow or go away, so Reserve()
+//up front when the size is known. They must not outlive the Clear() of the allocator they were made with
+namespace util::arena {
+
+	//Either kind of bump allocator, so it isn't part of the container types
+	class ArenaRef {
+	public:
+		ArenaRef(BumpAllocator& allocator)
+			: allocator(&allocator),
+			alloc([](void* a, usize size, usize align) { return static_cast<BumpAllocator*>(a)->Alloc(size, align); }),
+			extend([](void* a, void* ptr, usize size, usize newSize) { return static_cast<BumpAllocator*>(a)->Extend(ptr, size, newSize); }) { }
+
+		template<usize L>
+		ArenaRef(LongAllocator<L>& allocator)
+			: allocator(&allocator),
+			alloc([](void* a, usize size, usize align) { return static_cast<LongAllocator<L>*>(a)->Alloc(size, align); }),
+			extend([](void* a, void* ptr, usize size, usize newSize) { return static_cast<LongAllocator<L>*>(a)->Extend(ptr, size, newSize); }) { }
+
+		inline void* Alloc(usize size, usize align) const { return alloc(allocator, size, align); }
+		inline b8 Extend(void* ptr, usize size, usize newSize) const { return extend(allocator, ptr, size, newSize); }
+
+	private:
+		void* allocator;
+		void* (*alloc)(void* allocator, usize size, usize align);
+		b8(*extend)(void* allocator, void* ptr, usize size, usize newSize);
+	};
+
+	template<typename T>
+	class Vector {
+	public:
+		Vector(ArenaRef arena, usize capacity = 0) : arena(arena) {
+			Reserve(capacity);
+		}
+
+		~Vector() {
+			Clear();
+		}
+
+		Vector(const Vector& other) = delete;
+		Vector& operator=(const Vector& other) = delete;
+
+		Vector(Vector&& other) noexcept
+			: arena(other.arena), data(other.data), size(other.size), capacity(other.capacity) {
+			other.data = nullptr;
+			other.size = 0;
+			other.capacity = 0;
+		}
+
+		void Reserve(usize newCapacity) {
+			if (newCapacity <= capacity) {
+				return;
+			}
+
+			//The last thing allocated can usually just take the space after it
+			if (data && arena.Extend(data, capacity * sizeof(T), newCapacity * sizeof(T))) {
+				capacity = newCapacity;
+				return;
+			}
+
+			T* newData = reinterpret_cast<T*>(arena.Alloc(newCapacity * sizeof(T), alignof(T)));
+			if constexpr (std::is_trivially_copyable_v<T>) {
+				if (size > 0) {
+					std::memcpy(newData, data, size * sizeof(T));
+				}
+			}
+			else {
+				for (usize i = 0; i < size; i++) {
+					new (newData + i) T(std::move(data[i]));
+					data[i].~T();
+				}
+			}
+
+			data = newData;
+			capacity = newCapacity;
+		}
+
+		void Resize(usize newSize) {
+			Reserve(newSize);
+			for (usize i = size; i < newSize; i++) {
+				new (data + i) T();
+			}
+			for (usize i = newSize; i < size; i++) {
+				data[i].~T();
+			}
+			size = newSize;
+		}
+
+		template<typename... Args>
+		T& EmplaceBack(Args&&... args) {
+			if (size == capacity) {
+				Reserve(capacity < 8 ? 8 : capacity * 2);
+			}
+			return *new (data + size++) T(std::forward<Args>(args)...);
+		}
+
+		//Adds count elements left uninitialized and returns the first, for trivial types that get written right away
+		T* Grow(usize count) {
+			static_assert(std::is_trivial_v<T>, "Grow leaves elements uninitialized!");
+			if (size + count > capacity) {
+				Reserve(std::max(size + count, capacity * 2));
+			}
+			T* first = data + size;
+			size += count;
+			return first;
+		}
+
+		inline T& PushBack(const T& t) { return EmplaceBack(t); }
+		inline T& PushBack(T&& t) { return EmplaceBack(std::move(t)); }
+
+		void PopBack() {
+			ASSERT(size > 0, "PopBack on an empty arena vector!");
+			data[--size].~T();
+		}
+
+		//Keeps the memory for reuse
+		void Clear() {
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (usize i = 0; i < size; i++) {
+					data[i].~T();
+				}
+			}
+			size = 0;
+		}
+
+		inline T& operator[](usize i) {
+			ASSERT(i < size, "Arena vector subscript out of range!");
+			return data[i];
+		}
+
+		inline const T& operator[](usize i) const {
+			ASSERT(i < size, "Arena vector subscript out of range!");
+			return data[i];
+		}
+
+		inline T& Back() { return (*this)[size - 1]; }
+		inline const T& Back() const { return (*this)[size - 1]; }
+
+		inline T* Data() { return data; }
+		inline const T* Data() const { return data; }
+		inline usize Size() const { return size; }
+		inline usize Capacity() const { return capacity; }
+		inline b8 Empty() const { return size == 0; }
+
+		inline T* begin() { return data; }
+		inline T* end() { return data + size; }
+		inline const T* begin() const { return data; }
+		inline const T* end() const { return data + size; }
+
+		inline operator std::span<T>() { return { data, size }; }
+		inline operator std::span<const T>() const { return { data, size }; }
+
+	private:
+		ArenaRef arena;
+		T* data = nullptr;
+		usize size = 0;
+		usize capacity = 0;
+	};
+
+	//Open addressing with linear probing, a power of two slots and at most 3/4 of them full. Erase() shifts
+	//the entries after it back, so there are no tombstones to slow lookups down
+	template<typename K, typename V, typename Hash = std::hash<K>>
+	class HashMap {
+	public:
+		HashMap(ArenaRef arena, usize capacity = 0) : arena(arena) {
+			Reserve(capacity);
+		}
+
+		~HashMap() {
+			if constexpr (!std::is_trivially_destructible_v<Slot>) {
+				Clear();
+			}
+		}
+
+		HashMap(const HashMap& other) = delete;
+		HashMap& operator=(const HashMap& other) = delete;
+
+		HashMap(HashMap&& other) noexcept
+			: arena(other.arena), hashes(other.hashes), slots(other.slots), size(other.size), mask(other.mask) {
+			other.hashes = nullptr;
+			other.slots = nullptr;
+			other.size = 0;
+			other.mask = 0;
+		}
+
+		//Makes room for count entries without growing
+		void Reserve(usize count) {
+			usize slotCount = 16;
+			while (slotCount * 3 / 4 < count) {
+				slotCount *= 2;
+			}
+			if (hashes && slotCount <= mask + 1) {
+				return;
+			}
+			Rehash(slotCount);
+		}
+
+		template<typename... Args>
+		V& Emplace(const K& key, Args&&... args) {
+			const u32 hash = HashOf(key);
+			usize i = hash & mask;
+			while (hashes[i] != 0) {
+				if (hashes[i] == hash && slots[i].key == key) {
+					return slots[i].value;
+				}
+				i = (i + 1) & mask;
+			}
+
+			if ((size + 1) * 4 > (mask + 1) * 3) {
+				Rehash((mask + 1) * 2);
+				return Emplace(key, std::forward<Args>(args)...);
+			}
+
+			hashes[i] = hash;
+			new (&slots[i]) Slot{ key, V(std::forward<Args>(args)...) };
+			size++;
+			return slots[i].value;
+		}
+
+		//Overwrites the value when the key is already there
+		V& Insert(const K& key, const V& value) {
+			V& v = Emplace(key);
+			v = value;
+			return v;
+		}
+
+		inline V& operator[](const K& key) { return Emplace(key); }
+
+		V* Find(const K& key) {
+			const usize i = IndexOf(key);
+			return i == NOT_FOUND ? nullptr : &slots[i].value;
+		}
+
+		const V* Find(const K& key) const {
+			const usize i = IndexOf(key);
+			return i == NOT_FOUND ? nullptr : &slots[i].value;
+		}
+
+		inline b8 Contains(const K& key) const { return IndexOf(key) != NOT_FOUND; }
+
+		b8 Erase(const K& key) {
+			usize i = IndexOf(key);
+			if (i == NOT_FOUND) {
+				return false;
+			}
+
+			slots[i].~Slot();
+			hashes[i] = 0;
+			size--;
+
+			//Pulls back every entry after the hole that would otherwise not be found past it
+			usize j = i;
+			while (true) {
+				j = (j + 1) & mask;
+				if (hashes[j] == 0) {
+					break;
+				}
+
+				const usize home = hashes[j] & mask;
+				const b8 movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+				if (movable) {
+					new (&slots[i]) Slot(std::move(slots[j]));
+					slots[j].~Slot();
+					hashes[i] = hashes[j];
+					hashes[j] = 0;
+					i = j;
+				}
+			}
+			return true;
+		}
+
+		void Clear() {
+			if (!hashes) {
+				return;
+			}
+			for (usize i = 0; i <= mask; i++) {
+				if (hashes[i] != 0) {
+					if constexpr (!std::is_trivially_destructible_v<Slot>) {
+						slots[i].~Slot();
+					}
+					hashes[i] = 0;
+				}
+			}
+			size = 0;
+		}
+
+		//f(const K&, V&) for every entry, in no particular order
+		template<typename Fn>
+		void ForEach(Fn&& f) {
+			for (usize i = 0; hashes && i <= mask; i++) {
+				if (hashes[i] != 0) {
+					f(static_cast<const K&>(slots[i].key), slots[i].value);
+				}
+			}
+		}
+
+		inline usize Size() const { return size; }
+		inline b8 Empty() const { return size == 0; }
+
+	private:
+		struct Slot {
+			K key;
+			V value;
+		};
+
+		static constexpr usize NOT_FOUND = ~static_cast<usize>(0);
+
+		//0 marks an empty slot, so the top bit is always set on a stored hash
+		inline u32 HashOf(const K& key) const {
+			return static_cast<u32>(Hash{}(key)) | 0x80000000u;
+		}
+
+		usize IndexOf(const K& key) const {
+			if (!hashes) {
+				return NOT_FOUND;
+			}
+
+			const u32 hash = HashOf(key);
+			usize i = hash & mask;
+			while (hashes[i] != 0) {
+				if (hashes[i] == hash && slots[i].key == key) {
+					return i;
+				}
+				i = (i + 1) & mask;
+			}
+			return NOT_FOUND;
+		}
+
+		void Rehash(usize slotCount) {
+			u32* oldHashes = hashes;
+			Slot* oldSlots = slots;
+			const usize oldCount = hashes ? mask + 1 : 0;
+
+			hashes = reinterpret_cast<u32*>(arena.Alloc(slotCount * sizeof(u32), alignof(u32)));
+			slots = reinterpret_cast<Slot*>(arena.Alloc(slotCount * sizeof(Slot), alignof(Slot)));
+			std::memset(hashes, 0, slotCount * sizeof(u32));
+			mask = slotCount - 1;
+
+			for (usize i = 0; i < oldCount; i++) {
+				if (oldHashes[i] == 0) {
+					continue;
+				}
+
+				usize j = oldHashes[i] & mask;
+				while (hashes[j] != 0) {
+					j = (j + 1) & mask;
+				}
+				hashes[j] = oldHashes[i];
+				new (&slots[j]) Slot(std::move(oldSlots[i]));
+				oldSlots[i].~Slot();
+			}
+		}
+
+		ArenaRef arena;
+		u32* hashes = nullptr;
+		Slot* slots = nullptr;
+		usize size = 0;
+		usize mask = 0;
+	};
+
+	//Appends text and numbers into arena memory, View() and CStr() stay valid until the next append
+	class StringBuilder {
+	public:
+		StringBuilder(ArenaRef arena, usize capacity = 64) : chars(arena, capacity + 1) {
+			chars.PushBack('\0');
+		}
+
+		StringBuilder& Append(std::string_view s) {
+			//Starts on the old terminator
+			char* out = chars.Grow(s.size()) - 1;
+			std::memcpy(out, s.data(), s.size());
+			out[s.size()] = '\0';
+			return *this;
+		}
+
+		inline StringBuilder& Append(const char* s) { return Append(std::string_view(s)); }
+		inline StringBuilder& Append(const std::string& s) { return Append(std::string_view(s)); }
+
+		StringBuilder& Append(char c) {
+			chars.Back() = c;
+			chars.PushBack('\0');
+			return *this;
+		}
+
+		//Integers and floats through std::to_chars, so no locale and no allocation
+		template<typename T>
+			requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+		StringBuilder& Append(T t) {
+			char buffer[64];
+			const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), t);
+			return Append(std::string_view(buffer, result.ptr - buffer));
+		}
+
+		template<typename T>
+		inline StringBuilder& operator<<(const T& t) { return Append(t); }
+
+		void Clear() {
+			chars.Clear();
+			chars.PushBack('\0');
+		}
+
+		inline std::string_view View() const { return { chars.Data(), chars.Size() - 1 }; }
+		inline const char* CStr() const { return chars.Data(); }
+		inline usize Size() const { return chars.Size() - 1; }
+
+	private:
+		Vector<char> chars;
+	};
+}
\ No newline at end of file
@@ -60,6 +60,38 @@ namespace util {
 		bool fullscreen = config["GFX"]["fullscreen"].value_or(false);
 		std::string pipelineCache = config["GFX"]["cacheFile"].value_or("pipeline.cache");
 
-		return Configuration{ exitButton, upButton, downButton, rightButton, leftButton, jumpButton, size, monitor, vsync, fullscreen, pipelineCache };
+		u32 spriteBenchmark = config["Debug"]["spriteBenchmark"].value_or(0u);
+		u32 tilemapBenchmark = config["Debug"]["tilemapBenchmark"].value_or(0u);
+
+		uvec2 virtualSize{
+			config["GFX"]["virtualWidth"].value_or(320u),
+			config["GFX"]["virtualHeight"].value_or(180u)
+		};
+		if (virtualSize.x == 0 || virtualSize.y == 0) {
+			return Err("Virtual resolution can't be zero!");
+		}
+
+		Upscale upscale;
+		std::string_view upscaleName = config["GFX"]["upscale"].value_or("integer"sv);
+		if (upscaleName == "integer"sv) {
+			upscale = Upscale::Integer;
+		}
+		else if (upscaleName == "sharp"sv) {
+			upscale = Upscale::SharpBilinear;
+		}
+		else {
+			return Err("Unknown upscale mode, expected \"integer\" or \"sharp\"!");
+		}
+
+		u32 recordBenchmark = config["Debug"]["recordBenchmark"].value_or(0u);
+		u32 ecsBenchmark = config["Debug"]["ecsBenchmark"].value_or(0u);
+		u32 physicsBenchmark = config["Debug"]["physicsBenchmark"].value_or(0u);
+		u32 mathBenchmark = config["Debug"]["mathBenchmark"].value_or(0u);
+		u32 arenaBenchmark = config["Debug"]["arenaBenchmark"].value_or(0u);
+
+		std::string_view profilerCapture = config["Debug"]["profilerCapture"].value_or("F9"sv);
+		int profilerCaptureButton = platform::Keyboard::ButtonCode(std::string(profilerCapture));
+
+		return Configuration{ exitButton, upButton, downButton, rightButton, leftButton, jumpButton, size, monitor, vsync, fullscreen, pipelineCache, spriteBenchmark, tilemapBenchmark, virtualSize, upscale, recordBenchmark, ecsBenchmark, physicsBenchmark, mathBenchmark, arenaBenchmark, profilerCaptureButton };
 	}
 }
\ No newline at end of file
@@ -7,6 +7,12 @@
 
 namespace util {
 	struct Configuration {
+		//How the virtual resolution is scaled up to the window
+		enum class Upscale : u32 {
+			Integer, //Largest whole multiple that fits, the rest is letterboxed
+			SharpBilinear //Fills the window keeping the aspect, only texel edges are blended
+		};
+
 		static Result<Configuration, std::string> FromFile(const std::string& filename);
 
 		int exit;
@@ -21,5 +27,18 @@ namespace util {
 		bool vsync, fullscreen;
 
 		std::string pipelineCache;
+
+		u32 spriteBenchmark; //Number of sprites in the benchmark scene, 0 disables it
+		u32 tilemapBenchmark; //Width and height in tiles of the benchmark map, 0 disables it
+
+		uvec2 virtualSize; //Resolution the scene is rendered at before upscaling
+		Upscale upscale;
+
+		u32 recordBenchmark; //Number of draws recorded in parallel each frame, 0 disables it
+		u32 ecsBenchmark; //Number of entities in the ECS benchmark, 0 disables it
+		u32 physicsBenchmark; //Number of bodies in the physics benchmark, 0 disables it
+		u32 mathBenchmark; //Number of matrices in the math benchmark run on startup, 0 disables it
+		u32 arenaBenchmark; //Elements per frame in the arena container benchmark run on startup, 0 disables it
+		int profilerCapture; //Key that writes the recorded profiler zones to a Chrome trace file
 	};
 }
\ No newline at end of file
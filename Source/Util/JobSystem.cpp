@@ -0,0 +1,249 @@
+#include "JobSystem.h"
+
+namespace util {
+
+	namespace {
+		thread_local u32 workerIndex = UINT32_MAX;
+		thread_local u32 jobDepth = 0; //Jobs run inside Wait are already counted by the outer job
+
+		inline u64 Now() {
+			return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+	}
+
+	JobSystem::JobSystem(u32 numWorkers) {
+		if (numWorkers == 0) {
+			numWorkers = std::thread::hardware_concurrency();
+		}
+
+		//Always at least one worker besides the main thread, so blocking on a future can't deadlock
+		numWorkers = numWorkers > 2 ? numWorkers : 2;
+
+		workers.reserve(numWorkers);
+		for (u32 i = 0; i < numWorkers; i++) {
+			auto& worker = workers.emplace_back(std::make_unique<Worker>());
+			for (u32 j = 0; j < MAX_JOBS; j++) {
+				worker->jobs[j].owner = i;
+				worker->jobs[j].next = j + 1 < MAX_JOBS ? &worker->jobs[j + 1] : nullptr;
+			}
+			worker->freeList = &worker->jobs[0];
+		}
+
+		//The thread creating the system takes part as worker 0
+		workerIndex = 0;
+		for (u32 i = 1; i < numWorkers; i++) {
+			workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+
+		for (auto& worker : workers) {
+			if (worker->thread.joinable()) {
+				worker->thread.join();
+			}
+		}
+
+		workerIndex = UINT32_MAX;
+	}
+
+	u32 JobSystem::WorkerIndex() {
+		return workerIndex;
+	}
+
+	void JobSystem::Run(std::function<void()> task, Counter* counter, const Counter* dependency) {
+		const u32 index = workerIndex;
+		ASSERT(index < workers.size(), "Jobs can only be added from worker threads!");
+
+		Job* job = Allocate(index);
+		job->task = std::move(task);
+		job->counter = counter;
+		job->dependency = dependency;
+
+		if (counter) {
+			counter->value.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (dependency && Park(job)) {
+			return;
+		}
+
+		Push(index, job);
+	}
+
+	void JobSystem::Wait(const Counter& counter) {
+		const u32 index = workerIndex;
+		ASSERT(index < workers.size(), "Only worker threads can wait on jobs!");
+
+		while (!counter.Done()) {
+			if (Job* job = FindJob(index)) {
+				Execute(index, job);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::TakeBusyTimes(std::vector<f64>& times) {
+		times.resize(workers.size());
+		for (u32 i = 0; i < workers.size(); i++) {
+			times[i] = static_cast<f64>(workers[i]->busyTime.exchange(0, std::memory_order_relaxed)) / 1'000'000.0;
+		}
+	}
+
+	void JobSystem::WorkerLoop(u32 index) {
+		workerIndex = index;
+
+		while (!stopping.load(std::memory_order_relaxed)) {
+			if (Job* job = FindJob(index)) {
+				Execute(index, job);
+				continue;
+			}
+
+			//Nothing to run or steal, sleep until a job is pushed
+			std::unique_lock lock(mutex);
+			sleeping.fetch_add(1);
+			wake.wait(lock, [this]() { return stopping.load() || queued.load() > 0; });
+			sleeping.fetch_sub(1);
+		}
+	}
+
+	JobSystem::Job* JobSystem::FindJob(u32 index) {
+		Job* job = workers[index]->deque.Pop();
+
+		//Steal starting after this worker so thieves spread over the victims
+		for (u32 i = 1; job == nullptr && i < workers.size(); i++) {
+			job = workers[(index + i) % workers.size()]->deque.Steal();
+		}
+
+		if (job) {
+			queued.fetch_sub(1);
+		}
+
+		return job;
+	}
+
+	void JobSystem::Execute(u32 index, Job* job) {
+		//Jobs are only queued once their dependency is done, unless its counter was reused since
+		if (job->dependency && Park(job)) {
+			return;
+		}
+
+		RunJob(index, job);
+	}
+
+	void JobSystem::RunJob(u32 index, Job* job) {
+		const u64 start = jobDepth == 0 ? Now() : 0;
+		jobDepth++;
+
+		job->task();
+
+		jobDepth--;
+		if (jobDepth == 0) {
+			workers[index]->busyTime.fetch_add(Now() - start, std::memory_order_relaxed);
+		}
+
+		//The counter can go away as soon as it reaches 0, so the slot is given back first
+		Counter* counter = job->counter;
+		Release(job);
+
+		if (counter && counter->value.fetch_sub(1, std::memory_order_seq_cst) == 1
+			&& numParked.load(std::memory_order_seq_cst) > 0) {
+			Unpark(index);
+		}
+	}
+
+	void JobSystem::Push(u32 index, Job* job) {
+		//Counted before it's visible, so a thief can't take it before the count goes up
+		queued.fetch_add(1);
+
+		//A full deque means the caller is far ahead of the workers, running it now keeps things moving.
+		//Only jobs whose dependency is done get here
+		if (!workers[index]->deque.Push(job)) {
+			queued.fetch_sub(1);
+			RunJob(index, job);
+			return;
+		}
+
+		if (sleeping.load() > 0) {
+			//Taking the lock orders this with a worker that's about to wait
+			{
+				std::lock_guard lock(mutex);
+			}
+			wake.notify_one();
+		}
+	}
+
+	JobSystem::Job* JobSystem::Allocate(u32 index) {
+		Worker& worker = *workers[index];
+		while (!worker.freeList) {
+			worker.freeList = worker.freed.exchange(nullptr, std::memory_order_acquire);
+			if (worker.freeList) {
+				break;
+			}
+
+			//Every slot is in flight, help with other jobs until one comes back
+			if (Job* other = FindJob(index)) {
+				Execute(index, other);
+			}
+			else {
+				std::this_thread::yield();
+			}
+		}
+
+		Job* job = worker.freeList;
+		worker.freeList = job->next;
+		return job;
+	}
+
+	void JobSystem::Release(Job* job) {
+		//Drops whatever the task captured now instead of when the slot is reused
+		job->task = nullptr;
+		job->counter = nullptr;
+		job->dependency = nullptr;
+
+		//Any thread can push, only the owner takes the whole list at once, so there's no ABA
+		Worker& owner = *workers[job->owner];
+		Job* head = owner.freed.load(std::memory_order_relaxed);
+		do {
+			job->next = head;
+		} while (!owner.freed.compare_exchange_weak(head, job, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	b8 JobSystem::Park(Job* job) {
+		std::lock_guard lock(parkMutex);
+
+		//Counted before the dependency is checked again, so a job that finishes it in between sees this one
+		numParked.fetch_add(1, std::memory_order_seq_cst);
+		if (job->dependency->value.load(std::memory_order_seq_cst) == 0) {
+			numParked.fetch_sub(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		parked.push_back(job);
+		return true;
+	}
+
+	void JobSystem::Unpark(u32 index) {
+		std::vector<Job*> ready;
+		{
+			std::lock_guard lock(parkMutex);
+			//Checks every dependency instead of the counter that just finished, its address may be reused already
+			auto it = std::partition(parked.begin(), parked.end(), [](Job* job) { return !job->dependency->Done(); });
+			ready.assign(it, parked.end());
+			parked.erase(it, parked.end());
+			numParked.fetch_sub(static_cast<u32>(ready.size()), std::memory_order_relaxed);
+		}
+
+		for (Job* job : ready) {
+			Push(index, job);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Types.h"
+#include "Std.h"
+
+namespace util {
+
+	//Lock free Chase-Lev deque. The owning thread pushes and pops at the bottom, any other
+	//thread can steal from the top. Holds at most N items, N has to be a power of two
+	template<typename T, usize N>
+	class WorkStealingDeque {
+	public:
+		static_assert((N & (N - 1)) == 0, "WorkStealingDeque size has to be a power of two!");
+
+		//Owner only, false if the deque is full
+		b8 Push(T item) {
+			const i64 b = bottom.load(std::memory_order_relaxed);
+			const i64 t = top.load(std::memory_order_acquire);
+			if (b - t >= static_cast<i64>(N)) {
+				return false;
+			}
+
+			items[b & (N - 1)].store(item, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		//Owner only, nullptr if empty
+		T Pop() {
+			const i64 b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			i64 t = top.load(std::memory_order_relaxed);
+
+			if (t > b) {
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T item = items[b & (N - 1)].load(std::memory_order_relaxed);
+			if (t == b) {
+				//Last item, race the thieves for it
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+					item = nullptr;
+				}
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			return item;
+		}
+
+		//Any thread, nullptr if empty or another thread got there first
+		T Steal() {
+			i64 t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const i64 b = bottom.load(std::memory_order_acquire);
+
+			if (t >= b) {
+				return nullptr;
+			}
+
+			T item = items[t & (N - 1)].load(std::memory_order_relaxed);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				return nullptr;
+			}
+
+			return item;
+		}
+
+	private:
+		alignas(64) std::atomic<i64> top{ 0 };
+		alignas(64) std::atomic<i64> bottom{ 0 };
+		std::array<std::atomic<T>, N> items;
+	};
+
+	//One worker per core (the main thread is worker 0) with its own work stealing deque.
+	//Jobs go to the deque of the thread that runs them and idle workers steal from the others.
+	//Waiting on a counter runs other jobs instead of blocking, so jobs can wait on jobs
+	class JobSystem {
+	public:
+		static constexpr u32 MAX_JOBS = 4096; //In flight per worker, Run() helps with other jobs when they're all taken
+
+		//Counts unfinished jobs, a job added with a counter decrements it when it's done
+		class Counter {
+		public:
+			inline b8 Done() const { return value.load(std::memory_order_acquire) == 0; }
+			inline u32 Value() const { return value.load(std::memory_order_relaxed); }
+
+		private:
+			std::atomic<u32> value{ 0 };
+
+			friend JobSystem;
+		};
+
+		//0 uses one worker per core
+		JobSystem(u32 numWorkers = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem& other) = delete;
+		JobSystem& operator=(const JobSystem& other) = delete;
+
+		//The job doesn't start before dependency is done, counter is incremented now and decremented when it finishes.
+		//Until then it's parked and the job that finishes the dependency queues it
+		void Run(std::function<void()> task, Counter* counter = nullptr, const Counter* dependency = nullptr);
+
+		//Runs other jobs on this thread until the counter reaches 0
+		void Wait(const Counter& counter);
+
+		//Calls f(begin, end) over [0, count) in batches of batchSize spread over the workers, returns when all are done
+		template<typename F>
+		void ParallelFor(u32 count, u32 batchSize, F&& f) {
+			batchSize = batchSize == 0 ? 1 : batchSize;
+			if (count <= batchSize) {
+				if (count > 0) {
+					f(0u, count);
+				}
+				return;
+			}
+
+			Counter counter;
+			for (u32 begin = batchSize; begin < count; begin += batchSize) {
+				const u32 end = begin + batchSize < count ? begin + batchSize : count;
+				Run([&f, begin, end]() { f(begin, end); }, &counter);
+			}
+
+			//This thread takes the first batch instead of just waiting
+			f(0u, batchSize);
+			Wait(counter);
+		}
+
+		//For work outside the frame (asset loading), don't block on the future from inside a job
+		template<typename F>
+		auto Submit(F&& f) -> std::future<std::invoke_result_t<F>> {
+			using R = std::invoke_result_t<F>;
+
+			//std::function needs to be copyable, packaged_task isn't
+			auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+			std::future<R> future = task->get_future();
+
+			Run([task]() { (*task)(); });
+
+			return future;
+		}
+
+		inline u32 NumWorkers() const { return static_cast<u32>(workers.size()); }
+
+		//Worker index of the calling thread, UINT32_MAX if it isn't one
+		static u32 WorkerIndex();
+
+		//Time each worker spent running jobs since the last call, in ms
+		void TakeBusyTimes(std::vector<f64>& times);
+
+	private:
+		struct Job {
+			std::function<void()> task;
+			Counter* counter = nullptr;
+			const Counter* dependency = nullptr;
+			Job* next = nullptr; //In a free list
+			u32 owner = 0; //Worker whose slots it's from
+		};
+
+		//Only the owner takes slots, any thread that finishes a job hands its slot back through freed
+		struct alignas(64) Worker {
+			WorkStealingDeque<Job*, MAX_JOBS> deque;
+			std::array<Job, MAX_JOBS> jobs;
+			Job* freeList = nullptr; //Owner only
+			std::atomic<Job*> freed{ nullptr };
+			std::atomic<u64> busyTime{ 0 }; //In ns
+			std::thread thread;
+		};
+
+		void WorkerLoop(u32 index);
+		Job* FindJob(u32 index);
+		void Execute(u32 index, Job* job);
+		void RunJob(u32 index, Job* job);
+		void Push(u32 index, Job* job);
+
+		Job* Allocate(u32 index);
+		void Release(Job* job);
+
+		//False if the dependency is already done and the job can be queued
+		b8 Park(Job* job);
+		void Unpark(u32 index);
+
+		std::vector<std::unique_ptr<Worker>> workers;
+
+		std::atomic<u32> queued{ 0 };
+		std::atomic<u32> sleeping{ 0 };
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::atomic<b8> stopping{ false };
+
+		std::vector<Job*> parked; //Waiting on their dependency
+		std::atomic<u32> numParked{ 0 };
+		std::mutex parkMutex;
+	};
+}
\ No newline at end of file
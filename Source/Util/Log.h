@@ -144,6 +144,7 @@ namespace util {
 
 		template<typename... Args>
 		void Log(const std::string& format, LogType type, Severity severity, const char* file, int line, const char* func, const Args&... args) {
+			std::lock_guard lock{ mutex };
 			std::ostream& stream = (type == Debug || type == Warn) ? general : error;
 
 			switch (severity)
@@ -214,6 +215,7 @@ namespace util {
 		}
 
 		void Log(const std::string& format, LogType type, Severity severity, const char* file, int line, const char* func) {
+			std::lock_guard lock{ mutex };
 			std::ostream& stream = (type == Debug || type == Warn) ? general : error;
 
 			switch (severity)
@@ -266,6 +268,7 @@ namespace util {
 
 		template<typename... Args>
 		void LogNoFile(const std::string& format, LogType type, Severity severity, const Args&... args) {
+			std::lock_guard lock{ mutex };
 			std::ostream& stream = (type == Debug || type == Warn) ? general : error;
 
 			switch (severity)
@@ -334,6 +337,7 @@ namespace util {
 		}
 
 		void LogNoFile(const std::string& format, LogType type, Severity severity) {
+			std::lock_guard lock{ mutex };
 			std::ostream& stream = (type == Debug || type == Warn) ? general : error;
 
 			switch (severity)
@@ -391,5 +395,6 @@ namespace util {
 
 		std::ostream& general;
 		std::ostream& error;
+		std::mutex mutex; //Jobs can log from any worker
 	};
 }
\ No newline at end of file
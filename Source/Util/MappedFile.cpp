@@ -0,0 +1,127 @@
+#include "MappedFile.h"
+
+#ifdef GAME_IS_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#undef CreateFile
+#undef CreateDirectory
+#undef ERROR
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace util {
+
+	MappedFile::~MappedFile() {
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		Close();
+
+		data = other.data;
+		size = other.size;
+		file = other.file;
+#ifdef GAME_IS_WINDOWS
+		mapping = other.mapping;
+		other.file = nullptr;
+		other.mapping = nullptr;
+#else
+		other.file = -1;
+#endif
+		other.data = nullptr;
+		other.size = 0;
+
+		return *this;
+	}
+
+	std::optional<std::string> MappedFile::Open(const std::string& path) {
+		Close();
+
+#ifdef GAME_IS_WINDOWS
+		HANDLE handle = CreateFileA(
+			path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			return "Failed to open file " + path;
+		}
+		file = handle;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+			Close();
+			return "Failed to get the size of file " + path;
+		}
+		size = static_cast<usize>(fileSize.QuadPart);
+
+		mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			Close();
+			return "Failed to map file " + path;
+		}
+
+		data = static_cast<const u8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (!data) {
+			Close();
+			return "Failed to map file " + path;
+		}
+#else
+		file = open(path.c_str(), O_RDONLY);
+		if (file < 0) {
+			return "Failed to open file " + path;
+		}
+
+		struct stat info;
+		if (fstat(file, &info) != 0 || info.st_size == 0) {
+			Close();
+			return "Failed to get the size of file " + path;
+		}
+		size = static_cast<usize>(info.st_size);
+
+		void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view == MAP_FAILED) {
+			Close();
+			return "Failed to map file " + path;
+		}
+		data = static_cast<const u8*>(view);
+
+		//Everything gets copied front to back into staging memory
+		madvise(view, size, MADV_SEQUENTIAL);
+#endif
+
+		return std::nullopt;
+	}
+
+	void MappedFile::Close() {
+#ifdef GAME_IS_WINDOWS
+		if (data) {
+			UnmapViewOfFile(data);
+		}
+		if (mapping) {
+			CloseHandle(mapping);
+		}
+		if (file) {
+			CloseHandle(file);
+		}
+		mapping = nullptr;
+		file = nullptr;
+#else
+		if (data) {
+			munmap(const_cast<u8*>(data), size);
+		}
+		if (file >= 0) {
+			close(file);
+		}
+		file = -1;
+#endif
+		data = nullptr;
+		size = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Types.h"
+#include "Std.h"
+
+namespace util {
+
+	//Read-only memory mapping of a whole file, pages are faulted in by the OS as they are touched
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		//Returns an error message if the file couldn't be opened or mapped
+		std::optional<std::string> Open(const std::string& file);
+		void Close();
+
+		inline const u8* Data() const { return data; }
+		inline usize Size() const { return size; }
+		inline b8 IsOpen() const { return data != nullptr; }
+
+		inline std::span<const u8> Bytes() const { return { data, size }; }
+
+	private:
+		const u8* data = nullptr;
+		usize size = 0;
+
+#ifdef GAME_IS_WINDOWS
+		void* file = nullptr;
+		void* mapping = nullptr;
+#else
+		int file = -1;
+#endif
+	};
+}
\ No newline at end of file
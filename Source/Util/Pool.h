@@ -0,0 +1,212 @@
+#pragma once
+
+#include "Types.h"
+#include "Std.h"
+
+namespace util {
+
+	//32 bit handle to an object in a Pool<T>, the low bits are the slot and the high bits its generation.
+	//The generation is bumped every time a slot is freed, so stale handles are caught until it wraps
+	template<typename T>
+	struct Handle {
+		static constexpr u32 INDEX_BITS = 20;
+		static constexpr u32 INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static constexpr u32 GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+		static constexpr u32 INVALID = ~0u;
+
+		u32 value = INVALID;
+
+		static constexpr inline Handle Make(u32 index, u32 generation) {
+			return Handle{ ((generation & GENERATION_MASK) << INDEX_BITS) | index };
+		}
+
+		inline u32 Index() const { return value & INDEX_MASK; }
+		inline u32 Generation() const { return value >> INDEX_BITS; }
+		inline b8 Valid() const { return value != INVALID; }
+
+		inline b8 operator==(const Handle& other) const = default;
+	};
+
+	//Objects of one type in pages of P slots that never move, so pointers stay valid as the pool grows.
+	//Free slots form an intrusive list through their own storage, so Create() and Destroy() are O(1) and
+	//only touch the heap when a new page is needed. The live slots are also kept in a dense array for Each()
+	template<typename T, u32 P = 256>
+	class Pool {
+	public:
+		static_assert((P & (P - 1)) == 0, "Pool page size has to be a power of two!");
+
+		//The all ones index is the invalid handle
+		static constexpr u32 MAX_SLOTS = Handle<T>::INDEX_MASK;
+
+		Pool(u32 capacity = 0) {
+			Reserve(capacity);
+		}
+
+		~Pool() {
+			Clear();
+		}
+
+		Pool(const Pool& other) = delete;
+		Pool& operator=(const Pool& other) = delete;
+
+		Pool(Pool&& other) noexcept
+			: pages(std::move(other.pages)), dense(std::move(other.dense)), freeHead(other.freeHead) {
+			other.freeHead = NONE;
+		}
+
+		Pool& operator=(Pool&& other) noexcept {
+			Clear();
+			pages = std::move(other.pages);
+			dense = std::move(other.dense);
+			freeHead = other.freeHead;
+			other.freeHead = NONE;
+			return *this;
+		}
+
+		//Adds pages until there are slots for count objects
+		void Reserve(u32 count) {
+			ASSERT(count <= MAX_SLOTS, "Pool capacity past what a handle can index!");
+			while (Capacity() < count) {
+				AddPage();
+			}
+		}
+
+		template<typename... Args>
+		Handle<T> Create(Args&&... args) {
+			if (freeHead == NONE) {
+				ASSERT(Capacity() + P <= MAX_SLOTS, "Pool is out of handles!");
+				AddPage();
+			}
+
+			const u32 index = freeHead;
+			Slot& slot = SlotAt(index);
+			std::memcpy(&freeHead, slot.storage, sizeof(u32));
+
+			new (slot.storage) T(std::forward<Args>(args)...);
+			slot.dense = static_cast<u32>(dense.size());
+			dense.push_back(index);
+
+			return Handle<T>::Make(index, slot.generation);
+		}
+
+		//Stale and invalid handles are ignored
+		void Destroy(Handle<T> handle) {
+			Slot* slot = Find(handle);
+			if (!slot) {
+				return;
+			}
+
+			slot->Get()->~T();
+			slot->generation = (slot->generation + 1) & Handle<T>::GENERATION_MASK;
+
+			//Swaps the last live slot into the gap so the dense array stays packed
+			const u32 last = dense.back();
+			dense[slot->dense] = last;
+			SlotAt(last).dense = slot->dense;
+			dense.pop_back();
+
+			slot->dense = NONE;
+			std::memcpy(slot->storage, &freeHead, sizeof(u32));
+			freeHead = handle.Index();
+		}
+
+		//Destroys every object, the pages are kept
+		void Clear() {
+			while (!dense.empty()) {
+				const u32 index = dense.back();
+				Destroy(Handle<T>::Make(index, SlotAt(index).generation));
+			}
+		}
+
+		//nullptr if the handle is stale or invalid
+		inline T* Get(Handle<T> handle) {
+			Slot* slot = Find(handle);
+			return slot ? slot->Get() : nullptr;
+		}
+
+		inline const T* Get(Handle<T> handle) const {
+			return const_cast<Pool*>(this)->Get(handle);
+		}
+
+		inline T& operator[](Handle<T> handle) {
+			T* t = Get(handle);
+			ASSERT(t, "Stale or invalid pool handle!");
+			return *t;
+		}
+
+		inline const T& operator[](Handle<T> handle) const {
+			const T* t = Get(handle);
+			ASSERT(t, "Stale or invalid pool handle!");
+			return *t;
+		}
+
+		inline b8 Alive(Handle<T> handle) const { return const_cast<Pool*>(this)->Find(handle) != nullptr; }
+
+		inline u32 Size() const { return static_cast<u32>(dense.size()); }
+		inline u32 Capacity() const { return static_cast<u32>(pages.size()) * P; }
+		inline b8 Empty() const { return dense.empty(); }
+
+		//f(T&) or f(Handle<T>, T&) for every live object, in no particular order. Don't create or destroy in f
+		template<typename F>
+		void Each(F&& f) {
+			for (const u32 index : dense) {
+				Slot& slot = SlotAt(index);
+				if constexpr (std::is_invocable_v<F&, Handle<T>, T&>) {
+					f(Handle<T>::Make(index, slot.generation), *slot.Get());
+				}
+				else {
+					f(*slot.Get());
+				}
+			}
+		}
+
+	private:
+		static constexpr u32 NONE = ~0u;
+
+		//A free slot keeps the index of the next free one in its storage
+		struct Slot {
+			alignas(T) u8 storage[sizeof(T) < sizeof(u32) ? sizeof(u32) : sizeof(T)];
+			u32 generation;
+			u32 dense; //Position in dense, NONE when free
+
+			inline T* Get() { return std::launder(reinterpret_cast<T*>(storage)); }
+		};
+
+		inline Slot& SlotAt(u32 index) {
+			return pages[index / P][index & (P - 1)];
+		}
+
+		Slot* Find(Handle<T> handle) {
+			const u32 index = handle.Index();
+			if (!handle.Valid() || index >= Capacity()) {
+				return nullptr;
+			}
+
+			Slot& slot = SlotAt(index);
+			return slot.dense != NONE && slot.generation == handle.Generation() ? &slot : nullptr;
+		}
+
+		//Threads the new slots onto the free list in order, so the first page fills front to back
+		void AddPage() {
+			const u32 first = Capacity();
+			auto& page = pages.emplace_back(std::make_unique<Slot[]>(P));
+			for (u32 i = P; i-- > 0;) {
+				page[i].generation = 0;
+				page[i].dense = NONE;
+				std::memcpy(page[i].storage, &freeHead, sizeof(u32));
+				freeHead = first + i;
+			}
+		}
+
+		std::vector<std::unique_ptr<Slot[]>> pages;
+		std::vector<u32> dense;
+		u32 freeHead = NONE;
+	};
+}
+
+template<typename T>
+struct std::hash<util::Handle<T>> {
+	usize operator()(const util::Handle<T>& handle) const {
+		return std::hash<u32>{}(handle.value);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "Profiler.h"
+#include "File.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include "State.h"
+
+namespace util {
+
+	thread_local Profiler::ThreadBuffer* Profiler::threadBuffer = nullptr;
+	thread_local const Profiler* Profiler::threadOwner = nullptr;
+
+	namespace {
+		//Chrome wants microseconds, the fraction keeps the nanoseconds
+		void AppendMicros(std::string& out, u64 ns) {
+			char digits[4] = { '.', '0', '0', '0' };
+			u64 fraction = ns % 1000;
+			for (i32 i = 3; i > 0; i--) {
+				digits[i] = static_cast<char>('0' + fraction % 10);
+				fraction /= 10;
+			}
+			out += std::to_string(ns / 1000);
+			out.append(digits, 4);
+		}
+
+		//Zone names come from code, so only quotes and backslashes can show up
+		void AppendEscaped(std::string& out, const char* s) {
+			for (; *s; s++) {
+				if (*s == '"' || *s == '\\') {
+					out += '\\';
+				}
+				out += *s;
+			}
+		}
+	}
+
+	Profiler::ThreadBuffer::ThreadBuffer(u32 id, std::string name)
+		: id(id), name(std::move(name)), events(std::make_unique<Event[]>(EVENTS_PER_THREAD)) {
+
+	}
+
+	Profiler::Profiler() : start(std::chrono::steady_clock::now()) {
+
+	}
+
+	Profiler::~Profiler() {
+		//Threads that outlive the profiler shouldn't write into its buffers
+		if (threadOwner == this) {
+			threadBuffer = nullptr;
+			threadOwner = nullptr;
+		}
+	}
+
+	u64 Profiler::Now() const {
+		return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	Profiler::ThreadBuffer& Profiler::CurrentBuffer() {
+		if (threadOwner != this) {
+			const u32 worker = JobSystem::WorkerIndex();
+			std::lock_guard lock(mutex);
+			const u32 id = static_cast<u32>(threads.size());
+			std::string name = worker == 0 ? "Main"
+				: worker != UINT32_MAX ? "Worker " + std::to_string(worker)
+				: "Thread " + std::to_string(id);
+
+			threads.push_back(std::make_unique<ThreadBuffer>(id, std::move(name)));
+			threadBuffer = threads.back().get();
+			threadOwner = this;
+		}
+
+		return *threadBuffer;
+	}
+
+	b8 Profiler::Begin(const char* name) {
+		Profiler* profiler = global.profiler;
+		if (!profiler || !profiler->Enabled()) {
+			return false;
+		}
+
+		ThreadBuffer& buffer = profiler->CurrentBuffer();
+		ASSERT(buffer.depth < MAX_DEPTH, "Profiler zones nested too deep!");
+		buffer.open[buffer.depth++] = { name, profiler->Now() };
+		return true;
+	}
+
+	void Profiler::End() {
+		Profiler* profiler = global.profiler;
+		ThreadBuffer* buffer = threadBuffer;
+		if (!profiler || !buffer || threadOwner != profiler) {
+			return;
+		}
+
+		ASSERT(buffer->depth > 0, "Profiler zone ended without one open!");
+		const auto& [name, begin] = buffer->open[--buffer->depth];
+
+		const u64 head = buffer->head.load(std::memory_order_relaxed);
+		buffer->events[head & (EVENTS_PER_THREAD - 1)] = Event{ name, begin, profiler->Now(), buffer->depth };
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+
+	u32 Profiler::AddTrack(const std::string& name) {
+		std::lock_guard lock(mutex);
+		const u32 id = static_cast<u32>(threads.size());
+		threads.push_back(std::make_unique<ThreadBuffer>(id, name));
+		return id;
+	}
+
+	void Profiler::Record(u32 track, const Event& event) {
+		//Tracks get a handful of events a frame, so they can take the lock threads avoid
+		std::lock_guard lock(mutex);
+		ASSERT(track < threads.size(), "No profiler track with that id!");
+		ThreadBuffer& buffer = *threads[track];
+
+		const u64 head = buffer.head.load(std::memory_order_relaxed);
+		buffer.events[head & (EVENTS_PER_THREAD - 1)] = event;
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	Result<void, std::string> Profiler::Export(const std::string& file) const {
+		std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+		usize count = 0;
+
+		std::lock_guard lock(mutex);
+		for (const auto& thread : threads) {
+			out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(thread->id)
+				+ ",\"args\":{\"name\":\"" + thread->name + "\"}}";
+
+			const u64 head = thread->head.load(std::memory_order_acquire);
+			const u64 first = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+
+			for (u64 i = first; i < head; i++) {
+				const Event event = thread->events[i & (EVENTS_PER_THREAD - 1)];
+
+				//The owner wrapped around onto this one while it was copied
+				const u64 now = thread->head.load(std::memory_order_acquire);
+				if (now > EVENTS_PER_THREAD && i < now - EVENTS_PER_THREAD) {
+					continue;
+				}
+
+				out += ",\n{\"name\":\"";
+				AppendEscaped(out, event.name);
+				out += "\",\"ph\":\"X\",\"pid\":0,\"tid\":" + std::to_string(thread->id) + ",\"ts\":";
+				AppendMicros(out, event.start);
+				out += ",\"dur\":";
+				AppendMicros(out, event.end - event.start);
+				out += ",\"args\":{\"depth\":" + std::to_string(event.depth) + "}}";
+				count++;
+			}
+			out += ",\n";
+		}
+
+		//Every thread entry ends with a comma, the process name closes the list
+		out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"GAME\"}}\n]}";
+
+		auto result = WriteFile(file, out);
+		if (result.IsOk()) {
+			LOGNG(util::Logger::General, "Wrote $ profiler zones from $ thread(s) to $.", count, threads.size(), file);
+		}
+		return result;
+	}
+}
\ No newline at end of file
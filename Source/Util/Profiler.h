@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Types.h"
+#include "Std.h"
+#include "Result.h"
+
+//Times the rest of the enclosing scope as a zone, name has to outlive the profiler (a string literal)
+#define PROFILE_ZONE(name) util::Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__){ name }
+#define PROFILE_FUNCTION() PROFILE_ZONE(__FUNCTION__)
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+namespace util {
+
+	//Records nested named zones with nanosecond timestamps. Every thread writes finished zones into its own
+	//ring buffer without locking, so only the last EVENTS_PER_THREAD zones of each thread are kept.
+	//Export() writes them as a Chrome trace_event file that chrome://tracing and Perfetto can open
+	class Profiler {
+	public:
+		static constexpr u32 EVENTS_PER_THREAD = 1 << 15;
+		static constexpr u32 MAX_DEPTH = 64;
+
+		struct Event {
+			const char* name;
+			u64 start, end; //In ns since the profiler was created
+			u32 depth;
+		};
+
+		//Scoped zone, see PROFILE_ZONE
+		class Zone {
+		public:
+			Zone(const char* name) : recorded(Begin(name)) { }
+
+			~Zone() {
+				if (recorded) {
+					End();
+				}
+			}
+
+			Zone(const Zone& other) = delete;
+			Zone& operator=(const Zone& other) = delete;
+
+		private:
+			b8 recorded;
+		};
+
+		Profiler();
+		~Profiler();
+
+		Profiler(const Profiler& other) = delete;
+		Profiler& operator=(const Profiler& other) = delete;
+
+		//Zones opened while disabled aren't recorded
+		inline void SetEnabled(b8 enable) { enabled.store(enable, std::memory_order_relaxed); }
+		inline b8 Enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+		//Writes every zone still in the ring buffers. Zones that end while this runs may be dropped,
+		//so call it between frames
+		Result<void, std::string> Export(const std::string& file) const;
+
+		//Nanoseconds since the profiler was created
+		u64 Now() const;
+
+		//For zones that don't fit a scope, every Begin() that returned true needs an End() on the same thread
+		static b8 Begin(const char* name);
+		static void End();
+
+		//A timeline that isn't a thread, like the GPU's. Events are written as they are, with times from Now()
+		u32 AddTrack(const std::string& name);
+		void Record(u32 track, const Event& event);
+
+	private:
+		struct ThreadBuffer {
+			ThreadBuffer(u32 id, std::string name);
+
+			u32 id;
+			std::string name;
+
+			//Zones that are still open, they're only written to the ring when they end
+			std::array<std::pair<const char*, u64>, MAX_DEPTH> open;
+			u32 depth = 0;
+
+			std::unique_ptr<Event[]> events;
+			std::atomic<u64> head{ 0 }; //Events written so far, only the owning thread writes
+		};
+
+		ThreadBuffer& CurrentBuffer();
+
+		static thread_local ThreadBuffer* threadBuffer;
+		static thread_local const Profiler* threadOwner; //The profiler threadBuffer belongs to
+
+		std::chrono::steady_clock::time_point start;
+		std::atomic<b8> enabled{ true };
+
+		mutable std::mutex mutex; //Only for adding threads
+		std::vector<std::unique_ptr<ThreadBuffer>> threads;
+	};
+}
\ No newline at end of file
@@ -43,6 +43,7 @@
 //Numbers
 #include <limits>
 #include <numeric>
+#include <bit>
 
 //Helper Stuff
 #include <chrono>
@@ -58,6 +59,9 @@
 //Threading
 #include <mutex>
 #include <thread>
+#include <condition_variable>
+#include <future>
+#include <atomic>
 
 //Memory
 #include <new>
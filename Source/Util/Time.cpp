@@ -1,28 +1,38 @@
 #include "Time.h"
 #include "Math.h"
+#include "Profiler.h"
 
 namespace util {
 
-	Time::Section::Section(Time* time, bool isTick)
-		: time(time), isTick(isTick) {
+	Time::Section::Section(Time* time, bool isTick, const char* name)
+		: time(time), isTick(isTick), name(name) {
 		memset(static_cast<void*>(times.data()), 0, times.size() * sizeof(f64));
 	}
 
 	void Time::Section::Begin() {
 		start = time->CurrentTime();
+		profiled = name && Profiler::Begin(name);
 	}
 
 	void Time::Section::End() {
-		f64 elapsedTime = time->CurrentTime() - start;
+		if (profiled) {
+			Profiler::End();
+		}
+
+		Add(time->CurrentTime() - start);
+
+		//Other tick sections (like ECS systems) can end on worker threads
+		if (this == &time->tick) {
+			time->lastTickTime = time->CurrentTime();
+		}
+	}
+
+	void Time::Section::Add(f64 elapsedTime) {
 		usize index = (isTick ? time->TickCount() : time->FrameCount()) % SECTION_LENGTH;
 		sectionTime -= times[index];
 		times[index] = elapsedTime;
 		sectionTime += elapsedTime;
 		count++;
-
-		if (isTick) {
-			time->lastTickTime = time->CurrentTime();
-		}
 	}
 
 	f64 Time::Section::Avg() const {
@@ -31,11 +41,12 @@ namespace util {
 
 	Time::Time(CurrentTimeFn timeFn)
 		: timeFn(timeFn),
-		frame(this),
-		tick(this, true),
-		update(this),
-		prepare(this),
-		render(this) {
+		frame(this, false, "Frame"),
+		tick(this, true, "Tick"),
+		update(this, false, "Update"),
+		prepare(this, false, "Prepare"),
+		render(this, false, "Render"),
+		gpu(this) {
 		lastSecond = CurrentTime();
 	}
 
@@ -58,4 +69,35 @@ namespace util {
 	f64 Time::AvgFPS() const {
 		return 1000.0 / frame.Avg();
 	}
+
+	void Time::AddWorkerTimes(std::span<const f64> busy) {
+		if (workerTimes.size() != busy.size()) {
+			workerTimes.assign(busy.size(), WorkerTimes{});
+		}
+
+		//Frame length between calls, so the busy time and the time it's compared to cover the same span
+		const f64 now = CurrentTime();
+		const f64 frameTime = workerFrameCount == 0 ? 0.0 : now - lastWorkerFrame;
+		lastWorkerFrame = now;
+
+		const usize index = workerFrameCount % SECTION_LENGTH;
+		workerFrameSum += frameTime - workerFrames[index];
+		workerFrames[index] = frameTime;
+
+		for (usize i = 0; i < busy.size(); i++) {
+			WorkerTimes& worker = workerTimes[i];
+			worker.sum += busy[i] - worker.times[index];
+			worker.times[index] = busy[i];
+		}
+
+		workerFrameCount++;
+	}
+
+	f64 Time::WorkerUtilization(u32 worker) const {
+		if (worker >= workerTimes.size() || workerFrameSum <= 0.0) {
+			return 0.0;
+		}
+
+		return math::Clamp(workerTimes[worker].sum / workerFrameSum, 0.0, 1.0);
+	}
 }
\ No newline at end of file
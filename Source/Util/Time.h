@@ -14,12 +14,16 @@ namespace util {
 
 		using CurrentTimeFn = std::function<f64(void)>; //In ms
 
+		//Also a profiler zone when it has a name, name has to outlive the section
 		struct Section {
-			Section(Time* time, bool isTick = false);
+			Section(Time* time, bool isTick = false, const char* name = nullptr);
 
 			void Begin();
 			void End();
 
+			//Records a time that was measured some other way, like on the GPU
+			void Add(f64 elapsedTime);
+
 			f64 Avg() const;
 			inline u64 Count() const { return count; }
 
@@ -30,9 +34,11 @@ namespace util {
 			f64 sectionTime = 0.0;
 			bool isTick;
 			Time* time;
+			const char* name;
+			b8 profiled = false;
 
 			friend Time;
-		} frame, tick, update, prepare, render;
+		} frame, tick, update, prepare, render, gpu;
 
 		Time(CurrentTimeFn timeFn);
 
@@ -58,6 +64,13 @@ namespace util {
 		f64 AvgFPS() const;
 		inline f64 AvgTPS() const { return (tps + oldTps) * 0.5; }
 
+		//busy holds the ms each job worker spent running jobs during the frame that just ended
+		void AddWorkerTimes(std::span<const f64> busy);
+
+		//Fraction of the last SECTION_LENGTH frames the worker spent running jobs
+		f64 WorkerUtilization(u32 worker) const;
+		inline u32 NumWorkers() const { return static_cast<u32>(workerTimes.size()); }
+
 	private:
 		CurrentTimeFn timeFn;
 		f64 lastTickError, lastTickTime;
@@ -65,5 +78,15 @@ namespace util {
 		u32 numTicks;
 		u32 numSecondTicks;
 		f64 lastSecond, tps = 0.0, oldTps = 0.0;
+
+		struct WorkerTimes {
+			std::array<f64, SECTION_LENGTH> times{};
+			f64 sum = 0.0;
+		};
+		std::vector<WorkerTimes> workerTimes;
+		std::array<f64, SECTION_LENGTH> workerFrames{};
+		f64 workerFrameSum = 0.0;
+		u64 workerFrameCount = 0;
+		f64 lastWorkerFrame = 0.0;
 	};
 }
\ No newline at end of file
@@ -43,7 +43,8 @@ namespace vk {
 		enum {
 			Graphics = 1 << 0,
 			Present = 1 << 1,
-			Compute = 1 << 2
+			Compute = 1 << 2,
+			Transfer = 1 << 3
 		};
 	};
 
@@ -91,6 +92,36 @@ namespace vk {
 		);
 	}
 
+	//Size of a single texel in bytes, 0 for formats that aren't supported yet
+	inline u32 FormatSize(VkFormat format) {
+		switch (format) {
+		case VK_FORMAT_R8_UNORM:
+		case VK_FORMAT_R8_SRGB:
+		case VK_FORMAT_S8_UINT:
+			return 1;
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R8G8_SRGB:
+		case VK_FORMAT_R16_SFLOAT:
+		case VK_FORMAT_D16_UNORM:
+			return 2;
+		case VK_FORMAT_R8G8B8A8_UNORM:
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_UNORM:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		case VK_FORMAT_R32_SFLOAT:
+		case VK_FORMAT_D32_SFLOAT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+			return 4;
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+		case VK_FORMAT_R32G32_SFLOAT:
+			return 8;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
 	inline VkImageAspectFlags AspectFromFormat(VkFormat format) {
 		VkImageAspectFlags aspect = 0;
 		if (IsDepthFormat(format)) {
@@ -3,14 +3,23 @@
 #include "Util\Configuration.h"
 #include "Util\Log.h"
 #include "Util\Time.h"
+#include "Util\JobSystem.h"
+#include "Util\Profiler.h"
 #include "GFX\Renderer.h"
+#include "GFX\TextureContainer.h"
+#include "GFX\TextureAtlas.h"
+#include "ECS\Scheduler.h"
+#include "ECS\ECSBenchmark.h"
+#include "Physics\PhysicsBenchmark.h"
+#include "Math\MathBenchmark.h"
+#include "Util\ArenaBenchmark.h"
 
 State state;
 State& global = state;
 
 std::function<void(bool)> frameFunction;
 
-int main(UNUSED int argc, UNUSED char* argv[]) {
+int main(int argc, char* argv[]) {
 	util::Logger log{ std::cout, std::cerr };
 	state.log = &log;
 
@@ -30,6 +39,29 @@ int main(UNUSED int argc, UNUSED char* argv[]) {
 
 	state.time = &time;
 
+	util::Profiler profiler{};
+	state.profiler = &profiler;
+
+	util::JobSystem jobs{};
+	state.jobs = &jobs;
+
+	util::ThreadAllocators threadAllocators{ jobs.NumWorkers() };
+	state.threadAllocators = &threadAllocators;
+
+	//Offline steps: bake the source images into .ptex containers or pack the sprite atlas, then exit
+	if (argc > 1 && std::string_view(argv[1]) == "--bake") {
+		gfx::TextureContainer::BakeDirectory(argc > 2 ? argv[2] : "Resources");
+		return 0;
+	}
+
+	if (argc > 1 && std::string_view(argv[1]) == "--atlas") {
+		if (auto error = gfx::TextureAtlas::Build(
+			argc > 2 ? argv[2] : gfx::Renderer::SPRITE_DIRECTORY, gfx::TextureAtlas::LayoutPath())) {
+			ERROR(-1, util::Logger::GFX, "$", *error);
+		}
+		return 0;
+	}
+
 	platform::Platform platform{};
 	state.platform = &platform;
 	platform.Init(config);
@@ -40,6 +72,29 @@ int main(UNUSED int argc, UNUSED char* argv[]) {
 
 	LOG("Hello, World!");
 
+	if (config.mathBenchmark > 0) {
+		math::RunMathBenchmark(config.mathBenchmark);
+	}
+
+	if (config.arenaBenchmark > 0) {
+		util::RunArenaBenchmark(config.arenaBenchmark);
+	}
+
+	ecs::World world{};
+	ecs::Scheduler scheduler{ world };
+
+	std::unique_ptr<ecs::ECSBenchmark> ecsBenchmark;
+	if (config.ecsBenchmark > 0) {
+		ecsBenchmark = std::make_unique<ecs::ECSBenchmark>(config.ecsBenchmark);
+	}
+
+	std::unique_ptr<physics::PhysicsBenchmark> physicsBenchmark;
+	if (config.physicsBenchmark > 0) {
+		physicsBenchmark = std::make_unique<physics::PhysicsBenchmark>(config.physicsBenchmark);
+	}
+
+	std::vector<f64> workerTimes;
+
 	frameFunction = [&](bool poll) {
 		time.frame.Begin();
 
@@ -50,8 +105,18 @@ int main(UNUSED int argc, UNUSED char* argv[]) {
 			platform.mouse.PrepareTick();
 
 			//TODO: tick
+			scheduler.Run();
+
+			if (ecsBenchmark) {
+				ecsBenchmark->Tick();
+			}
+
+			if (physicsBenchmark) {
+				physicsBenchmark->Tick();
+			}
 
 			state.tickAllocator.Clear();
+			threadAllocators.ClearTick();
 			time.tick.End();
 		}
 
@@ -69,6 +134,14 @@ int main(UNUSED int argc, UNUSED char* argv[]) {
 			platform.window->ToggleFullscreen();
 		}
 
+		if (platform.keyboard[config.profilerCapture].Pressed()) {
+			const std::string file = "trace" + std::to_string(time.FrameCount()) + ".json";
+			if (auto result = profiler.Export(file); result.IsErr()) {
+				WARNNG(util::Logger::General, "$", result.UnwrapErr());
+			}
+			renderer.Gpu().LogStats();
+		}
+
 		time.update.End();
 
 		VkCommandBuffer commandBuffer = renderer.Begin();
@@ -89,7 +162,11 @@ int main(UNUSED int argc, UNUSED char* argv[]) {
 
 		state.allocator.Clear();
 		state.longAllocator.Clear();
+		threadAllocators.ClearFrame();
 		time.frame.End();
+
+		jobs.TakeBusyTimes(workerTimes);
+		time.AddWorkerTimes(workerTimes);
 	};
 
 	startTime = std::chrono::high_resolution_clock::now();
@@ -97,6 +174,14 @@ int main(UNUSED int argc, UNUSED char* argv[]) {
 		frameFunction(true);
 	}
 
+#ifdef GAME_IS_DEBUG
+	state.allocator.LogStats("allocator");
+	state.tickAllocator.LogStats("tickAllocator");
+	state.longAllocator.LogStats("longAllocator");
+	threadAllocators.LogStats();
+	renderer.Gpu().LogStats();
+#endif
+
 	renderer.Destroy();
 	platform.Shutdown();
 